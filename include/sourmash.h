@@ -16,6 +16,12 @@ enum HashFunctions {
 };
 typedef uint32_t HashFunctions;
 
+enum PickStyle {
+  PICK_STYLE_INCLUDE = 1,
+  PICK_STYLE_EXCLUDE = 2,
+};
+typedef uint32_t PickStyle;
+
 enum SourmashErrorCode {
   SOURMASH_ERROR_CODE_NO_ERROR = 0,
   SOURMASH_ERROR_CODE_PANIC = 1,
@@ -50,20 +56,91 @@ typedef uint32_t SourmashErrorCode;
 
 typedef struct SourmashComputeParameters SourmashComputeParameters;
 
+typedef struct SourmashCountgraph SourmashCountgraph;
+
 typedef struct SourmashHyperLogLog SourmashHyperLogLog;
 
 typedef struct SourmashKmerMinHash SourmashKmerMinHash;
 
+typedef struct SourmashManifest SourmashManifest;
+
 typedef struct SourmashNodegraph SourmashNodegraph;
 
+typedef struct SourmashPicklistMatcher SourmashPicklistMatcher;
+
 typedef struct SourmashRevIndex SourmashRevIndex;
 
 typedef struct SourmashSearchResult SourmashSearchResult;
 
+typedef struct SourmashSigBatch SourmashSigBatch;
+
+typedef struct SourmashSigIter SourmashSigIter;
+
 typedef struct SourmashSignature SourmashSignature;
 
 typedef struct SourmashZipStorage SourmashZipStorage;
 
+/**
+ * Statistics comparing two sketches, all gathered in one merge pass by
+ * `MinHashView::comparison_stats`.
+ *
+ * Abundances are counted as 1 for sketches without abundance tracking.
+ */
+typedef struct {
+  /**
+   * k-mer size of the compared sketches.
+   */
+  uint32_t ksize;
+  /**
+   * scaled of the compared sketches (0 for num sketches).
+   */
+  uint64_t scaled;
+  /**
+   * Number of hashes in self.
+   */
+  uint64_t self_size;
+  /**
+   * Number of hashes in other.
+   */
+  uint64_t other_size;
+  /**
+   * Number of hashes present in both sketches.
+   */
+  uint64_t common;
+  /**
+   * Number of hashes present in either sketch.
+   */
+  uint64_t union_size;
+  /**
+   * Sum of all abundances in self.
+   */
+  uint64_t self_total_abund;
+  /**
+   * Sum of all abundances in other.
+   */
+  uint64_t other_total_abund;
+  /**
+   * Sum of the abundances in self of the common hashes.
+   */
+  uint64_t self_common_abund;
+  /**
+   * Sum of the abundances in other of the common hashes.
+   */
+  uint64_t other_common_abund;
+  /**
+   * Mean abundance in self of the common hashes.
+   */
+  double mean_abund;
+  /**
+   * Median abundance in self of the common hashes.
+   */
+  double median_abund;
+  /**
+   * Standard deviation of the abundances in self of the common hashes.
+   */
+  double std_abund;
+} ComparisonStats;
+
 /**
  * Represents a string.
  */
@@ -88,6 +165,8 @@ bool computeparams_dna(const SourmashComputeParameters *ptr);
 
 void computeparams_free(SourmashComputeParameters *ptr);
 
+bool computeparams_hll(const SourmashComputeParameters *ptr);
+
 bool computeparams_hp(const SourmashComputeParameters *ptr);
 
 const uint32_t *computeparams_ksizes(const SourmashComputeParameters *ptr, uintptr_t *size);
@@ -108,6 +187,8 @@ void computeparams_set_dayhoff(SourmashComputeParameters *ptr, bool v);
 
 void computeparams_set_dna(SourmashComputeParameters *ptr, bool v);
 
+void computeparams_set_hll(SourmashComputeParameters *ptr, bool v);
+
 void computeparams_set_hp(SourmashComputeParameters *ptr, bool v);
 
 void computeparams_set_ksizes(SourmashComputeParameters *ptr,
@@ -126,10 +207,63 @@ void computeparams_set_track_abundance(SourmashComputeParameters *ptr, bool v);
 
 bool computeparams_track_abundance(const SourmashComputeParameters *ptr);
 
+bool countgraph_count(SourmashCountgraph *ptr, uint64_t h);
+
+bool countgraph_count_kmer(SourmashCountgraph *ptr, const char *kmer);
+
+bool countgraph_count_with_abundance(SourmashCountgraph *ptr, uint64_t h, uint64_t abundance);
+
+double countgraph_expected_collisions(const SourmashCountgraph *ptr);
+
+void countgraph_free(SourmashCountgraph *ptr);
+
+SourmashCountgraph *countgraph_from_buffer(const char *ptr, uintptr_t insize);
+
+SourmashCountgraph *countgraph_from_path(const char *filename);
+
+uintptr_t countgraph_get(const SourmashCountgraph *ptr, uint64_t h);
+
+uintptr_t countgraph_get_kmer(const SourmashCountgraph *ptr, const char *kmer);
+
+const uint64_t *countgraph_hashsizes(const SourmashCountgraph *ptr, uintptr_t *size);
+
+uintptr_t countgraph_ksize(const SourmashCountgraph *ptr);
+
+uintptr_t countgraph_matches(const SourmashCountgraph *ptr, const SourmashKmerMinHash *mh_ptr);
+
+uint64_t countgraph_matches_weighted(const SourmashCountgraph *ptr,
+                                     const SourmashKmerMinHash *mh_ptr);
+
+SourmashCountgraph *countgraph_new(void);
+
+uintptr_t countgraph_noccupied(const SourmashCountgraph *ptr);
+
+uintptr_t countgraph_ntables(const SourmashCountgraph *ptr);
+
+void countgraph_save(const SourmashCountgraph *ptr, const char *filename);
+
+/**
+ * Save to a (gzip-compressed, if `compression > 0`) buffer.
+ * Free it with `nodegraph_buffer_free`.
+ */
+const uint8_t *countgraph_to_buffer(const SourmashCountgraph *ptr,
+                                    uint8_t compression,
+                                    uintptr_t *size);
+
+void countgraph_update(SourmashCountgraph *ptr, const SourmashCountgraph *optr);
+
+void countgraph_update_mh(SourmashCountgraph *ptr, const SourmashKmerMinHash *optr);
+
+SourmashCountgraph *countgraph_with_tables(uintptr_t ksize,
+                                           uintptr_t starting_size,
+                                           uintptr_t n_tables);
+
 uint64_t hash_murmur(const char *kmer, uint64_t seed);
 
 void hll_add_hash(SourmashHyperLogLog *ptr, uint64_t hash);
 
+void hll_add_protein(SourmashHyperLogLog *ptr, const char *sequence, uintptr_t insize);
+
 void hll_add_sequence(SourmashHyperLogLog *ptr, const char *sequence, uintptr_t insize, bool force);
 
 uintptr_t hll_cardinality(const SourmashHyperLogLog *ptr);
@@ -142,6 +276,8 @@ SourmashHyperLogLog *hll_from_buffer(const char *ptr, uintptr_t insize);
 
 SourmashHyperLogLog *hll_from_path(const char *filename);
 
+HashFunctions hll_hash_function(const SourmashHyperLogLog *ptr);
+
 uintptr_t hll_intersection_size(const SourmashHyperLogLog *ptr, const SourmashHyperLogLog *optr);
 
 uintptr_t hll_ksize(const SourmashHyperLogLog *ptr);
@@ -152,8 +288,12 @@ void hll_merge(SourmashHyperLogLog *ptr, const SourmashHyperLogLog *optr);
 
 SourmashHyperLogLog *hll_new(void);
 
+double hll_relative_error(const SourmashHyperLogLog *ptr);
+
 void hll_save(const SourmashHyperLogLog *ptr, const char *filename);
 
+uint64_t hll_seed(const SourmashHyperLogLog *ptr);
+
 double hll_similarity(const SourmashHyperLogLog *ptr, const SourmashHyperLogLog *optr);
 
 const uint8_t *hll_to_buffer(const SourmashHyperLogLog *ptr, uintptr_t *size);
@@ -162,6 +302,18 @@ void hll_update_mh(SourmashHyperLogLog *ptr, const SourmashKmerMinHash *optr);
 
 SourmashHyperLogLog *hll_with_error_rate(double error_rate, uintptr_t ksize);
 
+SourmashHyperLogLog *hll_with_hash_function(double error_rate,
+                                            uintptr_t ksize,
+                                            HashFunctions hash_function,
+                                            uint64_t seed);
+
+/**
+ * Borrow the abundances, like `kmerminhash_mins_view`.
+ *
+ * Returns NULL if abundances are not tracked.
+ */
+const uint64_t *kmerminhash_abunds_view(const SourmashKmerMinHash *ptr, uintptr_t *size);
+
 void kmerminhash_add_from(SourmashKmerMinHash *ptr, const SourmashKmerMinHash *other);
 
 void kmerminhash_add_hash(SourmashKmerMinHash *ptr, uint64_t h);
@@ -181,16 +333,40 @@ double kmerminhash_angular_similarity(const SourmashKmerMinHash *ptr,
 
 void kmerminhash_clear(SourmashKmerMinHash *ptr);
 
+/**
+ * Intersection, union and abundance statistics between `ptr` and `other`,
+ * computed in a single pass. Abundance statistics are taken from `ptr`.
+ */
+ComparisonStats kmerminhash_comparison_stats(const SourmashKmerMinHash *ptr,
+                                             const SourmashKmerMinHash *other,
+                                             bool downsample);
+
 uint64_t kmerminhash_count_common(const SourmashKmerMinHash *ptr,
                                   const SourmashKmerMinHash *other,
                                   bool downsample);
 
+/**
+ * Count hashes in common between `ptr` and each of the `insize` sketches
+ * in `others`, writing the counts into the caller-owned array `out`.
+ */
+void kmerminhash_count_common_many(const SourmashKmerMinHash *ptr,
+                                   const SourmashKmerMinHash *const *others,
+                                   uintptr_t insize,
+                                   bool downsample,
+                                   uint64_t *out);
+
 bool kmerminhash_dayhoff(const SourmashKmerMinHash *ptr);
 
 void kmerminhash_disable_abundance(SourmashKmerMinHash *ptr);
 
+void kmerminhash_disable_hll(SourmashKmerMinHash *ptr);
+
+SourmashKmerMinHash *kmerminhash_downsample_scaled(const SourmashKmerMinHash *ptr, uint64_t scaled);
+
 void kmerminhash_enable_abundance(SourmashKmerMinHash *ptr);
 
+void kmerminhash_enable_hll(SourmashKmerMinHash *ptr);
+
 void kmerminhash_free(SourmashKmerMinHash *ptr);
 
 const uint64_t *kmerminhash_get_abunds(SourmashKmerMinHash *ptr, uintptr_t *size);
@@ -203,8 +379,21 @@ HashFunctions kmerminhash_hash_function(const SourmashKmerMinHash *ptr);
 
 void kmerminhash_hash_function_set(SourmashKmerMinHash *ptr, HashFunctions hash_function);
 
+/**
+ * A copy of the companion HLL, or NULL if the sketch doesn't collect one.
+ */
+SourmashHyperLogLog *kmerminhash_hll(const SourmashKmerMinHash *ptr);
+
+/**
+ * Relative standard error of the companion HLL, or 0 if there is none.
+ */
+double kmerminhash_hll_relative_error(const SourmashKmerMinHash *ptr);
+
 bool kmerminhash_hp(const SourmashKmerMinHash *ptr);
 
+uint64_t kmerminhash_inflated_sum_abundances(const SourmashKmerMinHash *ptr,
+                                             const SourmashKmerMinHash *abunds_from);
+
 SourmashKmerMinHash *kmerminhash_intersection(const SourmashKmerMinHash *ptr,
                                               const SourmashKmerMinHash *other);
 
@@ -226,6 +415,17 @@ SourmashStr kmerminhash_md5sum(const SourmashKmerMinHash *ptr);
 
 void kmerminhash_merge(SourmashKmerMinHash *ptr, const SourmashKmerMinHash *other);
 
+/**
+ * Borrow the hashes; valid until the MinHash is modified or freed.
+ */
+const uint64_t *kmerminhash_mins_view(const SourmashKmerMinHash *ptr, uintptr_t *size);
+
+/**
+ * Approximate number of distinct k-mers in the data; the companion HLL
+ * estimate if there is one, otherwise size * scaled.
+ */
+uint64_t kmerminhash_n_unique_kmers(const SourmashKmerMinHash *ptr);
+
 SourmashKmerMinHash *kmerminhash_new(uint64_t scaled,
                                      uint32_t k,
                                      HashFunctions hash_function,
@@ -259,15 +459,114 @@ void kmerminhash_set_abundances(SourmashKmerMinHash *ptr,
                                 uintptr_t insize,
                                 bool clear);
 
+/**
+ * Use a copy of `hll_ptr` as the companion HLL.
+ */
+void kmerminhash_set_hll(SourmashKmerMinHash *ptr, const SourmashHyperLogLog *hll_ptr);
+
 double kmerminhash_similarity(const SourmashKmerMinHash *ptr,
                               const SourmashKmerMinHash *other,
                               bool ignore_abundance,
                               bool downsample);
 
+/**
+ * Similarity between `ptr` and each of the `insize` sketches in `others`,
+ * written into the caller-owned array `out`.
+ */
+void kmerminhash_similarity_many(const SourmashKmerMinHash *ptr,
+                                 const SourmashKmerMinHash *const *others,
+                                 uintptr_t insize,
+                                 bool ignore_abundance,
+                                 bool downsample,
+                                 double *out);
+
+/**
+ * Similarity between each of the `nrows` sketches in `rows` and each of the
+ * `ncols` sketches in `cols`, written row-major into the caller-owned
+ * `nrows * ncols` array `out`.
+ */
+void kmerminhash_similarity_tile(const SourmashKmerMinHash *const *rows,
+                                 uintptr_t nrows,
+                                 const SourmashKmerMinHash *const *cols,
+                                 uintptr_t ncols,
+                                 bool ignore_abundance,
+                                 bool downsample,
+                                 double *out);
+
 void kmerminhash_slice_free(uint64_t *ptr, uintptr_t insize);
 
 bool kmerminhash_track_abundance(const SourmashKmerMinHash *ptr);
 
+bool kmerminhash_track_hll(const SourmashKmerMinHash *ptr);
+
+void manifest_free(SourmashManifest *ptr);
+
+SourmashManifest *manifest_from_buffer(const char *ptr, uintptr_t insize);
+
+void manifest_indices_free(uint64_t *ptr, uintptr_t insize);
+
+uintptr_t manifest_len(const SourmashManifest *ptr);
+
+/**
+ * Fill the numeric columns of the given rows; each output array holds
+ * `insize` values.
+ */
+void manifest_numeric_columns(const SourmashManifest *ptr,
+                              const uint64_t *indices_ptr,
+                              uintptr_t insize,
+                              uint32_t *ksize,
+                              uint32_t *num,
+                              uint64_t *scaled,
+                              uint64_t *n_hashes,
+                              bool *with_abundance);
+
+/**
+ * Write the given rows as manifest CSV; all rows if `indices_ptr` is null.
+ */
+SourmashStr manifest_rows_to_csv(const SourmashManifest *ptr,
+                                 const uint64_t *indices_ptr,
+                                 uintptr_t insize);
+
+/**
+ * Select rows, returning their indices; 0/null/false arguments are ignored.
+ *
+ * If `indices_ptr` is not null, only those rows are considered.
+ */
+const uint64_t *manifest_select(const SourmashManifest *ptr,
+                                const uint64_t *indices_ptr,
+                                uintptr_t insize,
+                                uint32_t ksize,
+                                const char *moltype,
+                                bool scaled,
+                                bool abund,
+                                uintptr_t *size);
+
+/**
+ * Select rows passing a picklist, returning their indices.
+ *
+ * If `indices_ptr` is not null, only those rows are considered.
+ */
+const uint64_t *manifest_select_picklist(const SourmashManifest *ptr,
+                                         const uint64_t *indices_ptr,
+                                         uintptr_t insize,
+                                         SourmashPicklistMatcher *picklist_ptr,
+                                         uintptr_t *size);
+
+/**
+ * Values of a string column for the given rows.
+ *
+ * Returns the distinct values concatenated; `offsets` gets `size + 1`
+ * character offsets into it (free with `manifest_indices_free`), and `ids`
+ * the position of each row's value.
+ */
+SourmashStr manifest_str_column(const SourmashManifest *ptr,
+                                const char *column,
+                                const uint64_t *indices_ptr,
+                                uintptr_t insize,
+                                uint32_t *ids,
+                                const uint64_t **offsets,
+                                uintptr_t *size);
+
 void nodegraph_buffer_free(uint8_t *ptr, uintptr_t insize);
 
 bool nodegraph_count(SourmashNodegraph *ptr, uint64_t h);
@@ -312,6 +611,27 @@ SourmashNodegraph *nodegraph_with_tables(uintptr_t ksize,
                                          uintptr_t starting_size,
                                          uintptr_t n_tables);
 
+/**
+ * Add values from a buffer of NUL-terminated strings.
+ *
+ * For the manifest/gather/prefetch/search coltypes, values alternate
+ * between ident and md5short.
+ */
+void picklist_matcher_add_many(SourmashPicklistMatcher *ptr,
+                               const char *values_ptr,
+                               uintptr_t insize);
+
+/**
+ * ids (in insertion order) of the values matched so far.
+ */
+const uint64_t *picklist_matcher_found(const SourmashPicklistMatcher *ptr, uintptr_t *size);
+
+void picklist_matcher_free(SourmashPicklistMatcher *ptr);
+
+uintptr_t picklist_matcher_len(const SourmashPicklistMatcher *ptr);
+
+SourmashPicklistMatcher *picklist_matcher_new(const char *coltype, PickStyle pickstyle);
+
 void revindex_free(SourmashRevIndex *ptr);
 
 const SourmashSearchResult *const *revindex_gather(const SourmashRevIndex *ptr,
@@ -357,6 +677,27 @@ double searchresult_score(const SourmashSearchResult *ptr);
 
 SourmashSignature *searchresult_signature(const SourmashSearchResult *ptr);
 
+/**
+ * The serialized signature at position `i`; owned by the batch.
+ */
+const uint8_t *sigbatch_data(const SourmashSigBatch *ptr, uintptr_t i, uintptr_t *size);
+
+void sigbatch_free(SourmashSigBatch *ptr);
+
+uintptr_t sigbatch_len(const SourmashSigBatch *ptr);
+
+/**
+ * Manifest CSV for the signatures in the batch, in order.
+ */
+SourmashStr sigbatch_manifest_csv(const SourmashSigBatch *ptr);
+
+void sigiter_free(SourmashSigIter *ptr);
+
+/**
+ * The next signature, or NULL when the iterator is exhausted.
+ */
+SourmashSignature *sigiter_next(SourmashSigIter *ptr);
+
 void signature_add_protein(SourmashSignature *ptr, const char *sequence);
 
 void signature_add_sequence(SourmashSignature *ptr, const char *sequence, bool force);
@@ -413,6 +754,23 @@ char sourmash_aa_to_dayhoff(char aa);
 
 char sourmash_aa_to_hp(char aa);
 
+/**
+ * Containment ANI confidence intervals for `insize` comparisons.
+ *
+ * Entry `i` of `containments`, `ksizes`, `scaled` and `n_unique_kmers`
+ * describes one comparison. Its interval goes into entry `i` of the
+ * caller-owned arrays `ani_low` and `ani_high`. Intervals that can't be
+ * estimated are set to NaN.
+ */
+void sourmash_ani_ci_from_containment_many(const double *containments,
+                                           const uint32_t *ksizes,
+                                           const uint64_t *scaled,
+                                           const uint64_t *n_unique_kmers,
+                                           uintptr_t insize,
+                                           double confidence,
+                                           double *ani_low,
+                                           double *ani_high);
+
 /**
  * Clears the last error.
  */
@@ -462,10 +820,34 @@ SourmashStr sourmash_str_from_cstr(const char *s);
 
 char sourmash_translate_codon(const char *codon);
 
+/**
+ * Copy the signatures for the given manifest rows, decoding only if needed.
+ *
+ * Gzipped members holding a single sketch are copied verbatim; see
+ * `copy_records`. The batch keeps signatures in row order.
+ */
+SourmashSigBatch *zipstorage_copy_sigs(const SourmashZipStorage *ptr,
+                                       const SourmashManifest *manifest_ptr,
+                                       const uint64_t *indices_ptr,
+                                       uintptr_t insize,
+                                       uint8_t compression);
+
 SourmashStr **zipstorage_filenames(const SourmashZipStorage *ptr, uintptr_t *size);
 
 void zipstorage_free(SourmashZipStorage *ptr);
 
+/**
+ * Iterate over the signatures for the given manifest rows, in row order.
+ *
+ * Signatures are decompressed and parsed ahead of the caller on a
+ * background thread, up to `read_ahead` at a time.
+ */
+SourmashSigIter *zipstorage_iter_sigs(const SourmashZipStorage *ptr,
+                                      const SourmashManifest *manifest_ptr,
+                                      const uint64_t *indices_ptr,
+                                      uintptr_t insize,
+                                      uintptr_t read_ahead);
+
 SourmashStr **zipstorage_list_sbts(const SourmashZipStorage *ptr, uintptr_t *size);
 
 const uint8_t *zipstorage_load(const SourmashZipStorage *ptr,
@@ -481,4 +863,19 @@ void zipstorage_set_subdir(SourmashZipStorage *ptr, const char *path_ptr, uintpt
 
 SourmashStr zipstorage_subdir(const SourmashZipStorage *ptr);
 
+/**
+ * Load, transform and serialize the signatures for the given manifest rows.
+ *
+ * Signatures are processed in parallel; the batch keeps them in row order.
+ * `scaled` and `num` of 0 mean no downsampling.
+ */
+SourmashSigBatch *zipstorage_transform_sigs(const SourmashZipStorage *ptr,
+                                            const SourmashManifest *manifest_ptr,
+                                            const uint64_t *indices_ptr,
+                                            uintptr_t insize,
+                                            bool flatten,
+                                            uint32_t scaled,
+                                            uint32_t num,
+                                            uint8_t compression);
+
 #endif /* SOURMASH_H_INCLUDED */
@@ -1,6 +1,8 @@
+use std::alloc::{GlobalAlloc, Layout, System};
 use std::fs::File;
 use std::io::BufReader;
 use std::path::PathBuf;
+use std::sync::atomic::{AtomicUsize, Ordering};
 
 use sourmash::collection::Collection;
 use sourmash::signature::Signature;
@@ -9,6 +11,38 @@ use sourmash::{index::calculate_gather_stats, storage::SigStore};
 
 use criterion::{black_box, criterion_group, criterion_main, Criterion};
 
+/// System allocator that counts allocations, to report allocator churn.
+struct CountingAlloc;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
+
+/// Run `f` once and print how many allocations it made.
+fn report_allocations<F: FnMut()>(name: &str, mut f: F) {
+    let before = ALLOCATIONS.load(Ordering::Relaxed);
+    f();
+    let count = ALLOCATIONS.load(Ordering::Relaxed) - before;
+    eprintln!("{}: {} allocations per iteration", name, count);
+}
+
 fn gather_stats_benchmarks(c: &mut Criterion) {
     let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
     filename.push("../../tests/test-data/track_abund/47.fa.sig");
@@ -35,25 +69,44 @@ fn gather_stats_benchmarks(c: &mut Criterion) {
             "abund{}_ani_ci{}",
             calc_abund_stats as u8, calc_ani_ci as u8
         );
-        group.bench_function(&test_name, |b| {
-            b.iter(|| {
-                calculate_gather_stats(
-                    black_box(&orig_query),
-                    black_box(query.clone()),
-                    black_box(match_sig.clone()),
-                    black_box(42), // Example match_size
-                    black_box(1),  // Example gather_result_rank
-                    black_box(200),
-                    black_box(total_weighted_hashes.try_into().unwrap()),
-                    black_box(calc_abund_stats),
-                    black_box(calc_ani_ci),
-                    black_box(None), // don't set custom confidence intervals
-                )
-                .expect("error calculating gather stats");
-            });
-        });
+        let mut gather_stats = || {
+            calculate_gather_stats(
+                black_box(&orig_query),
+                black_box(&query),
+                black_box(match_sig.clone()),
+                black_box(42), // Example match_size
+                black_box(1),  // Example gather_result_rank
+                black_box(200),
+                black_box(total_weighted_hashes.try_into().unwrap()),
+                black_box(calc_abund_stats),
+                black_box(calc_ani_ci),
+                black_box(None), // don't set custom confidence intervals
+            )
+            .expect("error calculating gather stats");
+        };
+        report_allocations(&test_name, &mut gather_stats);
+        group.bench_function(&test_name, |b| b.iter(&mut gather_stats));
     }
     group.finish();
+
+    // downsampling the query, as done in every gather round
+    let scaled = orig_query.scaled() * 2;
+    let mut group = c.benchmark_group("gather_downsample");
+
+    let mut downsample = || {
+        black_box(orig_query.downsample_scaled(scaled).unwrap());
+    };
+    report_allocations("downsample_scaled", &mut downsample);
+    group.bench_function("downsample_scaled", |b| b.iter(&mut downsample));
+
+    let mut target = orig_query.clone();
+    let mut downsample_into = || {
+        orig_query.downsample_scaled_into(scaled, black_box(&mut target));
+    };
+    report_allocations("downsample_scaled_into", &mut downsample_into);
+    group.bench_function("downsample_scaled_into", |b| b.iter(&mut downsample_into));
+
+    group.finish();
 }
 
 criterion_group!(gather, gather_stats_benchmarks);
@@ -0,0 +1,53 @@
+#[macro_use]
+extern crate criterion;
+
+use rand::{Rng, SeedableRng};
+
+use sourmash::signature::SigsTrait;
+use sourmash::sketch::hyperloglog::HyperLogLog;
+
+use criterion::{BatchSize, Criterion};
+
+fn random_hlls(n: usize, n_hashes: usize) -> Vec<HyperLogLog> {
+    let mut rng = rand::rngs::StdRng::seed_from_u64(42);
+    (0..n)
+        .map(|_| {
+            let mut hll = HyperLogLog::with_error_rate(0.01, 31).unwrap();
+            for _ in 0..n_hashes {
+                hll.add_hash(rng.gen());
+            }
+            hll
+        })
+        .collect()
+}
+
+fn merge_and_estimate(c: &mut Criterion) {
+    let hlls = random_hlls(1000, 50_000);
+
+    let mut group = c.benchmark_group("hll");
+    group.sample_size(10);
+
+    group.bench_function("merge 1000 sketches", |b| {
+        b.iter_batched(
+            || hlls[0].clone(),
+            |mut merged| {
+                for hll in &hlls[1..] {
+                    merged.merge(hll).unwrap();
+                }
+                merged
+            },
+            BatchSize::SmallInput,
+        );
+    });
+
+    group.bench_function("cardinality of 1000 sketches", |b| {
+        b.iter(|| hlls.iter().map(|hll| hll.cardinality()).sum::<usize>());
+    });
+
+    group.bench_function("containment against 1000 sketches", |b| {
+        b.iter(|| hlls.iter().map(|hll| hlls[0].containment(hll)).sum::<f64>());
+    });
+}
+
+criterion_group!(hll, merge_and_estimate);
+criterion_main!(hll);
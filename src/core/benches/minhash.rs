@@ -9,7 +9,7 @@ use sourmash::signature::{Signature, SigsTrait};
 use sourmash::sketch::minhash::{KmerMinHash, KmerMinHashBTree};
 use sourmash::sketch::Sketch;
 
-use criterion::Criterion;
+use criterion::{BatchSize, Criterion};
 
 fn intersection(c: &mut Criterion) {
     let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
@@ -107,5 +107,38 @@ fn intersection(c: &mut Criterion) {
     });
 }
 
-criterion_group!(minhash, intersection);
+fn md5sum(c: &mut Criterion) {
+    let mut mh = KmerMinHash::builder()
+        .num(0)
+        .max_hash(u64::max_value())
+        .ksize(21)
+        .build();
+    for i in 0..1_000_000u64 {
+        mh.add_hash(i.wrapping_mul(0x9E37_79B9_7F4A_7C15));
+    }
+    let first = mh.mins()[0];
+
+    let mut group = c.benchmark_group("minhash");
+    group.sample_size(10);
+
+    group.bench_function("md5sum", |b| {
+        b.iter_batched(
+            || {
+                // invalidate the cached md5sum
+                let mut mh = mh.clone();
+                mh.remove_hash(first);
+                mh.add_hash(first);
+                mh
+            },
+            |mh| mh.md5sum(),
+            BatchSize::LargeInput,
+        );
+    });
+
+    group.bench_function("md5sum cached", |b| {
+        b.iter(|| mh.md5sum());
+    });
+}
+
+criterion_group!(minhash, intersection, md5sum);
 criterion_main!(minhash);
@@ -2,6 +2,11 @@
 // Equations based off of: https://github.com/KoslickiLab/mutation-rate-ci-calculator
 // Reference: https://doi.org/10.1101/2022.01.11.475870
 
+use std::cell::Cell;
+
+use once_cell::sync::OnceCell;
+#[cfg(feature = "parallel")]
+use rayon::prelude::*;
 use roots::{find_root_brent, SimpleConvergency};
 use statrs::distribution::{ContinuousCDF, Normal};
 
@@ -42,6 +47,19 @@ fn probit(p: f64) -> f64 {
     Normal::new(0.0, 1.0).unwrap().inverse_cdf(p)
 }
 
+// Two-sided normal quantile for `confidence`. Nearly every caller uses
+// the default 95% confidence, so that quantile is only computed once.
+fn z_alpha(confidence: f64) -> f64 {
+    static Z_95: OnceCell<f64> = OnceCell::new();
+
+    let z = |confidence: f64| probit(1.0 - (1.0 - confidence) / 2.0);
+    if confidence == 0.95 {
+        *Z_95.get_or_init(|| z(confidence))
+    } else {
+        z(confidence)
+    }
+}
+
 fn r1_to_q(k: f64, r1: f64) -> f64 {
     1.0 - (1.0 - r1).powi(k as i32)
 }
@@ -89,36 +107,36 @@ pub fn ani_from_containment(containment: f64, ksize: f64) -> f64 {
     }
 }
 
-// Calculate containment to ANI with confidence intervals
-pub fn ani_ci_from_containment(
+// Mutation distances at the two ends of the confidence interval for
+// `containment`, or `None` where the root can't be bracketed. The flag is
+// set if the variance estimate failed (and was taken as 0) on the way.
+fn ci_distances(
     containment: f64,
     ksize: f64,
     scaled: u64,
     n_unique_kmers: u64,
-    confidence: Option<f64>,
-) -> Result<(f64, f64), Error> {
-    if containment == 0.0 {
-        return Ok((0.0, 0.0));
-    } else if containment == 1.0 {
-        return Ok((1.0, 1.0));
-    }
-    let confidence = confidence.unwrap_or(0.95);
-
+    z_alpha: f64,
+) -> (Option<f64>, Option<f64>, bool) {
     // conversions needed throughout
     let scaled_f64 = scaled as f64;
     let f_scaled = 1.0 / scaled_f64;
     let n_unique_kmers = n_unique_kmers as f64;
-    let alpha = 1.0 - confidence;
+    let var_failed = Cell::new(false);
+    let or_zero = |value: Result<f64, Error>| {
+        value.unwrap_or_else(|_| {
+            var_failed.set(true);
+            0.0
+        })
+    };
 
-    let z_alpha = probit(1.0 - alpha / 2.0);
     let bias_factor = 1.0 - (1.0 - f_scaled).powi(n_unique_kmers as i32);
     let term_1 = (1.0 - f_scaled) / (f_scaled * (n_unique_kmers).powi(3) * bias_factor.powi(2));
     let term_2 = |pest: f64| {
         n_unique_kmers * exp_n_mutated(n_unique_kmers, ksize, pest)
-            - exp_n_mutated_squared(n_unique_kmers, ksize, pest).unwrap_or(0.0)
+            - or_zero(exp_n_mutated_squared(n_unique_kmers, ksize, pest))
     };
     let term_3 = |pest: f64| {
-        var_n_mutated(n_unique_kmers, ksize, pest, None).unwrap_or(0.0) / (n_unique_kmers).powi(2)
+        or_zero(var_n_mutated(n_unique_kmers, ksize, pest, None)) / (n_unique_kmers).powi(2)
     };
 
     let var_direct = |pest: f64| term_1 * term_2(pest) + term_3(pest);
@@ -135,12 +153,91 @@ pub fn ani_ci_from_containment(
         max_iter: 1000,
     };
 
-    let dist_sol1 =
-        find_root_brent(0.0000001, 0.9999999, &f1, &mut convergency).unwrap_or_default();
-    let dist_sol2 =
-        find_root_brent(0.0000001, 0.9999999, &f2, &mut convergency).unwrap_or_default();
+    let dist_sol1 = find_root_brent(0.0000001, 0.9999999, &f1, &mut convergency).ok();
+    let dist_sol2 = find_root_brent(0.0000001, 0.9999999, &f2, &mut convergency).ok();
+
+    (dist_sol1, dist_sol2, var_failed.get())
+}
+
+// Calculate containment to ANI with confidence intervals
+pub fn ani_ci_from_containment(
+    containment: f64,
+    ksize: f64,
+    scaled: u64,
+    n_unique_kmers: u64,
+    confidence: Option<f64>,
+) -> Result<(f64, f64), Error> {
+    if containment == 0.0 {
+        return Ok((0.0, 0.0));
+    } else if containment == 1.0 {
+        return Ok((1.0, 1.0));
+    }
+    let z_alpha = z_alpha(confidence.unwrap_or(0.95));
+
+    let (dist_sol1, dist_sol2, _) =
+        ci_distances(containment, ksize, scaled, n_unique_kmers, z_alpha);
+
+    Ok((
+        1.0 - dist_sol1.unwrap_or_default(),
+        1.0 - dist_sol2.unwrap_or_default(),
+    ))
+}
+
+/// Containment ANI confidence intervals for many comparisons at once.
+/// Entry `i` of the input slices describes one comparison, and its
+/// interval is written to entry `i` of `ani_low` and `ani_high`.
+///
+/// Unlike `ani_ci_from_containment`, an interval that can't be estimated
+/// (no root found, or a negative variance) is reported as NaN.
+#[allow(clippy::too_many_arguments)]
+pub fn ani_ci_from_containment_many(
+    containments: &[f64],
+    ksizes: &[u32],
+    scaled: &[u64],
+    n_unique_kmers: &[u64],
+    confidence: f64,
+    ani_low: &mut [f64],
+    ani_high: &mut [f64],
+) -> Result<(), Error> {
+    let n = containments.len();
+    for len in [
+        ksizes.len(),
+        scaled.len(),
+        n_unique_kmers.len(),
+        ani_low.len(),
+        ani_high.len(),
+    ] {
+        if len != n {
+            return Err(Error::Internal {
+                message: format!("input has {} entries, expected {}", len, n),
+            });
+        }
+    }
+    let z_alpha = z_alpha(confidence);
+
+    let estimate = |i: usize, (low, high): (&mut f64, &mut f64)| {
+        let containment = containments[i];
+        let ksize = ksizes[i] as f64;
+
+        (*low, *high) = if containment == 0.0 || containment == 1.0 {
+            (containment, containment)
+        } else {
+            match ci_distances(containment, ksize, scaled[i], n_unique_kmers[i], z_alpha) {
+                (Some(dist_sol1), Some(dist_sol2), false) => (1.0 - dist_sol1, 1.0 - dist_sol2),
+                _ => (f64::NAN, f64::NAN),
+            }
+        };
+    };
+
+    #[cfg(feature = "parallel")]
+    let iter = ani_low.par_iter_mut().zip(ani_high.par_iter_mut());
+
+    #[cfg(not(feature = "parallel"))]
+    let iter = ani_low.iter_mut().zip(ani_high.iter_mut());
 
-    Ok((1.0 - dist_sol1, 1.0 - dist_sol2))
+    iter.enumerate().for_each(|(i, out)| estimate(i, out));
+
+    Ok(())
 }
 
 #[cfg(test)]
@@ -232,6 +329,52 @@ mod tests {
         assert!((ci_high - 0.9762879360833708) < EPSILON);
     }
 
+    #[test]
+    fn test_containment_to_ani_many() {
+        let containments = [0.0, 1.0, 0.5, 0.1, 0.5];
+        let ksizes = [21, 21, 21, 31, 21];
+        let scaled = [10, 10, 1, 100, 100];
+        let n_unique_kmers = [100, 100, 10000, 10000, 10000];
+
+        let mut ani_low = [0.0; 5];
+        let mut ani_high = [0.0; 5];
+        ani_ci_from_containment_many(
+            &containments,
+            &ksizes,
+            &scaled,
+            &n_unique_kmers,
+            0.95,
+            &mut ani_low,
+            &mut ani_high,
+        )
+        .unwrap();
+
+        for i in 0..containments.len() {
+            let ksize = ksizes[i] as f64;
+            let (ci_low, ci_high) =
+                ani_ci_from_containment(containments[i], ksize, scaled[i], n_unique_kmers[i], None)
+                    .unwrap();
+            assert_eq!(ani_low[i], ci_low);
+            assert_eq!(ani_high[i], ci_high);
+        }
+    }
+
+    #[test]
+    fn test_containment_to_ani_many_mismatched_len() {
+        let mut out_low = [0.0; 2];
+        let mut out_high = [0.0; 2];
+        let res = ani_ci_from_containment_many(
+            &[0.5, 0.5],
+            &[21],
+            &[10, 10],
+            &[100, 100],
+            0.95,
+            &mut out_low,
+            &mut out_high,
+        );
+        assert!(res.is_err());
+    }
+
     #[test]
     fn test_var_n_mutated_zero() {
         let r = 0.0;
@@ -3,7 +3,8 @@ use typed_builder::TypedBuilder;
 
 use crate::encodings::HashFunctions;
 use crate::signature::Signature;
-use crate::sketch::minhash::{max_hash_for_scaled, KmerMinHashBTree};
+use crate::sketch::hyperloglog::HyperLogLog;
+use crate::sketch::minhash::{max_hash_for_scaled, KmerMinHashBTree, HLL_ERROR_RATE};
 use crate::sketch::Sketch;
 
 impl Signature {
@@ -86,6 +87,10 @@ pub struct ComputeParameters {
     #[builder(default = false)]
     track_abundance: bool,
 
+    #[getset(get_copy = "pub", set = "pub")]
+    #[builder(default = false)]
+    hll: bool,
+
     #[getset(get_copy = "pub", set = "pub")]
     #[builder(default = false)]
     randomize: bool,
@@ -113,6 +118,15 @@ pub fn build_template(params: &ComputeParameters) -> Vec<Sketch> {
         .iter()
         .flat_map(|k| {
             let mut ksigs = vec![];
+            let hll = |hash_function: HashFunctions| {
+                if params.hll {
+                    HyperLogLog::with_error_rate(HLL_ERROR_RATE, *k as usize)
+                        .ok()
+                        .map(|hll| hll.with_hash_function(hash_function, params.seed))
+                } else {
+                    None
+                }
+            };
 
             if params.protein {
                 ksigs.push(Sketch::LargeMinHash(
@@ -127,6 +141,7 @@ pub fn build_template(params: &ComputeParameters) -> Vec<Sketch> {
                         } else {
                             None
                         })
+                        .hll(hll(HashFunctions::Murmur64Protein))
                         .build(),
                 ));
             }
@@ -144,6 +159,7 @@ pub fn build_template(params: &ComputeParameters) -> Vec<Sketch> {
                         } else {
                             None
                         })
+                        .hll(hll(HashFunctions::Murmur64Dayhoff))
                         .build(),
                 ));
             }
@@ -161,6 +177,7 @@ pub fn build_template(params: &ComputeParameters) -> Vec<Sketch> {
                         } else {
                             None
                         })
+                        .hll(hll(HashFunctions::Murmur64Hp))
                         .build(),
                 ));
             }
@@ -178,6 +195,7 @@ pub fn build_template(params: &ComputeParameters) -> Vec<Sketch> {
                         } else {
                             None
                         })
+                        .hll(hll(HashFunctions::Murmur64Dna))
                         .build(),
                 ));
             }
@@ -1,4 +1,10 @@
+use std::collections::HashMap;
 use std::ops::{Deref, DerefMut};
+#[cfg(feature = "parallel")]
+use std::sync::mpsc::{sync_channel, Receiver};
+use std::sync::Arc;
+#[cfg(feature = "parallel")]
+use std::thread::{self, JoinHandle};
 
 use camino::Utf8Path as Path;
 use camino::Utf8PathBuf as PathBuf;
@@ -6,7 +12,10 @@ use camino::Utf8PathBuf as PathBuf;
 use crate::encodings::Idx;
 use crate::manifest::{Manifest, Record};
 use crate::prelude::*;
-use crate::storage::{FSStorage, InnerStorage, MemStorage, SigStore, ZipStorage};
+use crate::signature::signatures_to_buffer;
+use crate::sketch::minhash::KmerMinHash;
+use crate::sketch::Sketch;
+use crate::storage::{FSStorage, InnerStorage, MemStorage, SigStore, StorageError, ZipStorage};
 use crate::{Error, Result};
 
 #[cfg(feature = "parallel")]
@@ -187,6 +196,418 @@ impl Collection {
         assert_eq!(sig.signatures.len(), 1);
         Ok(sig)
     }
+
+    /// Transform all signatures, passing them to `sink` in manifest order.
+    ///
+    /// Signatures are loaded, transformed and serialized in parallel batches
+    /// of `batch_size`, so at most one batch of output is held in memory.
+    pub fn transform<F>(
+        &self,
+        transform: &SigTransform,
+        batch_size: usize,
+        mut sink: F,
+    ) -> Result<()>
+    where
+        F: FnMut(Record, Vec<u8>) -> Result<()>,
+    {
+        for batch in self.manifest.chunks(batch_size.max(1)) {
+            for (record, data) in transform_records(&self.storage, batch, transform)? {
+                sink(record, data)?;
+            }
+        }
+        Ok(())
+    }
+}
+
+/// Changes applied to each sketch by `transform_records`.
+#[derive(Debug, Default, Clone)]
+pub struct SigTransform {
+    flatten: bool,
+    scaled: Option<u32>,
+    num: Option<u32>,
+    compression: u8,
+}
+
+impl SigTransform {
+    /// Remove abundances.
+    pub fn set_flatten(&mut self, flatten: bool) {
+        self.flatten = flatten;
+    }
+
+    /// Downsample scaled sketches to `scaled`.
+    pub fn set_scaled(&mut self, scaled: u32) {
+        self.scaled = Some(scaled);
+    }
+
+    /// Downsample num sketches to `num`.
+    pub fn set_num(&mut self, num: u32) {
+        self.num = Some(num);
+    }
+
+    /// gzip level for the serialized output; 0 is uncompressed.
+    pub fn set_compression(&mut self, compression: u8) {
+        self.compression = compression;
+    }
+
+    pub fn apply(&self, mh: &KmerMinHash) -> Result<KmerMinHash> {
+        let mut new_mh = if let Some(scaled) = self.scaled {
+            if mh.num() != 0 {
+                return Err(Error::Internal {
+                    message: "cannot downsample a num MinHash using scaled".into(),
+                });
+            }
+            if mh.scaled() > scaled as u64 {
+                return Err(Error::Internal {
+                    message: format!(
+                        "new scaled {} is lower than current sample scaled {}",
+                        scaled,
+                        mh.scaled()
+                    ),
+                });
+            }
+            if mh.scaled() == scaled as u64 {
+                mh.clone()
+            } else {
+                mh.downsample_scaled(scaled as u64)?
+            }
+        } else if let Some(num) = self.num {
+            if mh.scaled() != 0 {
+                return Err(Error::Internal {
+                    message: "cannot downsample a scaled MinHash using num".into(),
+                });
+            }
+            if mh.num() < num {
+                return Err(Error::Internal {
+                    message: "new sample num is higher than current sample num".into(),
+                });
+            }
+            let mut new_mh = KmerMinHash::new(
+                0,
+                mh.ksize() as u32,
+                mh.hash_function(),
+                mh.seed(),
+                mh.track_abundance(),
+                num,
+            );
+            if mh.track_abundance() {
+                new_mh.add_many_with_abund(&mh.to_vec_abunds())?;
+            } else {
+                new_mh.add_many(&mh.mins())?;
+            }
+            new_mh
+        } else {
+            mh.clone()
+        };
+
+        if self.flatten {
+            new_mh.disable_abundance();
+        }
+        Ok(new_mh)
+    }
+}
+
+/// The signatures stored in one storage member, with their MinHash sketches
+/// indexed by md5sum so any number of records can be served from one parse.
+struct MemberSigs {
+    /// Signatures with their sketches taken out.
+    sigs: Vec<Signature>,
+    /// md5sum -> (index into `sigs`, sketch); the first match wins.
+    sketches: HashMap<String, (usize, Sketch)>,
+}
+
+impl MemberSigs {
+    fn load<S: Storage + ?Sized>(storage: &S, path: &str) -> Result<Self> {
+        let raw = storage.load(path)?;
+        let mut sigs = Signature::from_reader(&raw[..])?;
+
+        let mut sketches = HashMap::new();
+        for (i, sig) in sigs.iter_mut().enumerate() {
+            for sketch in std::mem::take(&mut sig.signatures) {
+                if let Sketch::MinHash(mh) = &sketch {
+                    sketches.entry(mh.md5sum()).or_insert((i, sketch));
+                }
+            }
+        }
+
+        Ok(MemberSigs { sigs, sketches })
+    }
+
+    /// The signature for `record`, or None if no sketch in this member has
+    /// its md5sum.
+    fn find(&self, record: &Record) -> Option<Signature> {
+        let (i, sketch) = self.sketches.get(record.md5())?;
+
+        let mut sig = self.sigs[*i].clone();
+        sig.push(sketch.clone());
+        Some(sig)
+    }
+
+    fn select(&self, record: &Record) -> Result<Signature> {
+        self.find(record)
+            .ok_or_else(|| missing_sketch(record).into())
+    }
+}
+
+fn missing_sketch(record: &Record) -> StorageError {
+    StorageError::PathNotFoundError(format!(
+        "{} (md5 {})",
+        record.internal_location(),
+        record.md5()
+    ))
+}
+
+/// Load the signature for `record`, keeping only the sketch it describes.
+pub fn load_record_sig<S: Storage + ?Sized>(storage: &S, record: &Record) -> Result<Signature> {
+    MemberSigs::load(storage, record.internal_location().as_str())?.select(record)
+}
+
+/// Load the signatures for `records`, in order; see `load_record_sig`.
+///
+/// Records are grouped by internal location, so a storage member holding
+/// several selected sketches is loaded and parsed once. Groups are loaded in
+/// parallel.
+pub fn load_records_sigs<S: Storage + Sync + ?Sized>(
+    storage: &S,
+    records: &[Record],
+) -> Vec<Result<Signature>> {
+    find_records_sigs(storage, records)
+        .into_iter()
+        .zip(records)
+        .map(|(sig, record)| sig?.ok_or_else(|| missing_sketch(record).into()))
+        .collect()
+}
+
+/// Like `load_records_sigs`, but a record whose md5sum is not found in its
+/// storage member gives None instead of an error.
+fn find_records_sigs<S: Storage + Sync + ?Sized>(
+    storage: &S,
+    records: &[Record],
+) -> Vec<Result<Option<Signature>>> {
+    let mut groups: HashMap<&str, Vec<usize>> = HashMap::new();
+    for (i, record) in records.iter().enumerate() {
+        groups
+            .entry(record.internal_location().as_str())
+            .or_default()
+            .push(i);
+    }
+    let groups: Vec<_> = groups.into_iter().collect();
+
+    let load_group =
+        |(path, idxs): &(&str, Vec<usize>)| -> Vec<(usize, Result<Option<Signature>>)> {
+            match MemberSigs::load(storage, path) {
+                Ok(member) => idxs
+                    .iter()
+                    .map(|&i| (i, Ok(member.find(&records[i]))))
+                    .collect(),
+                // report the load error for every record in the group
+                Err(_) => idxs
+                    .iter()
+                    .map(|&i| (i, load_record_sig(storage, &records[i]).map(Some)))
+                    .collect(),
+            }
+        };
+
+    #[cfg(feature = "parallel")]
+    let loaded: Vec<_> = groups.par_iter().flat_map_iter(load_group).collect();
+
+    #[cfg(not(feature = "parallel"))]
+    let loaded: Vec<_> = groups.iter().flat_map(load_group).collect();
+
+    let mut sigs: Vec<Option<Result<Option<Signature>>>> =
+        (0..records.len()).map(|_| None).collect();
+    for (i, sig) in loaded {
+        sigs[i] = Some(sig);
+    }
+    sigs.into_iter()
+        .map(|sig| sig.expect("every record belongs to a group"))
+        .collect()
+}
+
+/// Transform and serialize `sig`, loaded for `record`.
+fn transform_sig(
+    mut sig: Signature,
+    record: &Record,
+    transform: &SigTransform,
+) -> Result<(Record, Vec<u8>)> {
+    // load_record_sig only returns MinHash sketches
+    let mh = transform.apply(sig.minhash().expect("missing MinHash"))?;
+    let record = record.with_minhash(&mh);
+
+    sig.reset_sketches();
+    sig.push(Sketch::MinHash(mh));
+    let data = signatures_to_buffer(&[&sig], transform.compression)?;
+    Ok((record, data))
+}
+
+/// Load, transform and serialize the signatures for `records`, in parallel.
+///
+/// Output is in the same order as `records`: each item is the updated
+/// record and the serialized signature (see `signatures_to_buffer`).
+pub fn transform_records<S: Storage + Sync + ?Sized>(
+    storage: &S,
+    records: &[Record],
+    transform: &SigTransform,
+) -> Result<Vec<(Record, Vec<u8>)>> {
+    let sigs = load_records_sigs(storage, records);
+
+    #[cfg(feature = "parallel")]
+    let iter = records.par_iter().zip(sigs.into_par_iter());
+
+    #[cfg(not(feature = "parallel"))]
+    let iter = records.iter().zip(sigs);
+
+    iter.map(|(record, sig)| transform_sig(sig?, record, transform))
+        .collect()
+}
+
+/// Copy the signatures for `records` into serialized form, in parallel.
+///
+/// Records with `own_location[i]` set are the only sketch in their storage
+/// member, so gzipped members are copied verbatim without decoding. Other
+/// records are loaded and re-serialized with just their own sketch.
+pub fn copy_records<S: Storage + Sync + ?Sized>(
+    storage: &S,
+    records: &[Record],
+    own_location: &[bool],
+    compression: u8,
+) -> Result<Vec<(Record, Vec<u8>)>> {
+    assert_eq!(records.len(), own_location.len());
+
+    let mut transform = SigTransform::default();
+    transform.set_compression(compression);
+
+    let copy_raw = |(record, own): (&Record, &bool)| -> Result<Option<(Record, Vec<u8>)>> {
+        if *own && compression > 0 {
+            let raw = storage.load(record.internal_location().as_str())?;
+            if raw.starts_with(&[0x1f, 0x8b]) {
+                return Ok(Some((record.clone(), raw)));
+            }
+        }
+        Ok(None)
+    };
+
+    #[cfg(feature = "parallel")]
+    let iter = records.par_iter().zip(own_location.par_iter());
+
+    #[cfg(not(feature = "parallel"))]
+    let iter = records.iter().zip(own_location.iter());
+
+    let copied: Vec<_> = iter.map(copy_raw).collect::<Result<_>>()?;
+
+    // everything else goes through transform_records, which parses each
+    // shared member once
+    let rest: Vec<Record> = records
+        .iter()
+        .zip(&copied)
+        .filter(|(_, copy)| copy.is_none())
+        .map(|(record, _)| record.clone())
+        .collect();
+    let mut rest = transform_records(storage, &rest, &transform)?.into_iter();
+
+    Ok(copied
+        .into_iter()
+        .map(|copy| copy.unwrap_or_else(|| rest.next().expect("one transform per record")))
+        .collect())
+}
+
+/// Iterator over the signatures for `records`, in order; see `load_record_sig`.
+///
+/// Records whose md5sum is not found in their storage member are skipped, as
+/// the Python loader did; errors loading a member are still reported.
+///
+/// With the `parallel` feature a background thread loads up to `read_ahead`
+/// signatures at a time in parallel and queues them for the consumer, so a
+/// sequential scan overlaps decompression and parsing with the caller's work.
+pub struct RecordSigIter {
+    #[cfg(feature = "parallel")]
+    rx: Option<Receiver<Result<Signature>>>,
+    #[cfg(feature = "parallel")]
+    worker: Option<JoinHandle<()>>,
+
+    #[cfg(not(feature = "parallel"))]
+    inner: Box<dyn Iterator<Item = Result<Signature>> + Send>,
+}
+
+impl RecordSigIter {
+    pub fn new<S: Storage + Send + Sync + 'static>(
+        storage: Arc<S>,
+        records: Vec<Record>,
+        read_ahead: usize,
+    ) -> Self {
+        let read_ahead = read_ahead.max(1);
+
+        #[cfg(feature = "parallel")]
+        {
+            let (tx, rx) = sync_channel(read_ahead);
+            let worker = thread::spawn(move || {
+                for chunk in records.chunks(read_ahead) {
+                    let sigs = find_records_sigs(storage.as_ref(), chunk);
+                    for sig in sigs.into_iter().filter_map(Result::transpose) {
+                        if tx.send(sig).is_err() {
+                            // consumer is gone
+                            return;
+                        }
+                    }
+                }
+            });
+
+            RecordSigIter {
+                rx: Some(rx),
+                worker: Some(worker),
+            }
+        }
+
+        #[cfg(not(feature = "parallel"))]
+        {
+            let n = records.len();
+            let inner = (0..n).step_by(read_ahead).flat_map(move |start| {
+                let end = (start + read_ahead).min(n);
+                find_records_sigs(storage.as_ref(), &records[start..end])
+                    .into_iter()
+                    .filter_map(Result::transpose)
+            });
+
+            RecordSigIter {
+                inner: Box::new(inner),
+            }
+        }
+    }
+}
+
+impl Iterator for RecordSigIter {
+    type Item = Result<Signature>;
+
+    #[cfg(feature = "parallel")]
+    fn next(&mut self) -> Option<Self::Item> {
+        if let Ok(sig) = self.rx.as_ref()?.recv() {
+            return Some(sig);
+        }
+
+        // the worker hung up: either it is done, or it panicked.
+        self.rx.take();
+        match self.worker.take().map(|worker| worker.join()) {
+            Some(Err(_)) => Some(Err(Error::Internal {
+                message: "signature loading thread panicked".into(),
+            })),
+            _ => None,
+        }
+    }
+
+    #[cfg(not(feature = "parallel"))]
+    fn next(&mut self) -> Option<Self::Item> {
+        self.inner.next()
+    }
+}
+
+#[cfg(feature = "parallel")]
+impl Drop for RecordSigIter {
+    fn drop(&mut self) {
+        // disconnect first, so the worker stops at its next send.
+        self.rx.take();
+        if let Some(worker) = self.worker.take() {
+            let _ = worker.join();
+        }
+    }
 }
 
 impl Select for Collection {
@@ -201,13 +622,18 @@ mod test {
     use camino::Utf8PathBuf as PathBuf;
     use std::fs::File;
     use std::io::BufReader;
+    use std::sync::Arc;
 
-    use super::Collection;
+    use super::{
+        copy_records, load_record_sig, load_records_sigs, Collection, RecordSigIter, SigTransform,
+    };
 
     use crate::encodings::HashFunctions;
-    use crate::prelude::Select;
+    use crate::manifest::Record;
+    use crate::prelude::{Select, Storage};
     use crate::selection::Selection;
     use crate::signature::Signature;
+    use crate::storage::{FSStorage, ZipStorage};
 
     #[test]
     fn sigstore_selection_with_downsample() {
@@ -405,4 +831,130 @@ mod test {
             assert_eq!(this_mh.scaled(), 100);
         }
     }
+
+    #[test]
+    fn collection_transform_zip() {
+        let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        filename.push("../../tests/test-data/prot/all.zip");
+        let cl = Collection::from_zipfile(&filename).unwrap();
+
+        let mut transform = SigTransform::default();
+        transform.set_flatten(true);
+        transform.set_scaled(200);
+        transform.set_compression(1);
+
+        let mut locations = vec![];
+        cl.transform(&transform, 2, |record, data| {
+            let sigs = Signature::from_reader(&data[..])?;
+            assert_eq!(sigs.len(), 1);
+            let mh = sigs[0].minhash().unwrap();
+            assert_eq!(mh.scaled(), 200);
+            assert!(!mh.track_abundance());
+            assert_eq!(&mh.md5sum(), record.md5());
+            assert!(!record.with_abundance());
+
+            locations.push(record.internal_location().clone());
+            Ok(())
+        })
+        .unwrap();
+
+        let expected: Vec<_> = cl
+            .manifest()
+            .iter()
+            .map(|r| r.internal_location().clone())
+            .collect();
+        assert_eq!(locations, expected);
+    }
+
+    #[test]
+    fn collection_copy_records_verbatim() {
+        let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        filename.push("../../tests/test-data/track_abund/track_abund.zip");
+        let cl = Collection::from_zipfile(&filename).unwrap();
+        let records: Vec<_> = cl.manifest().iter().cloned().collect();
+
+        // members holding a single sketch are copied as-is...
+        let own = vec![true; records.len()];
+        let copied = copy_records(cl.storage(), &records, &own, 1).unwrap();
+        assert_eq!(copied.len(), records.len());
+        for ((record, data), orig) in copied.iter().zip(records.iter()) {
+            assert_eq!(record, orig);
+            let raw = cl
+                .storage()
+                .load(orig.internal_location().as_str())
+                .unwrap();
+            assert_eq!(data, &raw);
+        }
+
+        // ...and others are decoded, keeping only the sketch for the record.
+        let own = vec![false; records.len()];
+        let decoded = copy_records(cl.storage(), &records, &own, 1).unwrap();
+        for ((record, data), orig) in decoded.iter().zip(records.iter()) {
+            assert_eq!(record, orig);
+            let sigs = Signature::from_reader(&data[..]).unwrap();
+            assert_eq!(sigs.len(), 1);
+            assert_eq!(&sigs[0].minhash().unwrap().md5sum(), orig.md5());
+        }
+    }
+
+    #[test]
+    fn collection_record_sig_iter() {
+        let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        filename.push("../../tests/test-data/prot/all.zip");
+        let cl = Collection::from_zipfile(&filename).unwrap();
+        let records: Vec<_> = cl.manifest().iter().cloned().collect();
+        assert!(records.len() > 3);
+
+        let storage = Arc::new(ZipStorage::from_file(&filename).unwrap());
+        let md5s: Vec<_> = RecordSigIter::new(storage.clone(), records.clone(), 3)
+            .map(|sig| sig.unwrap().minhash().unwrap().md5sum())
+            .collect();
+        let expected: Vec<_> = records.iter().map(|r| r.md5().clone()).collect();
+        assert_eq!(md5s, expected);
+
+        // records whose sketch is not in their member are skipped
+        let sig = load_record_sig(storage.as_ref(), &records[0]).unwrap();
+        let mut mh = sig.minhash().unwrap().clone();
+        mh.add_hash(1);
+        let missing = records[0].with_minhash(&mh);
+        let mut with_missing = records.clone();
+        with_missing.insert(1, missing.clone());
+        let md5s: Vec<_> = RecordSigIter::new(storage.clone(), with_missing, 3)
+            .map(|sig| sig.unwrap().minhash().unwrap().md5sum())
+            .collect();
+        assert_eq!(md5s, expected);
+        assert!(load_records_sigs(storage.as_ref(), &[missing])[0].is_err());
+
+        // dropping a partially consumed iterator stops the loader
+        let mut iter = RecordSigIter::new(storage, records, 1);
+        assert!(iter.next().is_some());
+        drop(iter);
+    }
+
+    #[test]
+    fn collection_load_records_sigs_shared_member() {
+        let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        filename.push("../../tests/test-data/47+63-multisig.sig");
+        let sigs = Signature::from_path(&filename).unwrap();
+
+        // every record points at the same file
+        let records: Vec<_> = sigs
+            .iter()
+            .flat_map(|sig| Record::from_sig(sig, filename.as_str()))
+            .collect();
+        assert!(records.len() > 1);
+
+        let storage = FSStorage::builder()
+            .fullpath("".into())
+            .subdir("".into())
+            .build();
+        let loaded = load_records_sigs(&storage, &records);
+        assert_eq!(loaded.len(), records.len());
+        for (record, sig) in records.iter().zip(loaded) {
+            let sig = sig.unwrap();
+            assert_eq!(sig.size(), 1);
+            assert_eq!(&sig.minhash().unwrap().md5sum(), record.md5());
+            assert_eq!(sig, load_record_sig(&storage, record).unwrap());
+        }
+    }
 }
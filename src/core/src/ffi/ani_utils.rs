@@ -0,0 +1,36 @@
+use std::slice;
+
+use crate::ani_utils::ani_ci_from_containment_many;
+
+ffi_fn! {
+/// Containment ANI confidence intervals for `insize` comparisons.
+///
+/// Entry `i` of `containments`, `ksizes`, `scaled` and `n_unique_kmers`
+/// describes one comparison. Its interval goes into entry `i` of the
+/// caller-owned arrays `ani_low` and `ani_high`. Intervals that can't be
+/// estimated are set to NaN.
+#[allow(clippy::too_many_arguments)]
+unsafe fn sourmash_ani_ci_from_containment_many(
+    containments: *const f64,
+    ksizes: *const u32,
+    scaled: *const u64,
+    n_unique_kmers: *const u64,
+    insize: usize,
+    confidence: f64,
+    ani_low: *mut f64,
+    ani_high: *mut f64,
+) -> Result<()> {
+    if insize == 0 {
+        return Ok(());
+    }
+    ani_ci_from_containment_many(
+        slice::from_raw_parts(containments, insize),
+        slice::from_raw_parts(ksizes, insize),
+        slice::from_raw_parts(scaled, insize),
+        slice::from_raw_parts(n_unique_kmers, insize),
+        confidence,
+        slice::from_raw_parts_mut(ani_low, insize),
+        slice::from_raw_parts_mut(ani_high, insize),
+    )
+}
+}
@@ -139,6 +139,18 @@ pub unsafe extern "C" fn computeparams_set_track_abundance(
     cp.set_track_abundance(v);
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn computeparams_hll(ptr: *const SourmashComputeParameters) -> bool {
+    let cp = SourmashComputeParameters::as_rust(ptr);
+    cp.hll()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn computeparams_set_hll(ptr: *mut SourmashComputeParameters, v: bool) {
+    let cp = SourmashComputeParameters::as_rust_mut(ptr);
+    cp.set_hll(v);
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn computeparams_num_hashes(ptr: *const SourmashComputeParameters) -> u32 {
     let cp = SourmashComputeParameters::as_rust(ptr);
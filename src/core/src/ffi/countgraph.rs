@@ -0,0 +1,256 @@
+use std::ffi::CStr;
+use std::os::raw::c_char;
+use std::slice;
+
+use crate::prelude::*;
+use crate::sketch::countgraph::Countgraph;
+
+use crate::ffi::minhash::SourmashKmerMinHash;
+use crate::ffi::utils::ForeignObject;
+
+pub struct SourmashCountgraph;
+
+impl ForeignObject for SourmashCountgraph {
+    type RustObject = Countgraph;
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_new() -> *mut SourmashCountgraph {
+    SourmashCountgraph::from_rust(Countgraph::default())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_free(ptr: *mut SourmashCountgraph) {
+    SourmashCountgraph::drop(ptr);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_with_tables(
+    ksize: usize,
+    starting_size: usize,
+    n_tables: usize,
+) -> *mut SourmashCountgraph {
+    let cg = Countgraph::with_tables(starting_size, n_tables, ksize);
+    SourmashCountgraph::from_rust(cg)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_count(ptr: *mut SourmashCountgraph, h: u64) -> bool {
+    let cg = SourmashCountgraph::as_rust_mut(ptr);
+    cg.count(h)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_count_with_abundance(
+    ptr: *mut SourmashCountgraph,
+    h: u64,
+    abundance: u64,
+) -> bool {
+    let cg = SourmashCountgraph::as_rust_mut(ptr);
+    cg.count_with_abundance(h, abundance)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_count_kmer(
+    ptr: *mut SourmashCountgraph,
+    kmer: *const c_char,
+) -> bool {
+    let cg = SourmashCountgraph::as_rust_mut(ptr);
+
+    // FIXME use buffer + len instead of cstr
+    let c_str = {
+        assert!(!kmer.is_null());
+
+        CStr::from_ptr(kmer)
+    };
+
+    cg.count_kmer(c_str.to_bytes())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_get(ptr: *const SourmashCountgraph, h: u64) -> usize {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    cg.get(h)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_get_kmer(
+    ptr: *const SourmashCountgraph,
+    kmer: *const c_char,
+) -> usize {
+    let cg = SourmashCountgraph::as_rust(ptr);
+
+    // FIXME use buffer + len instead of cstr
+    let c_str = {
+        assert!(!kmer.is_null());
+
+        CStr::from_ptr(kmer)
+    };
+
+    cg.get_kmer(c_str.to_bytes())
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_expected_collisions(ptr: *const SourmashCountgraph) -> f64 {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    cg.expected_collisions()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_ksize(ptr: *const SourmashCountgraph) -> usize {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    cg.ksize()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_hashsizes(
+    ptr: *const SourmashCountgraph,
+    size: *mut usize,
+) -> *const u64 {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    let st = cg.tablesizes();
+
+    let b = st.into_boxed_slice();
+    *size = b.len();
+
+    Box::into_raw(b) as *const u64
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_ntables(ptr: *const SourmashCountgraph) -> usize {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    cg.ntables()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_noccupied(ptr: *const SourmashCountgraph) -> usize {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    cg.noccupied()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_matches(
+    ptr: *const SourmashCountgraph,
+    mh_ptr: *const SourmashKmerMinHash,
+) -> usize {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    let mh = SourmashKmerMinHash::as_rust(mh_ptr);
+    cg.matches(mh)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn countgraph_matches_weighted(
+    ptr: *const SourmashCountgraph,
+    mh_ptr: *const SourmashKmerMinHash,
+) -> u64 {
+    let cg = SourmashCountgraph::as_rust(ptr);
+    let mh = SourmashKmerMinHash::as_rust(mh_ptr);
+    cg.matches_weighted(mh)
+}
+
+ffi_fn! {
+unsafe fn countgraph_update(
+    ptr: *mut SourmashCountgraph,
+    optr: *const SourmashCountgraph,
+) -> Result<()> {
+    let cg = SourmashCountgraph::as_rust_mut(ptr);
+    let ocg = SourmashCountgraph::as_rust(optr);
+
+    ocg.update(cg)
+}
+}
+
+ffi_fn! {
+unsafe fn countgraph_update_mh(
+    ptr: *mut SourmashCountgraph,
+    optr: *const SourmashKmerMinHash,
+) -> Result<()> {
+    let cg = SourmashCountgraph::as_rust_mut(ptr);
+    let mh = SourmashKmerMinHash::as_rust(optr);
+
+    mh.update(cg)
+}
+}
+
+ffi_fn! {
+unsafe fn countgraph_from_path(filename: *const c_char) -> Result<*mut SourmashCountgraph> {
+    // FIXME use buffer + len instead of c_str
+    let c_str = {
+        assert!(!filename.is_null());
+
+        CStr::from_ptr(filename)
+    };
+
+    let (mut input, _) = niffler::from_path(c_str.to_str()?)?;
+    let cg = Countgraph::from_reader(&mut input)?;
+
+    Ok(SourmashCountgraph::from_rust(cg))
+}
+}
+
+ffi_fn! {
+unsafe fn countgraph_from_buffer(ptr: *const c_char, insize: usize) -> Result<*mut SourmashCountgraph> {
+    let buf = {
+        assert!(!ptr.is_null());
+        slice::from_raw_parts(ptr as *mut u8, insize)
+    };
+
+    let cg = Countgraph::from_reader(buf)?;
+
+    Ok(SourmashCountgraph::from_rust(cg))
+}
+}
+
+ffi_fn! {
+unsafe fn countgraph_save(ptr: *const SourmashCountgraph, filename: *const c_char) -> Result<()> {
+    let cg = SourmashCountgraph::as_rust(ptr);
+
+    // FIXME use buffer + len instead of c_str
+    let c_str = {
+        assert!(!filename.is_null());
+
+        CStr::from_ptr(filename)
+    };
+
+    cg.save(c_str.to_str()?)?;
+
+    Ok(())
+}
+}
+
+ffi_fn! {
+/// Save to a (gzip-compressed, if `compression > 0`) buffer.
+/// Free it with `nodegraph_buffer_free`.
+unsafe fn countgraph_to_buffer(ptr: *const SourmashCountgraph, compression: u8, size: *mut usize) -> Result<*const u8> {
+    let cg = SourmashCountgraph::as_rust(ptr);
+
+    let mut buffer = vec![];
+    {
+      let mut writer = if compression > 0 {
+          let level = match compression {
+            1 => niffler::compression::Level::One,
+            2 => niffler::compression::Level::Two,
+            3 => niffler::compression::Level::Three,
+            4 => niffler::compression::Level::Four,
+            5 => niffler::compression::Level::Five,
+            6 => niffler::compression::Level::Six,
+            7 => niffler::compression::Level::Seven,
+            8 => niffler::compression::Level::Eight,
+            _ => niffler::compression::Level::Nine,
+          };
+
+          niffler::get_writer(Box::new(&mut buffer),
+                              niffler::compression::Format::Gzip,
+                              level)?
+      } else {
+          Box::new(&mut buffer)
+      };
+      cg.save_to_writer(&mut writer)?;
+    }
+
+    let b = buffer.into_boxed_slice();
+    *size = b.len();
+
+    Ok(Box::into_raw(b) as *const u8)
+}
+}
@@ -8,6 +8,7 @@ use crate::sketch::hyperloglog::HyperLogLog;
 
 use crate::ffi::minhash::SourmashKmerMinHash;
 use crate::ffi::utils::ForeignObject;
+use crate::ffi::HashFunctions;
 
 pub struct SourmashHyperLogLog;
 
@@ -35,6 +36,34 @@ unsafe fn hll_with_error_rate(
 }
 }
 
+ffi_fn! {
+unsafe fn hll_with_hash_function(
+    error_rate: f64,
+    ksize: usize,
+    hash_function: HashFunctions,
+    seed: u64,
+) -> Result<*mut SourmashHyperLogLog> {
+    let hll = HyperLogLog::with_error_rate(error_rate, ksize)?
+        .with_hash_function(hash_function.into(), seed);
+    Ok(SourmashHyperLogLog::from_rust(hll))
+}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn hll_seed(ptr: *const SourmashHyperLogLog) -> u64 {
+    SourmashHyperLogLog::as_rust(ptr).seed()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn hll_hash_function(ptr: *const SourmashHyperLogLog) -> HashFunctions {
+    SourmashHyperLogLog::as_rust(ptr).hash_function().into()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn hll_relative_error(ptr: *const SourmashHyperLogLog) -> f64 {
+    SourmashHyperLogLog::as_rust(ptr).relative_error()
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn hll_ksize(ptr: *const SourmashHyperLogLog) -> usize {
     SourmashHyperLogLog::as_rust(ptr).ksize()
@@ -88,6 +117,24 @@ unsafe fn hll_add_sequence(
 }
 }
 
+ffi_fn! {
+unsafe fn hll_add_protein(
+  ptr: *mut SourmashHyperLogLog,
+  sequence: *const c_char,
+  insize: usize,
+) -> Result<()> {
+
+    let hll = SourmashHyperLogLog::as_rust_mut(ptr);
+
+    let buf = {
+        assert!(!ptr.is_null());
+        slice::from_raw_parts(sequence as *mut u8, insize)
+    };
+
+    hll.add_protein(buf)
+}
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn hll_add_hash(ptr: *mut SourmashHyperLogLog, hash: u64) {
     let hll = SourmashHyperLogLog::as_rust_mut(ptr);
@@ -0,0 +1,229 @@
+use std::ffi::CStr;
+use std::os::raw::c_char;
+use std::slice;
+
+use crate::encodings::HashFunctions;
+use crate::manifest::ColumnarManifest;
+use crate::selection::Selection;
+
+use crate::ffi::picklist::SourmashPicklistMatcher;
+use crate::ffi::utils::{ForeignObject, SourmashStr};
+
+pub struct SourmashManifest;
+
+impl ForeignObject for SourmashManifest {
+    type RustObject = ColumnarManifest;
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn manifest_free(ptr: *mut SourmashManifest) {
+    SourmashManifest::drop(ptr);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn manifest_indices_free(ptr: *mut u64, insize: usize) {
+    if ptr.is_null() {
+        return;
+    }
+    Vec::from_raw_parts(ptr, insize, insize);
+}
+
+ffi_fn! {
+unsafe fn manifest_from_buffer(ptr: *const c_char, insize: usize) -> Result<*mut SourmashManifest> {
+    // Use slice::from_raw_parts instead of Vec::from_raw_parts
+    // because Vec takes ownership of the memory
+    let buf = {
+        assert!(!ptr.is_null());
+        slice::from_raw_parts(ptr as *mut u8, insize)
+    };
+
+    let manifest = ColumnarManifest::from_reader(buf)?;
+    Ok(SourmashManifest::from_rust(manifest))
+}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn manifest_len(ptr: *const SourmashManifest) -> usize {
+    let manifest = SourmashManifest::as_rust(ptr);
+    manifest.len()
+}
+
+unsafe fn indices_arg(indices_ptr: *const u64, insize: usize) -> Option<Vec<usize>> {
+    if indices_ptr.is_null() {
+        None
+    } else {
+        let indices = slice::from_raw_parts(indices_ptr, insize);
+        Some(indices.iter().map(|&i| i as usize).collect())
+    }
+}
+
+ffi_fn! {
+/// Select rows, returning their indices; 0/null/false arguments are ignored.
+///
+/// If `indices_ptr` is not null, only those rows are considered.
+unsafe fn manifest_select(
+    ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+    ksize: u32,
+    moltype: *const c_char,
+    scaled: bool,
+    abund: bool,
+    size: *mut usize,
+) -> Result<*const u64> {
+    let manifest = SourmashManifest::as_rust(ptr);
+    let indices = indices_arg(indices_ptr, insize);
+
+    let mut selection = Selection::default();
+    if ksize != 0 {
+        selection.set_ksize(ksize);
+    }
+    if !moltype.is_null() {
+        let moltype = CStr::from_ptr(moltype).to_str()?;
+        // moltype is matched exactly by name: only use a known hash function
+        // if it displays as the same name.
+        let hash_function = match HashFunctions::try_from(moltype) {
+            Ok(hf) if hf.to_string() == moltype => hf,
+            _ => HashFunctions::Custom(moltype.into()),
+        };
+        selection.set_moltype(hash_function);
+    }
+    if abund {
+        selection.set_abund(true);
+    }
+
+    let mut selected = manifest.select_indices(indices.as_deref(), &selection);
+    if scaled {
+        // any scaled sketch can be downsampled as needed.
+        selected = manifest.select_scaled(Some(&selected));
+    }
+
+    let output: Vec<u64> = selected
+        .into_iter()
+        .map(|i| i as u64)
+        .collect();
+    *size = output.len();
+
+    Ok(Box::into_raw(output.into_boxed_slice()) as *const u64)
+}
+}
+
+ffi_fn! {
+/// Select rows passing a picklist, returning their indices.
+///
+/// If `indices_ptr` is not null, only those rows are considered.
+unsafe fn manifest_select_picklist(
+    ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+    picklist_ptr: *mut SourmashPicklistMatcher,
+    size: *mut usize,
+) -> Result<*const u64> {
+    let manifest = SourmashManifest::as_rust(ptr);
+    let picklist = SourmashPicklistMatcher::as_rust_mut(picklist_ptr);
+    let indices = indices_arg(indices_ptr, insize);
+
+    let output: Vec<u64> = manifest
+        .select_picklist(indices.as_deref(), picklist)
+        .into_iter()
+        .map(|i| i as u64)
+        .collect();
+    *size = output.len();
+
+    Ok(Box::into_raw(output.into_boxed_slice()) as *const u64)
+}
+}
+
+ffi_fn! {
+/// Write the given rows as manifest CSV; all rows if `indices_ptr` is null.
+unsafe fn manifest_rows_to_csv(
+    ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+) -> Result<SourmashStr> {
+    let manifest = SourmashManifest::as_rust(ptr);
+    let indices = indices_arg(indices_ptr, insize)
+        .unwrap_or_else(|| (0..manifest.len()).collect());
+
+    let mut buffer = vec![];
+    manifest.to_writer(&indices, &mut buffer)?;
+    Ok(String::from_utf8(buffer).map_err(|e| e.utf8_error())?.into())
+}
+}
+
+ffi_fn! {
+/// Fill the numeric columns of the given rows; each output array holds
+/// `insize` values.
+unsafe fn manifest_numeric_columns(
+    ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+    ksize: *mut u32,
+    num: *mut u32,
+    scaled: *mut u64,
+    n_hashes: *mut u64,
+    with_abundance: *mut bool,
+) -> Result<()> {
+    let manifest = SourmashManifest::as_rust(ptr);
+    let indices = slice::from_raw_parts(indices_ptr, insize);
+
+    let ksize = slice::from_raw_parts_mut(ksize, insize);
+    let num = slice::from_raw_parts_mut(num, insize);
+    let scaled = slice::from_raw_parts_mut(scaled, insize);
+    let n_hashes = slice::from_raw_parts_mut(n_hashes, insize);
+    let with_abundance = slice::from_raw_parts_mut(with_abundance, insize);
+
+    for (pos, &row) in indices.iter().enumerate() {
+        let row = row as usize;
+        ksize[pos] = manifest.ksize(row);
+        num[pos] = manifest.num(row);
+        scaled[pos] = manifest.scaled(row);
+        n_hashes[pos] = manifest.n_hashes(row) as u64;
+        with_abundance[pos] = manifest.with_abundance(row);
+    }
+
+    Ok(())
+}
+}
+
+ffi_fn! {
+/// Values of a string column for the given rows.
+///
+/// Returns the distinct values concatenated; `offsets` gets `size + 1`
+/// character offsets into it (free with `manifest_indices_free`), and `ids`
+/// the position of each row's value.
+unsafe fn manifest_str_column(
+    ptr: *const SourmashManifest,
+    column: *const c_char,
+    indices_ptr: *const u64,
+    insize: usize,
+    ids: *mut u32,
+    offsets: *mut *const u64,
+    size: *mut usize,
+) -> Result<SourmashStr> {
+    let manifest = SourmashManifest::as_rust(ptr);
+    let column = CStr::from_ptr(column).to_str()?;
+    let indices: Vec<usize> = slice::from_raw_parts(indices_ptr, insize)
+        .iter()
+        .map(|&i| i as usize)
+        .collect();
+
+    let (values, row_ids) = manifest.str_column(column, &indices)?;
+    slice::from_raw_parts_mut(ids, insize).copy_from_slice(&row_ids);
+
+    let mut concatenated = String::new();
+    let mut value_offsets = Vec::with_capacity(values.len() + 1);
+    let mut nchars = 0u64;
+    value_offsets.push(nchars);
+    for value in &values {
+        concatenated.push_str(value);
+        nchars += value.chars().count() as u64;
+        value_offsets.push(nchars);
+    }
+
+    *size = values.len();
+    *offsets = Box::into_raw(value_offsets.into_boxed_slice()) as *const u64;
+
+    Ok(concatenated.into())
+}
+}
@@ -3,11 +3,14 @@ use std::os::raw::c_char;
 use std::slice;
 
 use crate::encodings::{aa_to_dayhoff, aa_to_hp, translate_codon};
+use crate::ffi::hyperloglog::SourmashHyperLogLog;
 use crate::ffi::utils::{ForeignObject, SourmashStr};
 use crate::ffi::HashFunctions;
 use crate::signature::SeqToHashes;
 use crate::signature::SigsTrait;
-use crate::sketch::minhash::KmerMinHash;
+use crate::sketch::minhash::{
+    count_common_many, similarity_many, similarity_tile, ComparisonStats, KmerMinHash,
+};
 
 pub struct SourmashKmerMinHash;
 
@@ -199,8 +202,7 @@ pub unsafe extern "C" fn kmerminhash_remove_many(
     };
 
     // FIXME: proper exception here
-    mh.remove_many(hashes.iter().copied())
-        .expect("Hash removal error");
+    mh.remove_many_sorted(hashes).expect("Hash removal error");
 }
 
 ffi_fn! {
@@ -214,6 +216,34 @@ unsafe fn kmerminhash_get_mins(ptr: *const SourmashKmerMinHash, size: *mut usize
 }
 }
 
+ffi_fn! {
+/// Borrow the hashes; valid until the MinHash is modified or freed.
+unsafe fn kmerminhash_mins_view(ptr: *const SourmashKmerMinHash, size: *mut usize) -> Result<*const u64> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    let mins = mh.mins_slice();
+    *size = mins.len();
+
+    Ok(mins.as_ptr())
+}
+}
+
+ffi_fn! {
+/// Borrow the abundances, like `kmerminhash_mins_view`.
+///
+/// Returns NULL if abundances are not tracked.
+unsafe fn kmerminhash_abunds_view(ptr: *const SourmashKmerMinHash, size: *mut usize) -> Result<*const u64> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+
+    if let Some(abunds) = mh.abunds_slice() {
+        *size = abunds.len();
+        Ok(abunds.as_ptr())
+    } else {
+        *size = 0;
+        Ok(std::ptr::null())
+    }
+}
+}
+
 ffi_fn! {
 unsafe fn kmerminhash_md5sum(ptr: *const SourmashKmerMinHash) -> Result<SourmashStr> {
     let mh = SourmashKmerMinHash::as_rust(ptr);
@@ -237,11 +267,7 @@ unsafe fn kmerminhash_add_many(
         slice::from_raw_parts(hashes_ptr, insize)
     };
 
-    for hash in hashes {
-      mh.add_hash(*hash);
-    }
-
-    Ok(())
+    mh.add_many_sorted(hashes, None)
 }
 }
 
@@ -288,17 +314,12 @@ unsafe fn kmerminhash_set_abundances(
         slice::from_raw_parts(abunds_ptr, insize)
     };
 
-    let mut pairs: Vec<_> = hashes.iter().cloned().zip(abunds.iter().cloned()).collect();
-    pairs.sort_unstable();
-
     // Reset the minhash
     if clear {
         mh.clear();
     }
 
-    mh.add_many_with_abund(&pairs)?;
-
-    Ok(())
+    mh.add_many_sorted(hashes, Some(abunds))
 }
 }
 
@@ -346,6 +367,61 @@ unsafe fn kmerminhash_enable_abundance(ptr: *mut SourmashKmerMinHash) -> Result<
 }
 }
 
+#[no_mangle]
+pub unsafe extern "C" fn kmerminhash_track_hll(ptr: *const SourmashKmerMinHash) -> bool {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    mh.track_hll()
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn kmerminhash_disable_hll(ptr: *mut SourmashKmerMinHash) {
+    let mh = SourmashKmerMinHash::as_rust_mut(ptr);
+    mh.disable_hll();
+}
+
+ffi_fn! {
+unsafe fn kmerminhash_enable_hll(ptr: *mut SourmashKmerMinHash) -> Result<()> {
+    let mh = SourmashKmerMinHash::as_rust_mut(ptr);
+    mh.enable_hll()?;
+    Ok(())
+}
+}
+
+ffi_fn! {
+/// A copy of the companion HLL, or NULL if the sketch doesn't collect one.
+unsafe fn kmerminhash_hll(ptr: *const SourmashKmerMinHash) -> Result<*mut SourmashHyperLogLog> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    match mh.hll() {
+        Some(hll) => Ok(SourmashHyperLogLog::from_rust(hll.clone())),
+        None => Ok(std::ptr::null_mut()),
+    }
+}
+}
+
+ffi_fn! {
+/// Use a copy of `hll_ptr` as the companion HLL.
+unsafe fn kmerminhash_set_hll(ptr: *mut SourmashKmerMinHash, hll_ptr: *const SourmashHyperLogLog) -> Result<()> {
+    let mh = SourmashKmerMinHash::as_rust_mut(ptr);
+    let hll = SourmashHyperLogLog::as_rust(hll_ptr);
+    mh.set_hll(hll.clone())
+}
+}
+
+/// Relative standard error of the companion HLL, or 0 if there is none.
+#[no_mangle]
+pub unsafe extern "C" fn kmerminhash_hll_relative_error(ptr: *const SourmashKmerMinHash) -> f64 {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    mh.hll().map_or(0.0, |hll| hll.relative_error())
+}
+
+/// Approximate number of distinct k-mers in the data; the companion HLL
+/// estimate if there is one, otherwise size * scaled.
+#[no_mangle]
+pub unsafe extern "C" fn kmerminhash_n_unique_kmers(ptr: *const SourmashKmerMinHash) -> u64 {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    mh.n_unique_kmers()
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn kmerminhash_num(ptr: *const SourmashKmerMinHash) -> u32 {
     let mh = SourmashKmerMinHash::as_rust(ptr);
@@ -425,6 +501,84 @@ unsafe fn kmerminhash_count_common(ptr: *const SourmashKmerMinHash, other: *cons
 }
 }
 
+unsafe fn as_rust_many<'a>(
+    ptrs: *const *const SourmashKmerMinHash,
+    insize: usize,
+) -> Vec<&'a KmerMinHash> {
+    if insize == 0 {
+        return vec![];
+    }
+    assert!(!ptrs.is_null());
+    slice::from_raw_parts(ptrs, insize)
+        .iter()
+        .map(|mh| SourmashKmerMinHash::as_rust(*mh))
+        .collect()
+}
+
+ffi_fn! {
+/// Count hashes in common between `ptr` and each of the `insize` sketches
+/// in `others`, writing the counts into the caller-owned array `out`.
+unsafe fn kmerminhash_count_common_many(
+    ptr: *const SourmashKmerMinHash,
+    others: *const *const SourmashKmerMinHash,
+    insize: usize,
+    downsample: bool,
+    out: *mut u64,
+) -> Result<()> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    let others = as_rust_many(others, insize);
+    if insize == 0 {
+        return Ok(());
+    }
+    let out = slice::from_raw_parts_mut(out, insize);
+    count_common_many(mh, &others, downsample, out)
+}
+}
+
+ffi_fn! {
+/// Similarity between `ptr` and each of the `insize` sketches in `others`,
+/// written into the caller-owned array `out`.
+unsafe fn kmerminhash_similarity_many(
+    ptr: *const SourmashKmerMinHash,
+    others: *const *const SourmashKmerMinHash,
+    insize: usize,
+    ignore_abundance: bool,
+    downsample: bool,
+    out: *mut f64,
+) -> Result<()> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    let others = as_rust_many(others, insize);
+    if insize == 0 {
+        return Ok(());
+    }
+    let out = slice::from_raw_parts_mut(out, insize);
+    similarity_many(mh, &others, ignore_abundance, downsample, out)
+}
+}
+
+ffi_fn! {
+/// Similarity between each of the `nrows` sketches in `rows` and each of the
+/// `ncols` sketches in `cols`, written row-major into the caller-owned
+/// `nrows * ncols` array `out`.
+unsafe fn kmerminhash_similarity_tile(
+    rows: *const *const SourmashKmerMinHash,
+    nrows: usize,
+    cols: *const *const SourmashKmerMinHash,
+    ncols: usize,
+    ignore_abundance: bool,
+    downsample: bool,
+    out: *mut f64,
+) -> Result<()> {
+    let rows = as_rust_many(rows, nrows);
+    let cols = as_rust_many(cols, ncols);
+    if nrows == 0 || ncols == 0 {
+        return Ok(());
+    }
+    let out = slice::from_raw_parts_mut(out, nrows * ncols);
+    similarity_tile(&rows, &cols, ignore_abundance, downsample, out)
+}
+}
+
 ffi_fn! {
 unsafe fn kmerminhash_intersection(ptr: *const SourmashKmerMinHash, other: *const SourmashKmerMinHash)
     -> Result<*mut SourmashKmerMinHash> {
@@ -434,12 +588,47 @@ unsafe fn kmerminhash_intersection(ptr: *const SourmashKmerMinHash, other: *cons
     let isect = mh.intersection(other_mh)?;
     let mut new_mh = mh.clone();
     new_mh.clear();
+    // the HLL of either side doesn't describe the intersection.
+    new_mh.disable_hll();
     new_mh.add_many(&isect.0)?;
 
     Ok(SourmashKmerMinHash::from_rust(new_mh))
 }
 }
 
+ffi_fn! {
+unsafe fn kmerminhash_inflated_sum_abundances(ptr: *const SourmashKmerMinHash, abunds_from: *const SourmashKmerMinHash)
+    -> Result<u64> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    let abunds_from_mh = SourmashKmerMinHash::as_rust(abunds_from);
+    mh.inflated_sum_abundances(abunds_from_mh)
+}
+}
+
+ffi_fn! {
+unsafe fn kmerminhash_downsample_scaled(ptr: *const SourmashKmerMinHash, scaled: u64)
+    -> Result<*mut SourmashKmerMinHash> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    let new_mh = mh.downsample_scaled(scaled)?;
+
+    Ok(SourmashKmerMinHash::from_rust(new_mh))
+}
+}
+
+ffi_fn! {
+/// Intersection, union and abundance statistics between `ptr` and `other`,
+/// computed in a single pass. Abundance statistics are taken from `ptr`.
+unsafe fn kmerminhash_comparison_stats(
+    ptr: *const SourmashKmerMinHash,
+    other: *const SourmashKmerMinHash,
+    downsample: bool,
+) -> Result<ComparisonStats> {
+    let mh = SourmashKmerMinHash::as_rust(ptr);
+    let other_mh = SourmashKmerMinHash::as_rust(other);
+    mh.comparison_stats(other_mh, downsample)
+}
+}
+
 ffi_fn! {
 unsafe fn kmerminhash_intersection_union_size(ptr: *const SourmashKmerMinHash, other: *const SourmashKmerMinHash, union_size: *mut u64)
     -> Result<u64> {
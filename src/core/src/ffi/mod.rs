@@ -1,16 +1,30 @@
 //! # Foreign Function Interface for calling sourmash from a C API
 //!
 //! Primary client for now is the Python version, using CFFI and maturin.
+//!
+//! ## Thread safety
+//!
+//! CFFI releases the GIL around every foreign call, so Python threads can
+//! run FFI functions concurrently. Functions taking a `*const` pointer only
+//! read the object and may be called from many threads at once on the same
+//! object (the lazily computed md5sum lives in a `sync::OnceCell`).
+//! Functions taking a `*mut` pointer need exclusive access for the duration
+//! of the call. Errors are reported through the thread-local `LAST_ERROR`,
+//! so the clear/call/check sequence done by `rustcall` is per-thread.
 #![allow(clippy::missing_safety_doc)]
 
 #[macro_use]
 pub mod utils;
 
+pub mod ani_utils;
 pub mod cmd;
+pub mod countgraph;
 pub mod hyperloglog;
 pub mod index;
+pub mod manifest;
 pub mod minhash;
 pub mod nodegraph;
+pub mod picklist;
 pub mod signature;
 pub mod storage;
 
@@ -66,3 +80,23 @@ impl From<crate::encodings::HashFunctions> for HashFunctions {
         }
     }
 }
+
+#[cfg(test)]
+mod test {
+    use crate::signature::Signature;
+    use crate::sketch::minhash::{KmerMinHash, KmerMinHashBTree};
+    use crate::storage::ZipStorage;
+
+    fn assert_send_sync<T: Send + Sync>() {}
+
+    #[test]
+    fn shared_objects_are_send_sync() {
+        assert_send_sync::<KmerMinHash>();
+        assert_send_sync::<KmerMinHashBTree>();
+        assert_send_sync::<Signature>();
+        assert_send_sync::<ZipStorage>();
+
+        #[cfg(all(not(target_arch = "wasm32"), feature = "branchwater"))]
+        assert_send_sync::<crate::index::revindex::mem_revindex::RevIndex>();
+    }
+}
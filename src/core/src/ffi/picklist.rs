@@ -0,0 +1,88 @@
+use std::ffi::CStr;
+use std::os::raw::c_char;
+use std::slice;
+
+use crate::selection::{PickColumn, PickStyle, PicklistMatcher};
+
+use crate::ffi::utils::ForeignObject;
+
+pub struct SourmashPicklistMatcher;
+
+impl ForeignObject for SourmashPicklistMatcher {
+    type RustObject = PicklistMatcher;
+}
+
+ffi_fn! {
+unsafe fn picklist_matcher_new(
+    coltype: *const c_char,
+    pickstyle: PickStyle,
+) -> Result<*mut SourmashPicklistMatcher> {
+    let coltype = {
+        assert!(!coltype.is_null());
+        CStr::from_ptr(coltype).to_str()?
+    };
+    let column = PickColumn::try_from(coltype)?;
+
+    let matcher = PicklistMatcher::new(column, pickstyle);
+    Ok(SourmashPicklistMatcher::from_rust(matcher))
+}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn picklist_matcher_free(ptr: *mut SourmashPicklistMatcher) {
+    SourmashPicklistMatcher::drop(ptr);
+}
+
+ffi_fn! {
+/// Add values from a buffer of NUL-terminated strings.
+///
+/// For the manifest/gather/prefetch/search coltypes, values alternate
+/// between ident and md5short.
+unsafe fn picklist_matcher_add_many(
+    ptr: *mut SourmashPicklistMatcher,
+    values_ptr: *const c_char,
+    insize: usize,
+) -> Result<()> {
+    let matcher = SourmashPicklistMatcher::as_rust_mut(ptr);
+    let buf = {
+        assert!(!values_ptr.is_null());
+        slice::from_raw_parts(values_ptr as *const u8, insize)
+    };
+    let buf = std::str::from_utf8(buf)?;
+    if buf.is_empty() {
+        return Ok(());
+    }
+    let mut values = buf.strip_suffix('\0').unwrap_or(buf).split('\0');
+
+    if matcher.column() == PickColumn::IdentMd5Short {
+        while let (Some(ident), Some(md5short)) = (values.next(), values.next()) {
+            matcher.add_pair(ident, md5short);
+        }
+    } else {
+        for value in values {
+            matcher.add(value);
+        }
+    }
+    Ok(())
+}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn picklist_matcher_len(ptr: *const SourmashPicklistMatcher) -> usize {
+    let matcher = SourmashPicklistMatcher::as_rust(ptr);
+    matcher.len()
+}
+
+ffi_fn! {
+/// ids (in insertion order) of the values matched so far.
+unsafe fn picklist_matcher_found(
+    ptr: *const SourmashPicklistMatcher,
+    size: *mut usize,
+) -> Result<*const u64> {
+    let matcher = SourmashPicklistMatcher::as_rust(ptr);
+    let output: Vec<u64> = matcher.found().map(|id| id as u64).collect();
+    *size = output.len();
+
+    Ok(Box::into_raw(output.into_boxed_slice()) as *const u64)
+}
+}
@@ -7,7 +7,7 @@ use std::slice;
 use crate::errors::SourmashError;
 
 use crate::encodings::HashFunctions;
-use crate::signature::Signature;
+use crate::signature::{signatures_to_buffer, Signature};
 use crate::sketch::Sketch;
 
 use crate::ffi::cmd::compute::SourmashComputeParameters;
@@ -226,30 +226,7 @@ unsafe fn signatures_save_buffer(ptr: *const *const SourmashSignature, size: usi
     };
 
     let rsigs: Vec<&Signature> = sigs.iter().map(|x| SourmashSignature::as_rust(*x)).collect();
-
-    let mut buffer = vec![];
-    {
-      let mut writer = if compression > 0 {
-          let level = match compression {
-            1 => niffler::compression::Level::One,
-            2 => niffler::compression::Level::Two,
-            3 => niffler::compression::Level::Three,
-            4 => niffler::compression::Level::Four,
-            5 => niffler::compression::Level::Five,
-            6 => niffler::compression::Level::Six,
-            7 => niffler::compression::Level::Seven,
-            8 => niffler::compression::Level::Eight,
-            _ => niffler::compression::Level::Nine,
-          };
-
-          niffler::get_writer(Box::new(&mut buffer),
-                              niffler::compression::Format::Gzip,
-                              level)?
-      } else {
-          Box::new(&mut buffer)
-      };
-      serde_json::to_writer(&mut writer, &rsigs)?;
-    }
+    let buffer = signatures_to_buffer(&rsigs, compression)?;
 
     let b = buffer.into_boxed_slice();
     *osize = b.len();
@@ -2,7 +2,11 @@ use std::os::raw::c_char;
 use std::slice;
 use std::sync::Arc;
 
+use crate::collection::{copy_records, transform_records, RecordSigIter, SigTransform};
+use crate::ffi::manifest::SourmashManifest;
+use crate::ffi::signature::SourmashSignature;
 use crate::ffi::utils::{ForeignObject, SourmashStr};
+use crate::manifest::{Manifest, Record};
 use crate::prelude::*;
 use crate::storage::ZipStorage;
 
@@ -12,6 +16,18 @@ impl ForeignObject for SourmashZipStorage {
     type RustObject = Arc<ZipStorage>;
 }
 
+pub struct SourmashSigBatch;
+
+impl ForeignObject for SourmashSigBatch {
+    type RustObject = Vec<(Record, Vec<u8>)>;
+}
+
+pub struct SourmashSigIter;
+
+impl ForeignObject for SourmashSigIter {
+    type RustObject = RecordSigIter;
+}
+
 ffi_fn! {
 unsafe fn zipstorage_new(ptr: *const c_char, insize: usize) -> Result<*mut SourmashZipStorage> {
     let path = {
@@ -139,3 +155,161 @@ unsafe fn zipstorage_subdir(ptr: *const SourmashZipStorage) -> Result<SourmashSt
     }
 }
 }
+
+ffi_fn! {
+/// Load, transform and serialize the signatures for the given manifest rows.
+///
+/// Signatures are processed in parallel; the batch keeps them in row order.
+/// `scaled` and `num` of 0 mean no downsampling.
+#[allow(clippy::too_many_arguments)]
+unsafe fn zipstorage_transform_sigs(
+    ptr: *const SourmashZipStorage,
+    manifest_ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+    flatten: bool,
+    scaled: u32,
+    num: u32,
+    compression: u8,
+) -> Result<*mut SourmashSigBatch> {
+    let storage = SourmashZipStorage::as_rust(ptr);
+    let manifest = SourmashManifest::as_rust(manifest_ptr);
+
+    let indices = {
+        assert!(!indices_ptr.is_null());
+        slice::from_raw_parts(indices_ptr, insize)
+    };
+    let records: Vec<Record> = indices.iter().map(|&i| manifest.record(i as usize)).collect();
+
+    let mut transform = SigTransform::default();
+    transform.set_flatten(flatten);
+    if scaled != 0 {
+        transform.set_scaled(scaled);
+    }
+    if num != 0 {
+        transform.set_num(num);
+    }
+    transform.set_compression(compression);
+
+    let batch = transform_records(storage.as_ref(), &records, &transform)?;
+    Ok(SourmashSigBatch::from_rust(batch))
+}
+}
+
+ffi_fn! {
+/// Copy the signatures for the given manifest rows, decoding only if needed.
+///
+/// Gzipped members holding a single sketch are copied verbatim; see
+/// `copy_records`. The batch keeps signatures in row order.
+unsafe fn zipstorage_copy_sigs(
+    ptr: *const SourmashZipStorage,
+    manifest_ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+    compression: u8,
+) -> Result<*mut SourmashSigBatch> {
+    let storage = SourmashZipStorage::as_rust(ptr);
+    let manifest = SourmashManifest::as_rust(manifest_ptr);
+
+    let indices = {
+        assert!(!indices_ptr.is_null());
+        slice::from_raw_parts(indices_ptr, insize)
+    };
+    let records: Vec<Record> = indices.iter().map(|&i| manifest.record(i as usize)).collect();
+    let own_location: Vec<bool> = indices
+        .iter()
+        .map(|&i| manifest.has_own_location(i as usize))
+        .collect();
+
+    let batch = copy_records(storage.as_ref(), &records, &own_location, compression)?;
+    Ok(SourmashSigBatch::from_rust(batch))
+}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn sigbatch_free(ptr: *mut SourmashSigBatch) {
+    SourmashSigBatch::drop(ptr);
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn sigbatch_len(ptr: *const SourmashSigBatch) -> usize {
+    let batch = SourmashSigBatch::as_rust(ptr);
+    batch.len()
+}
+
+ffi_fn! {
+/// The serialized signature at position `i`; owned by the batch.
+unsafe fn sigbatch_data(
+    ptr: *const SourmashSigBatch,
+    i: usize,
+    size: *mut usize,
+) -> Result<*const u8> {
+    let batch = SourmashSigBatch::as_rust(ptr);
+    let data = &batch[i].1;
+    *size = data.len();
+    Ok(data.as_ptr())
+}
+}
+
+ffi_fn! {
+/// Manifest CSV for the signatures in the batch, in order.
+unsafe fn sigbatch_manifest_csv(ptr: *const SourmashSigBatch) -> Result<SourmashStr> {
+    let batch = SourmashSigBatch::as_rust(ptr);
+    let manifest: Manifest = batch
+        .iter()
+        .map(|(record, _)| record.clone())
+        .collect::<Vec<_>>()
+        .into();
+
+    let mut buffer = vec![];
+    manifest.to_writer(&mut buffer)?;
+    Ok(String::from_utf8(buffer).map_err(|e| e.utf8_error())?.into())
+}
+}
+
+ffi_fn! {
+/// Iterate over the signatures for the given manifest rows, in row order.
+///
+/// Signatures are decompressed and parsed ahead of the caller on a
+/// background thread, up to `read_ahead` at a time.
+unsafe fn zipstorage_iter_sigs(
+    ptr: *const SourmashZipStorage,
+    manifest_ptr: *const SourmashManifest,
+    indices_ptr: *const u64,
+    insize: usize,
+    read_ahead: usize,
+) -> Result<*mut SourmashSigIter> {
+    let storage = SourmashZipStorage::as_rust(ptr);
+    let manifest = SourmashManifest::as_rust(manifest_ptr);
+
+    let records: Vec<Record> = if insize == 0 {
+        vec![]
+    } else {
+        assert!(!indices_ptr.is_null());
+        slice::from_raw_parts(indices_ptr, insize)
+            .iter()
+            .map(|&i| manifest.record(i as usize))
+            .collect()
+    };
+
+    let iter = RecordSigIter::new(Arc::clone(storage), records, read_ahead);
+    Ok(SourmashSigIter::from_rust(iter))
+}
+}
+
+ffi_fn! {
+/// The next signature, or NULL when the iterator is exhausted.
+unsafe fn sigiter_next(ptr: *mut SourmashSigIter) -> Result<*mut SourmashSignature> {
+    let iter = SourmashSigIter::as_rust_mut(ptr);
+
+    match iter.next() {
+        Some(sig) => Ok(SourmashSignature::from_rust(sig?)),
+        None => Ok(std::ptr::null_mut()),
+    }
+}
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn sigiter_free(ptr: *mut SourmashSigIter) {
+    SourmashSigIter::drop(ptr);
+}
@@ -318,3 +318,24 @@ pub unsafe extern "C" fn sourmash_str_free(s: *mut SourmashStr) {
 impl ForeignObject for SourmashStr {
     type RustObject = SourmashStr;
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    #[test]
+    fn last_error_is_per_thread() {
+        unsafe { sourmash_err_clear() };
+
+        thread::spawn(|| {
+            set_last_error(Error::MismatchKSizes);
+            let code = unsafe { sourmash_err_get_last_code() };
+            assert_ne!(code as u32, SourmashErrorCode::NoError as u32);
+        })
+        .join()
+        .unwrap();
+
+        let code = unsafe { sourmash_err_get_last_code() };
+        assert_eq!(code as u32, SourmashErrorCode::NoError as u32);
+    }
+}
@@ -0,0 +1,369 @@
+//! # HyperLogLog screening index
+//!
+//! A dense matrix of HyperLogLog registers, one row per dataset in a
+//! collection, for cheap first-pass triage of a query: containment of the
+//! query in every row is estimated from the registers alone, and only the
+//! datasets above a threshold are loaded for an exact `KmerMinHash`
+//! comparison.
+
+use std::cmp::Ordering;
+use std::collections::BTreeMap;
+
+#[cfg(feature = "parallel")]
+use rayon::prelude::*;
+
+use crate::collection::CollectionSet;
+use crate::encodings::{HashFunctions, Idx};
+use crate::signature::SigsTrait;
+use crate::sketch::hyperloglog::estimators::{joint_mle, CounterType};
+use crate::sketch::hyperloglog::HyperLogLog;
+use crate::sketch::minhash::KmerMinHash;
+use crate::{Error, Result};
+
+pub struct HllScreen {
+    collection: CollectionSet,
+    p: usize,
+    q: usize,
+    ksize: usize,
+    hash_function: HashFunctions,
+    seed: u64,
+    /// `collection.len()` rows of `1 << p` registers; row `i` is dataset `i`.
+    registers: Vec<CounterType>,
+    /// Scaled of the sketch each row was built from.
+    scaled: Vec<u64>,
+}
+
+impl HllScreen {
+    /// Build the register matrix for all datasets in `collection`, using
+    /// HLLs with `1 << p` registers.
+    ///
+    /// Rows are built from the sketch hashes, a uniform sample of each
+    /// dataset, so they are compared with the same sample of the query.
+    /// Companion HLLs (counting every k-mer) aren't used: compared with a
+    /// sampled query, their estimates get noisier with the dataset size.
+    pub fn from_collection(collection: CollectionSet, p: usize) -> Result<Self> {
+        if collection.is_empty() {
+            return Err(Error::Internal {
+                message: "HLL screening needs a non-empty collection".into(),
+            });
+        }
+        let first_sig = collection.sig_for_dataset(0)?;
+        let first = first_sig.minhash().ok_or_else(|| Error::Internal {
+            message: "HLL screening needs a MinHash sketch".into(),
+        })?;
+
+        let (ksize, hash_function, seed) = (first.ksize(), first.hash_function(), first.seed());
+
+        let template = HyperLogLog::new(p, ksize)?.with_hash_function(hash_function.clone(), seed);
+        let row_len = template.size();
+        let mut registers = vec![0; collection.len() * row_len];
+        let mut scaled = vec![0; collection.len()];
+
+        #[cfg(feature = "parallel")]
+        let rows = registers.par_chunks_mut(row_len).zip(scaled.par_iter_mut());
+
+        #[cfg(not(feature = "parallel"))]
+        let rows = registers.chunks_mut(row_len).zip(scaled.iter_mut());
+
+        rows.enumerate()
+            .try_for_each(|(dataset_id, (row, row_scaled))| {
+                let sig = collection.sig_for_dataset(dataset_id as Idx)?;
+                let mh = sig.minhash().ok_or_else(|| Error::Internal {
+                    message: "HLL screening needs a MinHash sketch".into(),
+                })?;
+                // every row must hash like the first one
+                check_compatible(mh, ksize, &hash_function, seed)?;
+
+                let hll = hll_from_hashes(&template, mh.mins_slice())?;
+                row.copy_from_slice(&hll.registers());
+                *row_scaled = mh.scaled();
+                Ok::<(), Error>(())
+            })?;
+
+        Ok(Self {
+            p,
+            q: template.q(),
+            ksize,
+            hash_function,
+            seed,
+            registers,
+            scaled,
+            collection,
+        })
+    }
+
+    pub fn collection(&self) -> &CollectionSet {
+        &self.collection
+    }
+
+    pub fn p(&self) -> usize {
+        self.p
+    }
+
+    pub fn len(&self) -> usize {
+        self.collection.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.collection.is_empty()
+    }
+
+    /// Registers for dataset `dataset_id`.
+    pub fn row(&self, dataset_id: Idx) -> &[CounterType] {
+        let row_len = 1 << self.p;
+        let start = dataset_id as usize * row_len;
+        &self.registers[start..start + row_len]
+    }
+
+    fn check_query(&self, query: &KmerMinHash) -> Result<()> {
+        check_compatible(query, self.ksize, &self.hash_function, self.seed)
+    }
+
+    /// Estimated containment of `query` in every dataset, in dataset order.
+    ///
+    /// The query is downsampled to the scaled of each row (if coarser than
+    /// its own), so both sides sample the same hashes.
+    pub fn containments(&self, query: &KmerMinHash) -> Result<Vec<f64>> {
+        self.check_query(query)?;
+        let template = HyperLogLog::new(self.p, self.ksize)?
+            .with_hash_function(self.hash_function.clone(), self.seed);
+
+        // one query HLL for each distinct row scaled
+        let mut query_registers = BTreeMap::new();
+        for &scaled in &self.scaled {
+            if query_registers.contains_key(&scaled) {
+                continue;
+            }
+            let mins = if scaled > query.scaled() {
+                query.downsample_scaled_view(scaled).mins()
+            } else {
+                query.mins_slice()
+            };
+            let hll = hll_from_hashes(&template, mins)?;
+            query_registers.insert(scaled, hll.registers().into_owned());
+        }
+        let row_len = template.size();
+
+        #[cfg(feature = "parallel")]
+        let rows = self
+            .registers
+            .par_chunks(row_len)
+            .zip(self.scaled.par_iter());
+
+        #[cfg(not(feature = "parallel"))]
+        let rows = self.registers.chunks(row_len).zip(self.scaled.iter());
+
+        Ok(rows
+            .map(|(row, scaled)| {
+                let (only_query, _, intersection) =
+                    joint_mle(&query_registers[scaled], row, self.p, self.q);
+                let query_size = only_query + intersection;
+                if query_size == 0 {
+                    0.0
+                } else {
+                    intersection as f64 / query_size as f64
+                }
+            })
+            .collect())
+    }
+
+    /// Datasets with an estimated containment of `query` of at least
+    /// `threshold`, as `(dataset_id, estimate)` sorted by decreasing estimate.
+    pub fn candidates(&self, query: &KmerMinHash, threshold: f64) -> Result<Vec<(Idx, f64)>> {
+        let mut candidates: Vec<(Idx, f64)> = self
+            .containments(query)?
+            .into_iter()
+            .enumerate()
+            .filter(|(_, containment)| *containment >= threshold)
+            .map(|(dataset_id, containment)| (dataset_id as Idx, containment))
+            .collect();
+        candidates.sort_by(by_decreasing_containment);
+        Ok(candidates)
+    }
+
+    /// Screen with `candidates(query, screen_threshold)`, then load the
+    /// candidates and keep those with an exact containment of `query` of
+    /// at least `threshold`, sorted by decreasing containment.
+    ///
+    /// `screen_threshold` is usually a bit lower than `threshold`, to allow
+    /// for the HLL estimation error.
+    pub fn search_containment(
+        &self,
+        query: &KmerMinHash,
+        screen_threshold: f64,
+        threshold: f64,
+    ) -> Result<Vec<(Idx, f64)>> {
+        let candidates = self.candidates(query, screen_threshold)?;
+
+        #[cfg(feature = "parallel")]
+        let candidates = candidates.into_par_iter();
+
+        #[cfg(not(feature = "parallel"))]
+        let candidates = candidates.into_iter();
+
+        let mut matches = candidates
+            .map(|(dataset_id, _)| {
+                let sig = self.collection.sig_for_dataset(dataset_id)?;
+                let mh = sig.minhash().ok_or_else(|| Error::Internal {
+                    message: "HLL screening needs a MinHash sketch".into(),
+                })?;
+                let stats = query.comparison_stats(mh, true)?;
+                Ok((dataset_id, stats.containment()))
+            })
+            .filter(|result: &Result<(Idx, f64)>| {
+                !matches!(result, Ok((_, containment)) if *containment < threshold)
+            })
+            .collect::<Result<Vec<_>>>()?;
+        matches.sort_by(by_decreasing_containment);
+        Ok(matches)
+    }
+}
+
+/// Check that `mh` hashes k-mers like the screen: same ksize, hash
+/// function and seed.
+fn check_compatible(
+    mh: &KmerMinHash,
+    ksize: usize,
+    hash_function: &HashFunctions,
+    seed: u64,
+) -> Result<()> {
+    if mh.ksize() != ksize {
+        return Err(Error::MismatchKSizes);
+    }
+    if mh.hash_function() != *hash_function {
+        return Err(Error::MismatchDNAProt);
+    }
+    if mh.seed() != seed {
+        return Err(Error::MismatchSeed);
+    }
+    Ok(())
+}
+
+fn hll_from_hashes(template: &HyperLogLog, hashes: &[u64]) -> Result<HyperLogLog> {
+    let mut hll = template.clone();
+    hll.add_many(hashes)?;
+    Ok(hll)
+}
+
+fn by_decreasing_containment(a: &(Idx, f64), b: &(Idx, f64)) -> Ordering {
+    b.1.partial_cmp(&a.1)
+        .unwrap_or(Ordering::Equal)
+        .then(a.0.cmp(&b.0))
+}
+
+#[cfg(test)]
+mod test {
+    use camino::Utf8PathBuf as PathBuf;
+    use std::fs::File;
+    use std::io::BufReader;
+
+    use super::HllScreen;
+
+    use crate::collection::Collection;
+    use crate::encodings::Idx;
+    use crate::signature::Signature;
+    use crate::sketch::minhash::KmerMinHash;
+    use crate::sketch::Sketch;
+    use crate::Error;
+
+    fn load_sigs(path: &str) -> Vec<Signature> {
+        let mut filename = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        filename.push(path);
+        let reader = BufReader::new(File::open(filename).unwrap());
+        serde_json::from_reader(reader).expect("Loading error")
+    }
+
+    #[test]
+    fn hll_screen_matches_exact_containment() {
+        let sigs = load_sigs("../../tests/test-data/47+63-multisig.sig");
+        let collection = Collection::from_sigs(sigs).unwrap().try_into().unwrap();
+        let screen = HllScreen::from_collection(collection, 12).unwrap();
+        assert_eq!(screen.len(), 6);
+
+        let query = load_sigs("../../tests/test-data/47+63.fa.sig").swap_remove(0);
+        let query = query.minhash().unwrap();
+
+        let estimates = screen.containments(query).unwrap();
+        let mut exact = vec![];
+        for (dataset_id, estimate) in estimates.iter().enumerate() {
+            let sig = screen
+                .collection()
+                .sig_for_dataset(dataset_id as Idx)
+                .unwrap();
+            let stats = query
+                .comparison_stats(sig.minhash().unwrap(), true)
+                .unwrap();
+            assert!(
+                (estimate - stats.containment()).abs() < 0.1,
+                "{} {}",
+                estimate,
+                stats.containment()
+            );
+            exact.push(stats.containment());
+        }
+
+        // the two genomes pass the screen, the plasmids don't
+        let candidates = screen.candidates(query, 0.3).unwrap();
+        let mut ids: Vec<Idx> = candidates.iter().map(|(id, _)| *id).collect();
+        ids.sort_unstable();
+        assert_eq!(ids, vec![0, 2]);
+
+        let matches = screen.search_containment(query, 0.3, 0.4).unwrap();
+        assert_eq!(matches.len(), 2);
+        for (dataset_id, containment) in matches {
+            assert_eq!(containment, exact[dataset_id as usize]);
+        }
+    }
+
+    #[test]
+    fn hll_screen_rejects_incompatible_rows() {
+        // same ksize and moltype in the manifest, but a different seed
+        let mut sigs = load_sigs("../../tests/test-data/47+63-multisig.sig");
+        let mh = sigs[1].minhash().unwrap();
+        let mut reseeded = KmerMinHash::new(
+            mh.scaled(),
+            mh.ksize() as u32,
+            mh.hash_function(),
+            mh.seed() + 1,
+            false,
+            0,
+        );
+        reseeded.add_many(&mh.mins()).unwrap();
+        sigs[1].reset_sketches();
+        sigs[1].push(Sketch::MinHash(reseeded));
+
+        let collection = Collection::from_sigs(sigs).unwrap().try_into().unwrap();
+        let res = HllScreen::from_collection(collection, 12);
+        assert!(matches!(res, Err(Error::MismatchSeed)));
+    }
+
+    #[test]
+    fn hll_screen_downsamples_query_to_row_scaled() {
+        // one genome at a coarser scaled than the query
+        let mut sigs = load_sigs("../../tests/test-data/47+63-multisig.sig");
+        let coarse = sigs[2].minhash().unwrap().downsample_scaled(5000).unwrap();
+        sigs[2].reset_sketches();
+        sigs[2].push(Sketch::MinHash(coarse));
+
+        let collection = Collection::from_sigs(sigs).unwrap().try_into().unwrap();
+        let screen = HllScreen::from_collection(collection, 12).unwrap();
+
+        let query = load_sigs("../../tests/test-data/47+63.fa.sig").swap_remove(0);
+        let query = query.minhash().unwrap();
+
+        let estimates = screen.containments(query).unwrap();
+        for dataset_id in [0, 2] {
+            let sig = screen.collection().sig_for_dataset(dataset_id).unwrap();
+            let stats = query
+                .comparison_stats(sig.minhash().unwrap(), true)
+                .unwrap();
+            let estimate = estimates[dataset_id as usize];
+            assert!(
+                (estimate - stats.containment()).abs() < 0.1,
+                "{} {}",
+                estimate,
+                stats.containment()
+            );
+        }
+    }
+}
@@ -3,6 +3,7 @@
 //! An index organizes signatures to allow for fast similarity search.
 //! Some indices also support containment searches.
 
+pub mod hll_screen;
 pub mod linear;
 
 #[cfg(not(target_arch = "wasm32"))]
@@ -15,7 +16,6 @@ use std::path::Path;
 
 use getset::{CopyGetters, Getters, Setters};
 use serde::{Deserialize, Serialize};
-use stats::{median, stddev};
 use typed_builder::TypedBuilder;
 
 use crate::ani_utils::{ani_ci_from_containment, ani_from_containment};
@@ -26,6 +26,7 @@ use crate::selection::Selection;
 use crate::signature::SigsTrait;
 use crate::sketch::minhash::KmerMinHash;
 use crate::storage::SigStore;
+use crate::Error;
 use crate::Result;
 
 #[derive(TypedBuilder, CopyGetters, Getters, Setters, Serialize, Deserialize, Debug, PartialEq)]
@@ -208,7 +209,7 @@ where
 #[allow(clippy::too_many_arguments)]
 pub fn calculate_gather_stats(
     orig_query: &KmerMinHash,
-    query: KmerMinHash,
+    query: &KmerMinHash,
     match_sig: SigStore,
     match_size: usize,
     gather_result_rank: usize,
@@ -224,7 +225,7 @@ pub fn calculate_gather_stats(
     let remaining_bp = (query.size() - match_size) * query.scaled() as usize;
 
     // stats for this match vs original query
-    let (intersect_orig, _) = match_mh.intersection_size(orig_query).unwrap();
+    let intersect_orig = match_mh.count_common(orig_query, false)?;
     let intersect_bp = (match_mh.scaled() * intersect_orig) as usize;
     let f_orig_query = intersect_orig as f64 / orig_query.size() as f64;
     let f_match_orig = intersect_orig as f64 / match_mh.size() as f64;
@@ -281,22 +282,18 @@ pub fn calculate_gather_stats(
     // If abundance, calculate abund-related metrics (vs current query)
     if calc_abund_stats {
         // take abunds from subtracted query
-        let (abunds, unique_weighted_found) = match match_mh.inflated_abundances(&query) {
-            Ok((abunds, unique_weighted_found)) => (abunds, unique_weighted_found),
-            Err(e) => {
-                return Err(e);
-            }
-        };
-
-        n_unique_weighted_found = unique_weighted_found as usize;
+        if !query.track_abundance() {
+            return Err(Error::NeedsAbundanceTracking);
+        }
+        let stats = query.comparison_stats(match_mh, false)?;
+
+        n_unique_weighted_found = stats.self_common_abund as usize;
         sum_total_weighted_found = sum_weighted_found + n_unique_weighted_found;
         f_unique_weighted = n_unique_weighted_found as f64 / total_weighted_hashes as f64;
 
-        average_abund = n_unique_weighted_found as f64 / abunds.len() as f64;
-
-        // todo: try to avoid clone for these?
-        median_abund = median(abunds.iter().cloned()).unwrap();
-        std_abund = stddev(abunds.iter().cloned());
+        average_abund = stats.mean_abund;
+        median_abund = stats.median_abund;
+        std_abund = stats.std_abund;
     }
 
     let result = GatherResult::builder()
@@ -386,7 +383,7 @@ mod test_calculate_gather_stats {
         let calc_ani_ci = false;
         let result = calculate_gather_stats(
             &orig_query,
-            query,
+            &query,
             match_sig.into(),
             match_size,
             gather_result_rank,
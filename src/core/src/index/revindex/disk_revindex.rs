@@ -17,7 +17,7 @@ use crate::index::revindex::{
 use crate::index::{calculate_gather_stats, GatherResult, SigCounter};
 use crate::manifest::Manifest;
 use crate::prelude::*;
-use crate::sketch::minhash::{KmerMinHash, KmerMinHashBTree};
+use crate::sketch::minhash::KmerMinHash;
 use crate::sketch::Sketch;
 use crate::storage::{InnerStorage, Storage};
 use crate::Result;
@@ -311,7 +311,7 @@ impl RevIndexOps for RevIndex {
     ) -> Result<Vec<GatherResult>> {
         let mut match_size = usize::max_value();
         let mut matches = vec![];
-        let mut query = KmerMinHashBTree::from(orig_query.clone());
+        let mut query = orig_query.clone();
         let mut sum_weighted_found = 0;
         let _selection = selection.unwrap_or_else(|| self.collection.selection());
         let mut orig_query_ds = orig_query.clone();
@@ -340,8 +340,8 @@ impl RevIndexOps for RevIndex {
 
             // get downsampled minhashes for comparison.
             let match_mh = match_sig.minhash().unwrap().clone();
-            query = query.downsample_scaled(match_mh.scaled())?;
-            orig_query_ds = orig_query_ds.downsample_scaled(match_mh.scaled())?;
+            query.downsample_scaled_in_place(match_mh.scaled());
+            orig_query_ds.downsample_scaled_in_place(match_mh.scaled());
 
             // just calculate essentials here
             let gather_result_rank = matches.len();
@@ -349,7 +349,7 @@ impl RevIndexOps for RevIndex {
             // Calculate stats
             let gather_result = calculate_gather_stats(
                 &orig_query_ds,
-                KmerMinHash::from(query.clone()),
+                &query,
                 match_sig,
                 match_size,
                 gather_result_rank,
@@ -367,7 +367,7 @@ impl RevIndexOps for RevIndex {
             // Prepare counter for finding the next match by decrementing
             // all hashes found in the current match in other datasets
             // TODO: not used at the moment, so just skip.
-            query.remove_many(match_mh.iter_mins().copied())?; // is there a better way?
+            query.remove_many_sorted(match_mh.mins_slice())?;
 
             // TODO: Use HashesToColors here instead. If not initialized,
             //       build it.
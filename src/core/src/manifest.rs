@@ -1,3 +1,4 @@
+use std::collections::HashMap;
 use std::fs::File;
 use std::io::{BufRead, BufReader, Read, Write};
 use std::ops::Deref;
@@ -11,7 +12,9 @@ use serde::{Deserialize, Serialize};
 
 use crate::encodings::HashFunctions;
 use crate::prelude::*;
+use crate::selection::{PickStyle, PicklistMatcher};
 use crate::signature::SigsTrait;
+use crate::sketch::minhash::KmerMinHash;
 use crate::sketch::Sketch;
 use crate::Result;
 
@@ -59,16 +62,20 @@ fn to_bool<'de, D>(deserializer: D) -> std::result::Result<bool, D::Error>
 where
     D: de::Deserializer<'de>,
 {
-    match String::deserialize(deserializer)?
-        .to_ascii_lowercase()
-        .as_ref()
-    {
-        "0" | "false" | "False" => Ok(false),
-        "1" | "true" | "True" => Ok(true),
-        other => Err(de::Error::invalid_value(
-            de::Unexpected::Str(other),
+    let value = String::deserialize(deserializer)?;
+    parse_bool(&value).ok_or_else(|| {
+        de::Error::invalid_value(
+            de::Unexpected::Str(&value),
             &"0/1, true/false, True/False are the only supported values",
-        )),
+        )
+    })
+}
+
+fn parse_bool(value: &str) -> Option<bool> {
+    match value.to_ascii_lowercase().as_ref() {
+        "0" | "false" => Some(false),
+        "1" | "true" => Some(true),
+        _ => None,
     }
 }
 
@@ -134,6 +141,21 @@ impl Record {
         self.moltype.as_str().try_into().unwrap()
     }
 
+    /// A copy of this record describing `mh` instead, e.g. after the
+    /// sketch was downsampled or flattened.
+    pub fn with_minhash(&self, mh: &KmerMinHash) -> Record {
+        let md5 = mh.md5sum();
+        Record {
+            md5short: md5[0..8].into(),
+            md5,
+            num: mh.num(),
+            scaled: mh.scaled(),
+            n_hashes: mh.size(),
+            with_abundance: mh.track_abundance(),
+            ..self.clone()
+        }
+    }
+
     pub fn check_compatible(&self, other: &Record) -> Result<()> {
         /*
         if self.num != other.num {
@@ -202,7 +224,8 @@ impl Manifest {
 
 impl Select for Manifest {
     fn select(self, selection: &Selection) -> Result<Self> {
-        let rows = self.records.iter().filter(|row| {
+        // we own the records, so move the selected ones instead of cloning.
+        let rows = self.records.into_iter().filter(|row| {
             let mut valid = true;
             valid = if let Some(ksize) = selection.ksize() {
                 row.ksize == ksize
@@ -234,7 +257,7 @@ impl Select for Manifest {
         });
 
         Ok(Manifest {
-            records: rows.cloned().collect(),
+            records: rows.collect(),
         })
 
         /*
@@ -323,6 +346,473 @@ impl Deref for Manifest {
     }
 }
 
+/// A column of strings, stored as one buffer plus offsets.
+///
+/// Values are interned: each distinct value is stored once, and rows refer
+/// to it by id. Repeated values (moltypes, filenames, locations shared by
+/// many sketches) take no extra space, and comparing against a value only
+/// needs an id comparison per row.
+#[derive(Debug, Default, Clone)]
+struct StrColumn {
+    data: String,
+    offsets: Vec<usize>,
+    ids: Vec<u32>,
+    /// number of rows holding each distinct value.
+    counts: Vec<u32>,
+}
+
+impl StrColumn {
+    fn value(&self, id: u32) -> &str {
+        let id = id as usize;
+        &self.data[self.offsets[id]..self.offsets[id + 1]]
+    }
+
+    fn get(&self, row: usize) -> &str {
+        self.value(self.ids[row])
+    }
+
+    /// How many rows hold the same value as `row`.
+    fn count(&self, row: usize) -> u32 {
+        self.counts[self.ids[row] as usize]
+    }
+
+    /// ids of all distinct values for which `pred` is true.
+    fn find_ids<P: Fn(&str) -> bool>(&self, pred: P) -> Vec<u32> {
+        (0..self.offsets.len().saturating_sub(1) as u32)
+            .filter(|&id| pred(self.value(id)))
+            .collect()
+    }
+}
+
+#[derive(Default)]
+struct StrColumnBuilder {
+    column: StrColumn,
+    lookup: HashMap<String, u32>,
+}
+
+impl StrColumnBuilder {
+    fn new() -> Self {
+        let mut builder = Self::default();
+        builder.column.offsets.push(0);
+        builder
+    }
+
+    fn push(&mut self, value: &str) {
+        let id = match self.lookup.get(value) {
+            Some(id) => {
+                self.column.counts[*id as usize] += 1;
+                *id
+            }
+            None => {
+                let id = self.lookup.len() as u32;
+                self.column.data.push_str(value);
+                self.column.offsets.push(self.column.data.len());
+                self.column.counts.push(1);
+                self.lookup.insert(value.into(), id);
+                id
+            }
+        };
+        self.column.ids.push(id);
+    }
+
+    fn finish(self) -> StrColumn {
+        self.column
+    }
+}
+
+/// A borrowed manifest row, used to parse CSV without allocating per row.
+#[derive(Deserialize)]
+struct RawRecord<'a> {
+    internal_location: &'a str,
+    md5: &'a str,
+    ksize: u32,
+    moltype: &'a str,
+    num: u32,
+    scaled: u64,
+    n_hashes: usize,
+    #[serde(deserialize_with = "to_bool_borrowed")]
+    with_abundance: bool,
+    name: &'a str,
+    filename: &'a str,
+}
+
+fn to_bool_borrowed<'de, D>(deserializer: D) -> std::result::Result<bool, D::Error>
+where
+    D: de::Deserializer<'de>,
+{
+    let value = <&str>::deserialize(deserializer)?;
+    parse_bool(value).ok_or_else(|| {
+        de::Error::invalid_value(
+            de::Unexpected::Str(value),
+            &"0/1, true/false, True/False are the only supported values",
+        )
+    })
+}
+
+/// A manifest stored column-wise (struct-of-arrays), with interned strings.
+///
+/// Selection works on the columns and returns the indices of the matching
+/// rows, so nothing is copied; use `record` to materialize individual rows.
+#[derive(Debug, Default, Clone)]
+pub struct ColumnarManifest {
+    internal_location: StrColumn,
+    md5: StrColumn,
+    ksize: Vec<u32>,
+    moltype: StrColumn,
+    num: Vec<u32>,
+    scaled: Vec<u64>,
+    n_hashes: Vec<usize>,
+    with_abundance: Vec<bool>,
+    name: StrColumn,
+    filename: StrColumn,
+}
+
+#[derive(Default)]
+struct ColumnarManifestBuilder {
+    internal_location: StrColumnBuilder,
+    md5: StrColumnBuilder,
+    ksize: Vec<u32>,
+    moltype: StrColumnBuilder,
+    num: Vec<u32>,
+    scaled: Vec<u64>,
+    n_hashes: Vec<usize>,
+    with_abundance: Vec<bool>,
+    name: StrColumnBuilder,
+    filename: StrColumnBuilder,
+}
+
+impl ColumnarManifestBuilder {
+    fn new() -> Self {
+        Self {
+            internal_location: StrColumnBuilder::new(),
+            md5: StrColumnBuilder::new(),
+            moltype: StrColumnBuilder::new(),
+            name: StrColumnBuilder::new(),
+            filename: StrColumnBuilder::new(),
+            ..Default::default()
+        }
+    }
+
+    #[allow(clippy::too_many_arguments)]
+    fn push(
+        &mut self,
+        internal_location: &str,
+        md5: &str,
+        ksize: u32,
+        moltype: &str,
+        num: u32,
+        scaled: u64,
+        n_hashes: usize,
+        with_abundance: bool,
+        name: &str,
+        filename: &str,
+    ) {
+        self.internal_location.push(internal_location);
+        self.md5.push(md5);
+        self.ksize.push(ksize);
+        self.moltype.push(moltype);
+        self.num.push(num);
+        self.scaled.push(scaled);
+        self.n_hashes.push(n_hashes);
+        self.with_abundance.push(with_abundance);
+        self.name.push(name);
+        self.filename.push(filename);
+    }
+
+    fn finish(self) -> ColumnarManifest {
+        ColumnarManifest {
+            internal_location: self.internal_location.finish(),
+            md5: self.md5.finish(),
+            ksize: self.ksize,
+            moltype: self.moltype.finish(),
+            num: self.num,
+            scaled: self.scaled,
+            n_hashes: self.n_hashes,
+            with_abundance: self.with_abundance,
+            name: self.name.finish(),
+            filename: self.filename.finish(),
+        }
+    }
+}
+
+impl ColumnarManifest {
+    /// Load a manifest CSV directly into columns.
+    pub fn from_reader<R: Read>(rdr: R) -> Result<Self> {
+        let mut rdr = csv::ReaderBuilder::new()
+            .comment(Some(b'#'))
+            .from_reader(rdr);
+        let headers = rdr.headers()?.clone();
+
+        let mut builder = ColumnarManifestBuilder::new();
+        let mut row = csv::StringRecord::new();
+        while rdr.read_record(&mut row)? {
+            let r: RawRecord = row.deserialize(Some(&headers))?;
+            builder.push(
+                r.internal_location,
+                r.md5,
+                r.ksize,
+                r.moltype,
+                r.num,
+                r.scaled,
+                r.n_hashes,
+                r.with_abundance,
+                r.name,
+                r.filename,
+            );
+        }
+
+        Ok(builder.finish())
+    }
+
+    pub fn len(&self) -> usize {
+        self.ksize.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.ksize.is_empty()
+    }
+
+    pub fn internal_location(&self, row: usize) -> &str {
+        self.internal_location.get(row)
+    }
+
+    pub fn md5(&self, row: usize) -> &str {
+        self.md5.get(row)
+    }
+
+    /// Is `row` the only row stored at its internal location?
+    pub fn has_own_location(&self, row: usize) -> bool {
+        self.internal_location.count(row) == 1
+    }
+
+    pub fn name(&self, row: usize) -> &str {
+        self.name.get(row)
+    }
+
+    pub fn ksize(&self, row: usize) -> u32 {
+        self.ksize[row]
+    }
+
+    pub fn num(&self, row: usize) -> u32 {
+        self.num[row]
+    }
+
+    pub fn scaled(&self, row: usize) -> u64 {
+        self.scaled[row]
+    }
+
+    pub fn n_hashes(&self, row: usize) -> usize {
+        self.n_hashes[row]
+    }
+
+    pub fn with_abundance(&self, row: usize) -> bool {
+        self.with_abundance[row]
+    }
+
+    /// Values of the string column `column` for `rows`.
+    ///
+    /// Returns the distinct values, in order of first appearance, and the
+    /// index of each row's value in them.
+    pub fn str_column(&self, column: &str, rows: &[usize]) -> Result<(Vec<&str>, Vec<u32>)> {
+        let column = match column {
+            "internal_location" => &self.internal_location,
+            "md5" => &self.md5,
+            "moltype" => &self.moltype,
+            "name" => &self.name,
+            "filename" => &self.filename,
+            _ => {
+                return Err(crate::Error::Internal {
+                    message: format!("unknown manifest string column '{}'", column),
+                })
+            }
+        };
+
+        let mut values = vec![];
+        let mut positions = HashMap::new();
+        let mut ids = Vec::with_capacity(rows.len());
+        for &row in rows {
+            let id = column.ids[row];
+            let pos = *positions.entry(id).or_insert_with(|| {
+                values.push(column.value(id));
+                (values.len() - 1) as u32
+            });
+            ids.push(pos);
+        }
+        Ok((values, ids))
+    }
+
+    /// Build the `Record` for a single row.
+    pub fn record(&self, row: usize) -> Record {
+        let md5 = self.md5.get(row);
+        Record {
+            internal_location: self.internal_location.get(row).into(),
+            md5: md5.into(),
+            md5short: md5.get(0..8).unwrap_or(md5).into(),
+            ksize: self.ksize[row],
+            moltype: self.moltype.get(row).into(),
+            num: self.num[row],
+            scaled: self.scaled[row],
+            n_hashes: self.n_hashes[row],
+            with_abundance: self.with_abundance[row],
+            name: self.name.get(row).into(),
+            filename: self.filename.get(row).into(),
+        }
+    }
+
+    /// Indices of the rows for which `pred` is true, in manifest order.
+    ///
+    /// If `indices` is given, only those rows are considered.
+    fn filter_indices<P: Fn(usize) -> bool + Sync>(
+        &self,
+        indices: Option<&[usize]>,
+        pred: P,
+    ) -> Vec<usize> {
+        let all: Vec<usize>;
+        let indices = match indices {
+            Some(indices) => indices,
+            None => {
+                all = (0..self.len()).collect();
+                &all
+            }
+        };
+
+        #[cfg(feature = "parallel")]
+        let selected: Vec<usize> = indices.par_iter().copied().filter(|&i| pred(i)).collect();
+
+        #[cfg(not(feature = "parallel"))]
+        let selected: Vec<usize> = indices.iter().copied().filter(|&i| pred(i)).collect();
+
+        selected
+    }
+
+    /// Indices of the rows matching `selection`, in manifest order.
+    ///
+    /// Same rules as `Manifest::select`, except that moltype is matched
+    /// exactly against the moltype column, as the Python manifest does. If
+    /// `indices` is given, only those rows are considered, so selections can
+    /// be chained without copies.
+    pub fn select_indices(&self, indices: Option<&[usize]>, selection: &Selection) -> Vec<usize> {
+        // moltype is interned: resolve the matching ids once.
+        let moltype_ids = selection.moltype().map(|moltype| {
+            let moltype = moltype.to_string();
+            self.moltype.find_ids(|value| value == moltype)
+        });
+
+        self.filter_indices(indices, |i| {
+            if let Some(ksize) = selection.ksize() {
+                if self.ksize[i] != ksize {
+                    return false;
+                }
+            }
+            if let Some(abund) = selection.abund() {
+                if self.with_abundance[i] != abund {
+                    return false;
+                }
+            }
+            if let Some(ids) = &moltype_ids {
+                if !ids.contains(&self.moltype.ids[i]) {
+                    return false;
+                }
+            }
+            if let Some(scaled) = selection.scaled() {
+                // num sigs have scaled = 0, don't include them
+                if self.scaled[i] == 0 || self.scaled[i] > scaled as u64 {
+                    return false;
+                }
+            }
+            if let Some(num) = selection.num() {
+                if self.num[i] != num {
+                    return false;
+                }
+            }
+            true
+        })
+    }
+
+    /// Indices of the rows holding scaled sketches, of any scaled value, in
+    /// manifest order.
+    ///
+    /// If `indices` is given, only those rows are considered.
+    pub fn select_scaled(&self, indices: Option<&[usize]>) -> Vec<usize> {
+        self.filter_indices(indices, |i| self.scaled[i] != 0 && self.num[i] == 0)
+    }
+
+    /// Indices of the rows passing `picklist`, in manifest order.
+    ///
+    /// If `indices` is given, only those rows are considered. For include
+    /// picklists, the matched values are marked as found in `picklist`.
+    pub fn select_picklist(
+        &self,
+        indices: Option<&[usize]>,
+        picklist: &mut PicklistMatcher,
+    ) -> Vec<usize> {
+        let include = picklist.pickstyle() == PickStyle::Include;
+        let matcher = &*picklist;
+        let check = |&i: &usize| {
+            let id = matcher.lookup(self.name.get(i), self.md5.get(i));
+            match (include, id) {
+                (true, Some(id)) => Some((i, id)),
+                (false, None) => Some((i, 0)),
+                _ => None,
+            }
+        };
+
+        let all: Vec<usize>;
+        let indices = match indices {
+            Some(indices) => indices,
+            None => {
+                all = (0..self.len()).collect();
+                &all
+            }
+        };
+
+        #[cfg(feature = "parallel")]
+        let selected: Vec<(usize, u32)> = indices.par_iter().filter_map(check).collect();
+
+        #[cfg(not(feature = "parallel"))]
+        let selected: Vec<(usize, u32)> = indices.iter().filter_map(check).collect();
+
+        if include {
+            picklist.mark_found(selected.iter().map(|(_, id)| *id));
+        }
+        selected.into_iter().map(|(i, _)| i).collect()
+    }
+
+    /// Write the given rows as a manifest CSV.
+    pub fn to_writer<W: Write>(&self, indices: &[usize], mut wtr: W) -> Result<()> {
+        wtr.write_all(b"# SOURMASH-MANIFEST-VERSION: 1.0\n")?;
+
+        let mut wtr = csv::Writer::from_writer(wtr);
+
+        for &i in indices {
+            wtr.serialize(self.record(i))?;
+        }
+
+        Ok(())
+    }
+}
+
+impl From<&Manifest> for ColumnarManifest {
+    fn from(manifest: &Manifest) -> Self {
+        let mut builder = ColumnarManifestBuilder::new();
+        for r in manifest.iter() {
+            builder.push(
+                r.internal_location.as_str(),
+                &r.md5,
+                r.ksize,
+                &r.moltype,
+                r.num,
+                r.scaled,
+                r.n_hashes,
+                r.with_abundance,
+                &r.name,
+                &r.filename,
+            );
+        }
+        builder.finish()
+    }
+}
+
 #[cfg(test)]
 mod test {
     use camino::Utf8PathBuf as PathBuf;
@@ -330,10 +820,10 @@ mod test {
     use std::io::Write;
     use tempfile::TempDir;
 
-    use super::Manifest;
+    use super::{ColumnarManifest, Manifest};
     use crate::collection::Collection;
     use crate::encodings::HashFunctions;
-    use crate::selection::{Select, Selection};
+    use crate::selection::{PickColumn, PickStyle, PicklistMatcher, Select, Selection};
 
     #[test]
     fn manifest_from_pathlist() {
@@ -479,4 +969,104 @@ mod test {
         let scaled100 = manifest.select(&selection).unwrap();
         assert_eq!(scaled100.len(), 6);
     }
+
+    #[test]
+    fn columnar_manifest_selection() {
+        let base_path = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        let zipfile = base_path.join("../../tests/test-data/prot/all.zip");
+
+        let collection = Collection::from_zipfile(&zipfile).unwrap();
+        let manifest = ColumnarManifest::from(collection.manifest());
+        assert_eq!(manifest.len(), collection.manifest().len());
+
+        // round-trip through CSV
+        let all: Vec<usize> = (0..manifest.len()).collect();
+        let mut buffer = vec![];
+        manifest.to_writer(&all, &mut buffer).unwrap();
+        let manifest = ColumnarManifest::from_reader(&buffer[..]).unwrap();
+        assert_eq!(manifest.len(), collection.manifest().len());
+        for (i, record) in collection.manifest().iter().enumerate() {
+            assert_eq!(&manifest.record(i), record);
+        }
+
+        let mut selection = Selection::default();
+        selection.set_ksize(19);
+        let ksize19 = manifest.select_indices(None, &selection);
+        assert_eq!(ksize19.len(), 6);
+
+        selection.set_moltype(HashFunctions::Murmur64Protein);
+        let protein_only = manifest.select_indices(None, &selection);
+        assert_eq!(protein_only.len(), 2);
+
+        // selecting within a previous selection
+        let mut selection = Selection::default();
+        selection.set_moltype(HashFunctions::Murmur64Protein);
+        let protein_only2 = manifest.select_indices(Some(&ksize19), &selection);
+        assert_eq!(protein_only, protein_only2);
+
+        let mut selection = Selection::default();
+        selection.set_scaled(100);
+        let scaled100 = manifest.select_indices(None, &selection);
+        assert_eq!(scaled100.len(), 6);
+        assert_eq!(manifest.select_scaled(None).len(), manifest.len());
+
+        // moltype is matched exactly
+        let mut selection = Selection::default();
+        selection.set_moltype(HashFunctions::Custom("PROTEIN".into()));
+        assert!(manifest.select_indices(None, &selection).is_empty());
+
+        // string columns come back as distinct values plus per-row ids
+        let (values, ids) = manifest.str_column("moltype", &protein_only).unwrap();
+        assert_eq!(values, vec!["protein"]);
+        assert_eq!(ids, vec![0; protein_only.len()]);
+        assert!(manifest.str_column("nope", &all).is_err());
+    }
+
+    #[test]
+    fn columnar_manifest_select_large_scaled() {
+        let base_path = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        let zipfile = base_path.join("../../tests/test-data/prot/all.zip");
+        let collection = Collection::from_zipfile(&zipfile).unwrap();
+
+        let records: Vec<_> = collection
+            .manifest()
+            .iter()
+            .map(|r| {
+                let mut r = r.clone();
+                r.scaled = u64::from(u32::MAX) + 1;
+                r
+            })
+            .collect();
+        let manifest = ColumnarManifest::from(&Manifest::from(records));
+        assert_eq!(manifest.select_scaled(None).len(), manifest.len());
+    }
+
+    #[test]
+    fn columnar_manifest_picklist() {
+        let base_path = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+        let zipfile = base_path.join("../../tests/test-data/prot/all.zip");
+
+        let collection = Collection::from_zipfile(&zipfile).unwrap();
+        let manifest = ColumnarManifest::from(collection.manifest());
+
+        // pick the first row by (ident, md5short), plus a value not present
+        let record = manifest.record(0);
+        let ident = record.name().split(' ').next().unwrap();
+        let mut picklist = PicklistMatcher::new(PickColumn::IdentMd5Short, PickStyle::Include);
+        picklist.add_pair(ident, &record.md5()[..8]);
+        picklist.add_pair("nope", "00000000");
+        assert_eq!(picklist.len(), 2);
+
+        let picked = manifest.select_picklist(None, &mut picklist);
+        assert!(picked.contains(&0));
+        assert!(picked.iter().all(|&i| manifest.md5(i) == manifest.md5(0)));
+        assert_eq!(picklist.found().collect::<Vec<_>>(), vec![0]);
+
+        // exclude picks everything else
+        let mut picklist = PicklistMatcher::new(PickColumn::Md5, PickStyle::Exclude);
+        picklist.add(manifest.md5(0));
+        let excluded = manifest.select_picklist(None, &mut picklist);
+        assert_eq!(excluded.len() + picked.len(), manifest.len());
+        assert_eq!(picklist.found().count(), 0);
+    }
 }
@@ -1,9 +1,11 @@
+use std::collections::HashMap;
+
 use getset::{CopyGetters, Getters, Setters};
 use typed_builder::TypedBuilder;
 
 use crate::encodings::HashFunctions;
 use crate::manifest::Record;
-use crate::Result;
+use crate::{Error, Result};
 
 #[derive(Default, Debug, TypedBuilder, Clone)]
 pub struct Selection {
@@ -48,7 +50,7 @@ pub struct Picklist {
     pickstyle: PickStyle,
 }
 
-#[derive(Clone, Default, Debug)]
+#[derive(Clone, Copy, Default, Debug, PartialEq, Eq)]
 #[repr(u32)]
 pub enum PickStyle {
     #[default]
@@ -131,3 +133,172 @@ impl Selection {
         })
     }
 }
+
+/// Which value of a sketch is compared against the picklist values.
+///
+/// Matches the picklist coltypes in the Python `SignaturePicklist`.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum PickColumn {
+    /// exact match to the name.
+    Name,
+    /// exact match to the md5sum.
+    Md5,
+    /// match to the first 8 characters of the md5sum.
+    Md5Prefix8,
+    /// match to the first space-delimited word of the name.
+    Ident,
+    /// like `Ident`, but only up to the first '.'.
+    IdentPrefix,
+    /// match to (`Ident`, `Md5Prefix8`) pairs; used for manifest, gather,
+    /// prefetch and search output.
+    IdentMd5Short,
+}
+
+impl TryFrom<&str> for PickColumn {
+    type Error = Error;
+
+    fn try_from(coltype: &str) -> Result<Self> {
+        match coltype {
+            "name" => Ok(PickColumn::Name),
+            "md5" => Ok(PickColumn::Md5),
+            "md5prefix8" | "md5short" => Ok(PickColumn::Md5Prefix8),
+            "ident" => Ok(PickColumn::Ident),
+            "identprefix" => Ok(PickColumn::IdentPrefix),
+            "manifest" | "gather" | "prefetch" | "search" => Ok(PickColumn::IdentMd5Short),
+            _ => Err(Error::Internal {
+                message: format!("invalid picklist column type '{coltype}'"),
+            }),
+        }
+    }
+}
+
+fn ident(name: &str) -> &str {
+    name.split(' ').next().unwrap_or(name)
+}
+
+fn ident_prefix(name: &str) -> &str {
+    let ident = ident(name);
+    ident.split('.').next().unwrap_or(ident)
+}
+
+fn md5_prefix8(md5: &str) -> &str {
+    md5.get(..8).unwrap_or(md5)
+}
+
+/// Hash-indexed picklist values, for matching many rows at once.
+///
+/// Each distinct value gets an id (in insertion order) so callers can keep
+/// track of which values were found. Lookups borrow from the row being
+/// checked, so matching a row does not allocate.
+#[derive(Debug, Clone)]
+pub struct PicklistMatcher {
+    column: PickColumn,
+    pickstyle: PickStyle,
+    values: HashMap<String, u32>,
+    // md5short => [(ident, id)], for IdentMd5Short
+    pairs: HashMap<String, Vec<(String, u32)>>,
+    found: Vec<bool>,
+}
+
+impl PicklistMatcher {
+    pub fn new(column: PickColumn, pickstyle: PickStyle) -> Self {
+        Self {
+            column,
+            pickstyle,
+            values: HashMap::new(),
+            pairs: HashMap::new(),
+            found: vec![],
+        }
+    }
+
+    pub fn column(&self) -> PickColumn {
+        self.column
+    }
+
+    pub fn pickstyle(&self) -> PickStyle {
+        self.pickstyle
+    }
+
+    /// Number of distinct values.
+    pub fn len(&self) -> usize {
+        self.found.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.found.is_empty()
+    }
+
+    /// Add an (already preprocessed) value, returning its id.
+    ///
+    /// For `IdentMd5Short`, use `add_pair` instead.
+    pub fn add(&mut self, value: &str) -> u32 {
+        assert_ne!(self.column, PickColumn::IdentMd5Short);
+        if let Some(id) = self.values.get(value) {
+            return *id;
+        }
+        let id = self.found.len() as u32;
+        self.values.insert(value.into(), id);
+        self.found.push(false);
+        id
+    }
+
+    /// Add an (ident, md5short) value, returning its id.
+    pub fn add_pair(&mut self, ident: &str, md5short: &str) -> u32 {
+        assert_eq!(self.column, PickColumn::IdentMd5Short);
+        let entries = self.pairs.entry(md5short.into()).or_default();
+        if let Some((_, id)) = entries.iter().find(|(i, _)| i == ident) {
+            return *id;
+        }
+        let id = self.found.len() as u32;
+        entries.push((ident.into(), id));
+        self.found.push(false);
+        id
+    }
+
+    /// The id of the value matching a sketch with this name and md5, if any.
+    ///
+    /// This ignores the pickstyle; see `matches`.
+    pub fn lookup(&self, name: &str, md5: &str) -> Option<u32> {
+        let value = match self.column {
+            PickColumn::Name => name,
+            PickColumn::Md5 => md5,
+            PickColumn::Md5Prefix8 => md5_prefix8(md5),
+            PickColumn::Ident => ident(name),
+            PickColumn::IdentPrefix => ident_prefix(name),
+            PickColumn::IdentMd5Short => {
+                let ident = ident(name);
+                return self
+                    .pairs
+                    .get(md5_prefix8(md5))
+                    .and_then(|entries| entries.iter().find(|(i, _)| i == ident))
+                    .map(|(_, id)| *id);
+            }
+        };
+        self.values.get(value).copied()
+    }
+
+    /// Does a sketch with this name and md5 pass the picklist?
+    pub fn matches(&self, name: &str, md5: &str) -> bool {
+        let found = self.lookup(name, md5).is_some();
+        match self.pickstyle {
+            PickStyle::Include => found,
+            PickStyle::Exclude => !found,
+        }
+    }
+
+    /// Record that the values with these ids were matched.
+    pub fn mark_found<I: IntoIterator<Item = u32>>(&mut self, ids: I) {
+        for id in ids {
+            self.found[id as usize] = true;
+        }
+    }
+
+    /// ids of all values matched so far.
+    pub fn found(&self) -> impl Iterator<Item = u32> + '_ {
+        self.found
+            .iter()
+            .enumerate()
+            .filter(|(_, &found)| found)
+            .map(|(id, _)| id as u32)
+    }
+}
@@ -783,6 +783,39 @@ impl Clone for Iter<'_> {
     }
 }
 
+/// Serialize signatures as a JSON list.
+///
+/// The output is gzip-compressed at level `compression` (1-9), or left
+/// uncompressed if `compression` is 0.
+pub fn signatures_to_buffer(sigs: &[&Signature], compression: u8) -> Result<Vec<u8>, Error> {
+    let mut buffer = vec![];
+    {
+        let mut writer = if compression > 0 {
+            let level = match compression {
+                1 => niffler::compression::Level::One,
+                2 => niffler::compression::Level::Two,
+                3 => niffler::compression::Level::Three,
+                4 => niffler::compression::Level::Four,
+                5 => niffler::compression::Level::Five,
+                6 => niffler::compression::Level::Six,
+                7 => niffler::compression::Level::Seven,
+                8 => niffler::compression::Level::Eight,
+                _ => niffler::compression::Level::Nine,
+            };
+
+            niffler::get_writer(
+                Box::new(&mut buffer),
+                niffler::compression::Format::Gzip,
+                level,
+            )?
+        } else {
+            Box::new(&mut buffer)
+        };
+        serde_json::to_writer(&mut writer, &sigs)?;
+    }
+    Ok(buffer)
+}
+
 impl ToWriter for Signature {
     fn to_writer<W>(&self, writer: &mut W) -> Result<(), Error>
     where
@@ -842,7 +875,7 @@ impl Select for Signature {
                 // TODO: also account for LargeMinHash
                 if let Sketch::MinHash(mh) = sketch {
                     if (mh.scaled() as u32) < sel_scaled {
-                        *sketch = Sketch::MinHash(mh.downsample_scaled(sel_scaled as u64)?);
+                        mh.downsample_scaled_in_place(sel_scaled as u64);
                     }
                 }
             }
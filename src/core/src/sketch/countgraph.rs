@@ -0,0 +1,387 @@
+use std::fs::File;
+use std::io;
+use std::path::Path;
+
+use byteorder::{BigEndian, LittleEndian, ReadBytesExt, WriteBytesExt};
+
+use crate::prelude::*;
+use crate::sketch::minhash::{KmerMinHash, KmerMinHashBTree};
+use crate::sketch::nodegraph::{_hash, prime_tablesizes};
+use crate::Error;
+use crate::HashIntoType;
+
+/// Counters saturate at this value, like khmer's 8-bit counters without bigcount.
+const MAX_COUNT: u8 = 255;
+
+/// A count-min sketch: the counting variant of `Nodegraph`, with one 8-bit
+/// saturating counter per bin in each table instead of one bit.
+///
+/// `get` returns the minimum over all tables, which never underestimates
+/// the real count.
+#[derive(Debug, Default, Clone)]
+pub struct Countgraph {
+    counts: Vec<Vec<u8>>,
+    ksize: usize,
+    occupied_bins: usize,
+    unique_kmers: usize,
+}
+
+// TODO: not checking for unique_kmers,
+// since it is not saved in a khmer countgraph
+impl PartialEq for Countgraph {
+    fn eq(&self, other: &Countgraph) -> bool {
+        self.counts == other.counts
+            && self.occupied_bins == other.occupied_bins
+            && self.ksize == other.ksize
+    }
+}
+
+/// Merging keeps the largest counter in each bin, so the counts of a merged
+/// countgraph (an internal SBT node, for example) are upper bounds for the
+/// counts in every countgraph merged into it.
+impl Update<Countgraph> for Countgraph {
+    fn update(&self, other: &mut Countgraph) -> Result<(), Error> {
+        if self.tablesizes() != other.tablesizes() {
+            return Err(Error::MismatchNum {
+                n1: self.tablesize() as u32,
+                n2: other.tablesize() as u32,
+            });
+        }
+
+        for (table, table_me) in other.counts.iter_mut().zip(&self.counts) {
+            for (count, count_me) in table.iter_mut().zip(table_me) {
+                *count = u8::max(*count, *count_me);
+            }
+        }
+        other.occupied_bins = other.counts[0].iter().filter(|c| **c != 0).count();
+        Ok(())
+    }
+}
+
+impl Update<Countgraph> for KmerMinHash {
+    fn update(&self, other: &mut Countgraph) -> Result<(), Error> {
+        for (h, abundance) in self.to_vec_abunds() {
+            other.count_with_abundance(h, abundance);
+        }
+        Ok(())
+    }
+}
+
+impl Update<Countgraph> for KmerMinHashBTree {
+    fn update(&self, other: &mut Countgraph) -> Result<(), Error> {
+        for (h, abundance) in self.to_vec_abunds() {
+            other.count_with_abundance(h, abundance);
+        }
+        Ok(())
+    }
+}
+
+impl Countgraph {
+    pub fn new(tablesizes: &[usize], ksize: usize) -> Countgraph {
+        let counts = tablesizes.iter().map(|size| vec![0; *size]).collect();
+
+        Countgraph {
+            counts,
+            ksize,
+            occupied_bins: 0,
+            unique_kmers: 0,
+        }
+    }
+
+    pub fn with_tables(tablesize: usize, n_tables: usize, ksize: usize) -> Countgraph {
+        let tablesizes = prime_tablesizes(tablesize, n_tables);
+        Countgraph::new(tablesizes.as_slice(), ksize)
+    }
+
+    pub(crate) fn count_kmer(&mut self, kmer: &[u8]) -> bool {
+        let h = _hash(kmer);
+        self.count(h)
+    }
+
+    pub fn count(&mut self, hash: HashIntoType) -> bool {
+        self.count_with_abundance(hash, 1)
+    }
+
+    /// Add `abundance` to the counters for `hash`, saturating at 255.
+    /// Returns whether the k-mer was new.
+    pub fn count_with_abundance(&mut self, hash: HashIntoType, abundance: u64) -> bool {
+        if abundance == 0 {
+            return false;
+        }
+
+        let mut is_new_kmer = false;
+
+        for (i, table) in self.counts.iter_mut().enumerate() {
+            let bin = (hash % table.len() as u64) as usize;
+            let count = &mut table[bin];
+            if *count == 0 {
+                if i == 0 {
+                    self.occupied_bins += 1;
+                }
+                is_new_kmer = true;
+            }
+            *count = u64::min(*count as u64 + abundance, MAX_COUNT as u64) as u8;
+        }
+
+        if is_new_kmer {
+            self.unique_kmers += 1
+        }
+        is_new_kmer
+    }
+
+    pub fn get(&self, hash: HashIntoType) -> usize {
+        self.counts
+            .iter()
+            .map(|table| table[(hash % table.len() as u64) as usize])
+            .min()
+            .unwrap_or(0) as usize
+    }
+
+    pub(crate) fn get_kmer(&self, kmer: &[u8]) -> usize {
+        let h = _hash(kmer);
+        self.get(h)
+    }
+
+    pub fn expected_collisions(&self) -> f64 {
+        let min_size = self.counts.iter().map(|x| x.len()).min().unwrap();
+        let n_ht = self.counts.len();
+        let occupancy = self.occupied_bins;
+
+        let fp_one = occupancy as f64 / min_size as f64;
+        f64::powf(fp_one, n_ht as f64)
+    }
+
+    pub fn tablesize(&self) -> usize {
+        self.counts.iter().map(|x| x.len()).sum()
+    }
+
+    pub fn noccupied(&self) -> usize {
+        self.occupied_bins
+    }
+
+    /// Number of hashes in `mh` present here (like `Nodegraph::matches`).
+    pub fn matches(&self, mh: &KmerMinHash) -> usize {
+        mh.iter_mins().filter(|x| self.get(**x) > 0).count()
+    }
+
+    /// Abundance-weighted matches: the sum over all hashes in `mh` of the
+    /// smaller of their abundance in `mh` (1 without abundance tracking)
+    /// and their count here.
+    ///
+    /// Since counts only overestimate, this is an upper bound for the same
+    /// sum computed with the real counts.
+    pub fn matches_weighted(&self, mh: &KmerMinHash) -> u64 {
+        match mh.abunds_slice() {
+            Some(abunds) => mh
+                .iter_mins()
+                .zip(abunds)
+                .map(|(h, abundance)| u64::min(*abundance, self.get(*h) as u64))
+                .sum(),
+            None => self.matches(mh) as u64,
+        }
+    }
+
+    pub fn ntables(&self) -> usize {
+        self.counts.len()
+    }
+
+    pub fn ksize(&self) -> usize {
+        self.ksize
+    }
+
+    // save
+    pub fn save<P: AsRef<Path>>(&self, path: P) -> Result<(), Error> {
+        self.save_to_writer(&mut File::create(path)?)?;
+        Ok(())
+    }
+
+    /// Save in the khmer countgraph format (without bigcounts).
+    pub fn save_to_writer<W>(&self, wtr: &mut W) -> Result<(), Error>
+    where
+        W: io::Write,
+    {
+        wtr.write_all(b"OXLI")?;
+        wtr.write_u8(4)?; // version
+        wtr.write_u8(1)?; // ht_type
+        wtr.write_u8(0)?; // use_bigcount
+        wtr.write_u32::<LittleEndian>(self.ksize as u32)?; // ksize
+        wtr.write_u8(self.counts.len() as u8)?; // n_tables
+        wtr.write_u64::<LittleEndian>(self.occupied_bins as u64)?; // n_occupied
+        for table in &self.counts {
+            wtr.write_u64::<LittleEndian>(table.len() as u64)?;
+            wtr.write_all(table)?;
+        }
+        wtr.write_u64::<LittleEndian>(0)?; // n_bigcounts
+        Ok(())
+    }
+
+    /// Load a khmer countgraph. Counts above 255 saved by khmer with
+    /// bigcount are capped at 255.
+    pub fn from_reader<R>(rdr: R) -> Result<Countgraph, Error>
+    where
+        R: io::Read,
+    {
+        let (mut rdr, _format) = niffler::get_reader(Box::new(rdr))?;
+
+        let signature = rdr.read_u32::<BigEndian>()?;
+        assert_eq!(signature, 0x4f58_4c49);
+
+        let version = rdr.read_u8()?;
+        assert_eq!(version, 0x04);
+
+        let ht_type = rdr.read_u8()?;
+        assert_eq!(ht_type, 0x01);
+
+        let _use_bigcount = rdr.read_u8()?;
+        let ksize = rdr.read_u32::<LittleEndian>()?;
+        let n_tables = rdr.read_u8()?;
+        let occupied_bins = rdr.read_u64::<LittleEndian>()? as usize;
+
+        let mut counts = Vec::with_capacity(n_tables as usize);
+        for _i in 0..n_tables {
+            let tablesize: usize = rdr.read_u64::<LittleEndian>()? as usize;
+            let mut table = vec![0; tablesize];
+            rdr.read_exact(&mut table)?;
+            counts.push(table);
+        }
+
+        let n_bigcounts = rdr.read_u64::<LittleEndian>()?;
+        for _i in 0..n_bigcounts {
+            let _kmer = rdr.read_u64::<LittleEndian>()?;
+            let _count = rdr.read_u16::<LittleEndian>()?;
+        }
+
+        Ok(Countgraph {
+            counts,
+            ksize: ksize as usize,
+            occupied_bins,
+            unique_kmers: 0, // This is a khmer issue, it doesn't save unique_kmers
+        })
+    }
+
+    pub fn from_path<P: AsRef<Path>>(path: P) -> Result<Countgraph, Error> {
+        let mut reader = io::BufReader::new(File::open(path)?);
+        Countgraph::from_reader(&mut reader)
+    }
+
+    pub fn tablesizes(&self) -> Vec<u64> {
+        self.counts.iter().map(|x| x.len() as u64).collect()
+    }
+
+    pub fn n_occupied_bins(&self) -> usize {
+        self.occupied_bins
+    }
+
+    pub fn unique_kmers(&self) -> usize {
+        self.unique_kmers
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::io::{BufReader, BufWriter};
+
+    use proptest::collection::vec;
+    use proptest::num::u64;
+    use proptest::proptest;
+
+    use crate::encodings::HashFunctions;
+
+    proptest! {
+      #[test]
+      fn count_and_get(hashes in vec(u64::ANY, 1..500)) {
+          let mut cg: Countgraph = Countgraph::new(&[1000], 3);
+          for hash in hashes {
+              let before = cg.get(hash);
+              cg.count(hash);
+              assert_eq!(cg.get(hash), usize::min(before + 1, 255));
+          }
+      }
+    }
+
+    #[test]
+    fn count_saturates() {
+        let mut cg = Countgraph::with_tables(23, 6, 3);
+        assert_eq!(cg.tablesizes(), &[19, 17, 13, 11, 7, 5]);
+
+        assert!(cg.count_kmer(b"ACG"));
+        assert!(!cg.count_kmer(b"ACG"));
+        assert_eq!(cg.get_kmer(b"ACG"), 2);
+        assert_eq!(cg.get_kmer(b"TTA"), 0);
+        assert_eq!(cg.unique_kmers(), 1);
+        assert_eq!(cg.n_occupied_bins(), 1);
+
+        cg.count_with_abundance(_hash(b"ACG"), 1000);
+        assert_eq!(cg.get_kmer(b"ACG"), 255);
+    }
+
+    #[test]
+    fn save_load_countgraph() {
+        let mut cg = Countgraph::with_tables(23, 6, 3);
+        cg.count_kmer(b"ACG");
+        cg.count_kmer(b"TTA");
+        cg.count_kmer(b"TTA");
+        cg.count_kmer(b"CGA");
+
+        let mut buf = Vec::new();
+        {
+            let mut writer = BufWriter::new(&mut buf);
+            cg.save_to_writer(&mut writer).unwrap();
+        }
+
+        // khmer layout: 20 header bytes, then a u64 size and one byte per
+        // counter for each table, then the (empty) bigcount list
+        assert_eq!(&buf[..7], b"OXLI\x04\x01\x00");
+        assert_eq!(buf.len(), 20 + 6 * 8 + (19 + 17 + 13 + 11 + 7 + 5) + 8);
+
+        let mut reader = BufReader::new(&buf[..]);
+        let new_cg = Countgraph::from_reader(&mut reader).expect("Loading error");
+        assert_eq!(new_cg, cg);
+        assert_eq!(new_cg.ksize(), 3);
+        assert_eq!(new_cg.get_kmer(b"ACG"), 1);
+        assert_eq!(new_cg.get_kmer(b"TTA"), 2);
+        assert_eq!(new_cg.get_kmer(b"CGA"), 1);
+    }
+
+    #[test]
+    fn matches_weighted_bounds() {
+        let mut leaf1 = Countgraph::with_tables(1000, 4, 21);
+        let mut leaf2 = Countgraph::with_tables(1000, 4, 21);
+        let mut parent = Countgraph::with_tables(1000, 4, 21);
+
+        let mut mh1 = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, true, 0);
+        let mut mh2 = mh1.clone();
+        let mut query = mh1.clone();
+        for h in 1..50u64 {
+            mh1.add_hash_with_abundance(h, h % 5 + 1);
+            mh2.add_hash_with_abundance(h + 25, 3);
+            query.add_hash_with_abundance(h * 2, 2);
+        }
+
+        mh1.update(&mut leaf1).unwrap();
+        mh2.update(&mut leaf2).unwrap();
+        leaf1.update(&mut parent).unwrap();
+        leaf2.update(&mut parent).unwrap();
+
+        let mut exact = 0;
+        for (h, abundance) in query.to_vec_abunds() {
+            let in_leaf1 = mh1
+                .to_vec_abunds()
+                .iter()
+                .find(|(x, _)| *x == h)
+                .map(|x| x.1);
+            exact += abundance.min(in_leaf1.unwrap_or(0));
+        }
+        assert!(leaf1.matches_weighted(&query) >= exact);
+
+        for leaf in [&leaf1, &leaf2] {
+            assert!(parent.matches_weighted(&query) >= leaf.matches_weighted(&query));
+            assert!(parent.matches(&query) >= leaf.matches(&query));
+        }
+
+        let mut flat = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, false, 0);
+        flat.add_many(&query.mins()).unwrap();
+        assert_eq!(leaf1.matches_weighted(&flat), leaf1.matches(&flat) as u64);
+    }
+}
@@ -2,18 +2,125 @@ use std::cmp;
 
 pub type CounterType = u8;
 
-pub fn counts(registers: &[CounterType], q: usize) -> Vec<u16> {
-    let mut counts = vec![0; q + 2];
+/// Register values are at most `q + 1 <= 61`, so they fit in 6 bits.
+const VALUE_BITS: usize = 6;
+const N_VALUES: usize = 1 << VALUE_BITS;
+const VALUE_MASK: usize = N_VALUES - 1;
 
-    for k in registers {
-        counts[*k as usize] += 1;
+/// Registers per step in `merge_registers`; a multiple of the u8 lanes of
+/// common vector units (16 for SSE2/NEON, 32 for AVX2).
+const LANES: usize = 32;
+
+/// Element-wise max of `registers` and `other`, stored in `registers`.
+///
+/// Processed in fixed-size chunks without bounds checks, so it compiles to
+/// u8 vector max instructions on targets that have them.
+pub fn merge_registers(registers: &mut [CounterType], other: &[CounterType]) {
+    debug_assert_eq!(registers.len(), other.len());
+    let mut chunks = registers.chunks_exact_mut(LANES);
+    let mut other_chunks = other.chunks_exact(LANES);
+
+    for (chunk, other_chunk) in (&mut chunks).zip(&mut other_chunks) {
+        for (r, o) in chunk.iter_mut().zip(other_chunk) {
+            *r = cmp::max(*r, *o);
+        }
+    }
+    for (r, o) in chunks
+        .into_remainder()
+        .iter_mut()
+        .zip(other_chunks.remainder())
+    {
+        *r = cmp::max(*r, *o);
+    }
+}
+
+/// Histogram of register values.
+///
+/// Counts go to four interleaved sub-histograms, so runs of registers with
+/// the same value don't serialize on a single counter, and are summed at
+/// the end.
+pub fn counts(registers: &[CounterType], q: usize) -> Vec<u32> {
+    let mut partial = [[0u32; N_VALUES]; 4];
+
+    let mut chunks = registers.chunks_exact(4);
+    for chunk in &mut chunks {
+        for (sub, k) in partial.iter_mut().zip(chunk) {
+            sub[*k as usize & VALUE_MASK] += 1;
+        }
+    }
+    for k in chunks.remainder() {
+        partial[0][*k as usize & VALUE_MASK] += 1;
+    }
+
+    (0..q + 2)
+        .map(|i| partial.iter().map(|sub| sub[i]).sum::<u32>())
+        .collect()
+}
+
+/// Per-value histograms of two register arrays, as used by `joint_mle`.
+struct JointCounts {
+    /// registers of A with k1 < k2
+    less1: Vec<u32>,
+    /// registers of B with k1 > k2
+    less2: Vec<u32>,
+    /// max(k1, k2)
+    union: Vec<u32>,
+    /// registers of A with k1 > k2
+    greater1: Vec<u32>,
+    /// registers of B with k1 < k2
+    greater2: Vec<u32>,
+    /// registers with k1 == k2
+    equal: Vec<u32>,
+}
+
+/// Build all joint histograms from a single 2D histogram of (k1, k2)
+/// pairs: one branch-free increment per register, instead of a compare
+/// and several increments, then a pass over the small 2D table.
+fn joint_counts(k1: &[CounterType], k2: &[CounterType], q: usize) -> JointCounts {
+    let mut pairs = [0u32; N_VALUES * N_VALUES];
+    for (a, b) in k1.iter().zip(k2) {
+        let a = *a as usize & VALUE_MASK;
+        let b = *b as usize & VALUE_MASK;
+        pairs[(a << VALUE_BITS) | b] += 1;
+    }
+
+    let mut counts = JointCounts {
+        less1: vec![0; q + 2],
+        less2: vec![0; q + 2],
+        union: vec![0; q + 2],
+        greater1: vec![0; q + 2],
+        greater2: vec![0; q + 2],
+        equal: vec![0; q + 2],
+    };
+
+    for a in 0..q + 2 {
+        for b in 0..q + 2 {
+            let n = pairs[(a << VALUE_BITS) | b];
+            if n == 0 {
+                continue;
+            }
+            match a.cmp(&b) {
+                cmp::Ordering::Less => {
+                    counts.less1[a] += n;
+                    counts.greater2[b] += n;
+                }
+                cmp::Ordering::Greater => {
+                    counts.greater1[a] += n;
+                    counts.less2[b] += n;
+                }
+                cmp::Ordering::Equal => {
+                    counts.equal[a] += n;
+                }
+            }
+            counts.union[cmp::max(a, b)] += n;
+        }
     }
 
     counts
 }
 
 #[allow(clippy::many_single_char_names)]
-pub fn mle(counts: &[u16], p: usize, q: usize, relerr: f64) -> f64 {
+pub fn mle(counts: &[u32], p: usize, q: usize, relerr: f64) -> f64 {
     let m = 1 << p;
     if counts[q + 1] == m {
         return std::f64::INFINITY;
@@ -112,29 +219,14 @@ pub fn joint_mle(
     p: usize,
     q: usize,
 ) -> (usize, usize, usize) {
-    let mut c1 = vec![0; q + 2];
-    let mut c2 = vec![0; q + 2];
-    let mut cu = vec![0; q + 2];
-    let mut cg1 = vec![0; q + 2];
-    let mut cg2 = vec![0; q + 2];
-    let mut ceq = vec![0; q + 2];
-
-    for (k1_, k2_) in k1.iter().zip(k2.iter()) {
-        match k1_.cmp(k2_) {
-            cmp::Ordering::Less => {
-                c1[*k1_ as usize] += 1;
-                cg2[*k2_ as usize] += 1;
-            }
-            cmp::Ordering::Greater => {
-                cg1[*k1_ as usize] += 1;
-                c2[*k2_ as usize] += 1;
-            }
-            cmp::Ordering::Equal => {
-                ceq[*k1_ as usize] += 1;
-            }
-        }
-        cu[*cmp::max(k1_, k2_) as usize] += 1;
-    }
+    let JointCounts {
+        less1: mut c1,
+        less2: mut c2,
+        union: cu,
+        greater1: cg1,
+        greater2: cg2,
+        equal: ceq,
+    } = joint_counts(k1, k2, q);
 
     for (i, (v, u)) in cg1.iter().zip(ceq.iter()).enumerate() {
         c1[i] += v + u;
@@ -148,11 +240,11 @@ pub fn joint_mle(
     let c_bx = mle(&c2, p, q, 0.01);
     let c_abx = mle(&cu, p, q, 0.01);
 
-    let mut counts_axb_half = vec![0u16; q + 2];
-    let mut counts_bxa_half = vec![0u16; q + 2];
+    let mut counts_axb_half = vec![0u32; q + 2];
+    let mut counts_bxa_half = vec![0u32; q + 2];
 
-    counts_axb_half[q] = k1.len() as u16;
-    counts_bxa_half[q] = k2.len() as u16;
+    counts_axb_half[q] = k1.len() as u32;
+    counts_bxa_half[q] = k2.len() as u32;
 
     for _q in 0..q {
         counts_axb_half[_q] = cg1[_q] + ceq[_q] + cg2[_q + 1];
@@ -176,3 +268,70 @@ pub fn joint_mle(
         cmp::max(0, (0.5 * (cx1 + cx2)) as usize),
     )
 }
+
+#[cfg(test)]
+mod test {
+    use std::cmp;
+
+    use rand::{Rng, SeedableRng};
+
+    use super::{counts, joint_counts, merge_registers, CounterType};
+
+    fn random_registers(rng: &mut impl Rng, n: usize, q: usize) -> Vec<CounterType> {
+        // mostly small values, like real registers, with a few large ones
+        (0..n)
+            .map(|_| cmp::min(rng.gen_range(0..8) * rng.gen_range(1..4), q + 1) as CounterType)
+            .collect()
+    }
+
+    #[test]
+    fn kernels_match_scalar() {
+        let mut rng = rand::rngs::StdRng::seed_from_u64(42);
+        let q = 50;
+
+        for n in [0, 1, 31, 33, 1 << 12] {
+            let k1 = random_registers(&mut rng, n, q);
+            let k2 = random_registers(&mut rng, n, q);
+
+            let mut merged = k1.clone();
+            merge_registers(&mut merged, &k2);
+            let expected: Vec<_> = k1.iter().zip(&k2).map(|(a, b)| *cmp::max(a, b)).collect();
+            assert_eq!(merged, expected);
+
+            let mut expected = vec![0u32; q + 2];
+            for k in &k1 {
+                expected[*k as usize] += 1;
+            }
+            assert_eq!(counts(&k1, q), expected);
+
+            let joint = joint_counts(&k1, &k2, q);
+            let mut less1 = vec![0u32; q + 2];
+            let mut less2 = vec![0u32; q + 2];
+            let mut union = vec![0u32; q + 2];
+            let mut greater1 = vec![0u32; q + 2];
+            let mut greater2 = vec![0u32; q + 2];
+            let mut equal = vec![0u32; q + 2];
+            for (a, b) in k1.iter().zip(&k2) {
+                let (a, b) = (*a as usize, *b as usize);
+                match a.cmp(&b) {
+                    cmp::Ordering::Less => {
+                        less1[a] += 1;
+                        greater2[b] += 1;
+                    }
+                    cmp::Ordering::Greater => {
+                        greater1[a] += 1;
+                        less2[b] += 1;
+                    }
+                    cmp::Ordering::Equal => equal[a] += 1,
+                }
+                union[cmp::max(a, b)] += 1;
+            }
+            assert_eq!(joint.less1, less1);
+            assert_eq!(joint.less2, less2);
+            assert_eq!(joint.union, union);
+            assert_eq!(joint.greater1, greater1);
+            assert_eq!(joint.greater2, greater2);
+            assert_eq!(joint.equal, equal);
+        }
+    }
+}
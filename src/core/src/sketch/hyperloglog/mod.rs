@@ -7,17 +7,20 @@ first implemented for genomics in dashing
   https://genomebiology.biomedcentral.com/articles/10.1186/s13059-019-1875-0
 */
 
+use std::borrow::Cow;
 use std::cmp;
 use std::fs::File;
 use std::io;
 use std::path::Path;
 
 use byteorder::{BigEndian, ReadBytesExt, WriteBytesExt};
+use serde::de::Deserializer;
+use serde::ser::{SerializeStruct, Serializer};
 use serde::{Deserialize, Serialize};
 
 use crate::encodings::HashFunctions;
 use crate::prelude::*;
-use crate::signature::SigsTrait;
+use crate::signature::{SeqToHashes, SigsTrait};
 use crate::sketch::KmerMinHash;
 use crate::Error;
 use crate::HashIntoType;
@@ -25,16 +28,116 @@ use crate::HashIntoType;
 pub mod estimators;
 use estimators::CounterType;
 
-#[derive(Debug, Default, Clone, PartialEq, Eq, Serialize, Deserialize)]
+/// A HyperLogLog starts in sparse mode, keeping only the non-zero registers
+/// as sorted `(index << 8) | rank` entries, and switches to `1 << p` dense
+/// registers once more than a quarter of them are set (where the dense form
+/// becomes smaller).
+#[derive(Debug, Clone)]
 #[cfg_attr(
     feature = "rkyv",
     derive(rkyv::Serialize, rkyv::Deserialize, rkyv::Archive)
 )]
 pub struct HyperLogLog {
+    /// Dense registers; empty in sparse mode.
     registers: Vec<CounterType>,
     p: usize,
     q: usize,
     ksize: usize,
+    /// Sparse registers, sorted by index; empty in dense mode.
+    sparse: Vec<u32>,
+    /// Sparse entries from `add_hash` not yet merged into `sparse`, unsorted.
+    pending: Vec<u32>,
+    hash_function: HashFunctions,
+    seed: u64,
+}
+
+const DEFAULT_SEED: u64 = 42;
+
+/// Hashes are added to the registers in batches of this size.
+const BATCH_SIZE: usize = 256;
+
+const SPARSE_RANK_BITS: u32 = 8;
+const SPARSE_RANK_MASK: u32 = (1 << SPARSE_RANK_BITS) - 1;
+
+#[inline]
+fn sparse_entry(index: usize, rank: CounterType) -> u32 {
+    ((index as u32) << SPARSE_RANK_BITS) | rank as u32
+}
+
+#[inline]
+fn sparse_index(entry: u32) -> usize {
+    (entry >> SPARSE_RANK_BITS) as usize
+}
+
+#[inline]
+fn sparse_rank(entry: u32) -> CounterType {
+    (entry & SPARSE_RANK_MASK) as CounterType
+}
+
+/// Union of two sparse register lists, keeping the largest rank per index.
+fn merge_sparse(a: &[u32], b: &[u32]) -> Vec<u32> {
+    let mut merged = Vec::with_capacity(a.len() + b.len());
+    let (mut i, mut j) = (0, 0);
+    while i < a.len() && j < b.len() {
+        match sparse_index(a[i]).cmp(&sparse_index(b[j])) {
+            cmp::Ordering::Less => {
+                merged.push(a[i]);
+                i += 1;
+            }
+            cmp::Ordering::Greater => {
+                merged.push(b[j]);
+                j += 1;
+            }
+            cmp::Ordering::Equal => {
+                // same index, so the larger entry has the larger rank
+                merged.push(cmp::max(a[i], b[j]));
+                i += 1;
+                j += 1;
+            }
+        }
+    }
+    merged.extend_from_slice(&a[i..]);
+    merged.extend_from_slice(&b[j..]);
+    merged
+}
+
+/// Sort sparse entries by index, keeping the largest rank for each index.
+fn sort_sparse(mut entries: Vec<u32>) -> Vec<u32> {
+    entries.sort_unstable();
+    // keep the last (largest rank) entry for each index
+    entries.dedup_by(|next, prev| {
+        if sparse_index(*next) == sparse_index(*prev) {
+            *prev = *next;
+            true
+        } else {
+            false
+        }
+    });
+    entries
+}
+
+fn hash_function_code(hash_function: &HashFunctions) -> Result<u8, Error> {
+    match hash_function {
+        HashFunctions::Murmur64Dna => Ok(0),
+        HashFunctions::Murmur64Protein => Ok(1),
+        HashFunctions::Murmur64Dayhoff => Ok(2),
+        HashFunctions::Murmur64Hp => Ok(3),
+        invalid => Err(Error::InvalidHashFunction {
+            function: format!("{}", invalid),
+        }),
+    }
+}
+
+fn hash_function_from_code(code: u8) -> Result<HashFunctions, Error> {
+    match code {
+        0 => Ok(HashFunctions::Murmur64Dna),
+        1 => Ok(HashFunctions::Murmur64Protein),
+        2 => Ok(HashFunctions::Murmur64Dayhoff),
+        3 => Ok(HashFunctions::Murmur64Hp),
+        invalid => Err(Error::InvalidHashFunction {
+            function: format!("{}", invalid),
+        }),
+    }
 }
 
 impl HyperLogLog {
@@ -48,61 +151,264 @@ impl HyperLogLog {
             return Err(Error::HLLPrecisionBounds);
         }
 
-        let size = (1_usize) << p;
-        let registers = vec![0; size];
-
         Ok(HyperLogLog {
-            registers,
+            registers: Vec::new(),
             ksize,
             p,
             q: 64 - p, // FIXME: allow setting q explicitly
+            sparse: Vec::new(),
+            pending: Vec::new(),
+            hash_function: HashFunctions::Murmur64Dna,
+            seed: DEFAULT_SEED,
         })
     }
 
+    /// Use `hash_function` and `seed` (instead of DNA and 42) for the
+    /// k-mers added with `add_sequence`, `add_protein` and `add_word`.
+    pub fn with_hash_function(mut self, hash_function: HashFunctions, seed: u64) -> Self {
+        self.hash_function = hash_function;
+        self.seed = seed;
+        self
+    }
+
+    /// Build from dense registers, switching to sparse mode if few are set.
+    fn from_registers(registers: Vec<CounterType>, p: usize, q: usize, ksize: usize) -> Self {
+        let mut hll = HyperLogLog {
+            registers,
+            p,
+            q,
+            ksize,
+            sparse: Vec::new(),
+            pending: Vec::new(),
+            hash_function: HashFunctions::Murmur64Dna,
+            seed: DEFAULT_SEED,
+        };
+        let n_set = hll.registers.iter().filter(|r| **r != 0).count();
+        if n_set <= hll.sparse_limit() {
+            hll.sparse = hll
+                .registers
+                .iter()
+                .enumerate()
+                .filter(|(_, r)| **r != 0)
+                .map(|(index, r)| sparse_entry(index, *r))
+                .collect();
+            hll.registers = Vec::new();
+        }
+        hll
+    }
+
+    /// Number of bits used for the register index.
+    pub fn p(&self) -> usize {
+        self.p
+    }
+
+    /// Number of bits used for counting leading zeroes.
+    pub fn q(&self) -> usize {
+        self.q
+    }
+
+    /// Number of set registers above which the sparse form is converted.
+    fn sparse_limit(&self) -> usize {
+        (1 << self.p) / 4
+    }
+
+    pub fn is_sparse(&self) -> bool {
+        self.registers.is_empty()
+    }
+
+    /// Switch to dense registers, if not already.
+    pub fn densify(&mut self) {
+        if self.is_sparse() {
+            self.registers = self.registers().into_owned();
+            self.sparse = Vec::new();
+            self.pending = Vec::new();
+        }
+    }
+
+    /// Sparse registers including the pending ones, sorted by index.
+    fn sparse_entries(&self) -> Cow<'_, [u32]> {
+        if self.pending.is_empty() {
+            Cow::Borrowed(&self.sparse)
+        } else {
+            let pending = sort_sparse(self.pending.clone());
+            Cow::Owned(merge_sparse(&self.sparse, &pending))
+        }
+    }
+
+    /// Merge sparse `entries` (in any order) into the sparse registers,
+    /// densifying if there are too many.
+    fn merge_sparse_entries(&mut self, entries: Vec<u32>) {
+        self.sparse = merge_sparse(&self.sparse, &sort_sparse(entries));
+        if self.sparse.len() > self.sparse_limit() {
+            self.densify();
+        }
+    }
+
+    fn flush_pending(&mut self) {
+        if !self.pending.is_empty() {
+            let pending = std::mem::take(&mut self.pending);
+            self.merge_sparse_entries(pending);
+        }
+    }
+
+    /// All `1 << p` registers, expanded from the sparse form if needed.
+    pub fn registers(&self) -> Cow<'_, [CounterType]> {
+        if self.is_sparse() {
+            let mut registers = vec![0; 1 << self.p];
+            for entry in self.sparse.iter().chain(&self.pending) {
+                let register = &mut registers[sparse_index(*entry)];
+                *register = cmp::max(*register, sparse_rank(*entry));
+            }
+            Cow::Owned(registers)
+        } else {
+            Cow::Borrowed(&self.registers)
+        }
+    }
+
     pub fn merge(&mut self, other: &HyperLogLog) -> Result<(), Error> {
         self.check_compatible(other)?;
-        self.registers
-            .iter_mut()
-            .zip(other.registers.iter())
-            .for_each(|(a, b)| *a = cmp::max(*a, *b));
+        self.flush_pending();
+        match (self.is_sparse(), other.is_sparse()) {
+            (true, true) => {
+                self.sparse = merge_sparse(&self.sparse, &other.sparse_entries());
+                if self.sparse.len() > self.sparse_limit() {
+                    self.densify();
+                }
+            }
+            (false, true) => {
+                for entry in other.sparse.iter().chain(&other.pending) {
+                    let register = &mut self.registers[sparse_index(*entry)];
+                    *register = cmp::max(*register, sparse_rank(*entry));
+                }
+            }
+            (_, false) => {
+                self.densify();
+                estimators::merge_registers(&mut self.registers, &other.registers);
+            }
+        }
         Ok(())
     }
 
     pub fn add_word(&mut self, word: &[u8]) {
-        let hash = crate::_hash_murmur(word, 42); // TODO: decide on seed
+        let hash = crate::_hash_murmur(word, self.seed);
         self.add_hash(hash);
     }
 
     pub fn add_many(&mut self, hashes: &[HashIntoType]) -> Result<(), Error> {
-        for min in hashes {
-            self.add_hash(*min);
+        for batch in hashes.chunks(BATCH_SIZE) {
+            self.add_batch(batch);
+        }
+        Ok(())
+    }
+
+    /// Register index and rank (position of the leftmost 1-bit) for `hash`.
+    #[inline]
+    fn index_and_rank(&self, hash: HashIntoType) -> (usize, CounterType) {
+        let value = hash >> self.p;
+        let index = (hash - (value << self.p)) as usize;
+        let rank = value.leading_zeros() + 1 - (self.p as u32);
+        (index, rank as CounterType)
+    }
+
+    /// Add a batch of hashes: in sparse mode they are sorted and merged in
+    /// one pass (with any pending entries) instead of inserted one at a
+    /// time; in dense mode indices and
+    /// ranks are computed in a separate (vectorizable) loop from the
+    /// register updates.
+    fn add_batch(&mut self, hashes: &[HashIntoType]) {
+        debug_assert!(hashes.len() <= BATCH_SIZE);
+        if hashes.is_empty() {
+            return;
+        }
+
+        if self.is_sparse() {
+            let mut entries: Vec<u32> = hashes
+                .iter()
+                .map(|hash| {
+                    let (index, rank) = self.index_and_rank(*hash);
+                    sparse_entry(index, rank)
+                })
+                .collect();
+            entries.append(&mut self.pending);
+            self.merge_sparse_entries(entries);
+        } else {
+            let mut indices = [0usize; BATCH_SIZE];
+            let mut ranks = [0 as CounterType; BATCH_SIZE];
+            for ((hash, index), rank) in hashes.iter().zip(&mut indices).zip(&mut ranks) {
+                (*index, *rank) = self.index_and_rank(*hash);
+            }
+            for (index, rank) in indices.iter().zip(&ranks).take(hashes.len()) {
+                let register = &mut self.registers[*index];
+                *register = cmp::max(*register, *rank);
+            }
+        }
+    }
+
+    /// Add all valid hashes from `hashes`, in batches.
+    fn add_hash_results<I>(&mut self, hashes: I) -> Result<(), Error>
+    where
+        I: Iterator<Item = Result<HashIntoType, Error>>,
+    {
+        let mut batch = Vec::with_capacity(BATCH_SIZE);
+        for hash in hashes {
+            match hash? {
+                0 => continue,
+                hash => batch.push(hash),
+            }
+            if batch.len() == BATCH_SIZE {
+                self.add_batch(&batch);
+                batch.clear();
+            }
         }
+        self.add_batch(&batch);
         Ok(())
     }
 
+    /// Reset all registers (back to sparse mode), keeping the precision and ksize.
+    pub fn clear(&mut self) {
+        self.registers = Vec::new();
+        self.sparse.clear();
+        self.pending.clear();
+    }
+
+    /// Relative standard error of `cardinality`, 1.04/sqrt(m) for m registers.
+    pub fn relative_error(&self) -> f64 {
+        1.04 / (self.size() as f64).sqrt()
+    }
+
     pub fn cardinality(&self) -> usize {
-        let counts = estimators::counts(&self.registers, self.q);
+        let counts = if self.is_sparse() {
+            let sparse = self.sparse_entries();
+            let mut counts = vec![0u32; self.q + 2];
+            counts[0] = (self.size() - sparse.len()) as u32;
+            for entry in sparse.iter() {
+                counts[sparse_rank(*entry) as usize] += 1;
+            }
+            counts
+        } else {
+            estimators::counts(&self.registers, self.q)
+        };
 
         estimators::mle(&counts, self.p, self.q, 0.01) as usize
     }
 
     pub fn similarity(&self, other: &HyperLogLog) -> f64 {
         let (only_a, only_b, intersection) =
-            estimators::joint_mle(&self.registers, &other.registers, self.p, self.q);
+            estimators::joint_mle(&self.registers(), &other.registers(), self.p, self.q);
 
         intersection as f64 / (only_a + only_b + intersection) as f64
     }
 
     pub fn containment(&self, other: &HyperLogLog) -> f64 {
         let (only_a, _, intersection) =
-            estimators::joint_mle(&self.registers, &other.registers, self.p, self.q);
+            estimators::joint_mle(&self.registers(), &other.registers(), self.p, self.q);
 
         intersection as f64 / (only_a + intersection) as f64
     }
 
     pub fn intersection(&self, other: &HyperLogLog) -> usize {
         let (_, _, intersection) =
-            estimators::joint_mle(&self.registers, &other.registers, self.p, self.q);
+            estimators::joint_mle(&self.registers(), &other.registers(), self.p, self.q);
 
         intersection
     }
@@ -119,12 +425,20 @@ impl HyperLogLog {
     where
         W: io::Write,
     {
+        // version 1 (khmer-compatible) for the default seed and hash function,
+        // version 2 appends them to the header otherwise.
+        let is_default = self.seed == DEFAULT_SEED && self.hash_function.dna();
+
         wtr.write_all(b"HLL")?;
-        wtr.write_u8(1)?; // version
+        wtr.write_u8(if is_default { 1 } else { 2 })?; // version
         wtr.write_u8(self.p as u8)?; // number of bits used for indexing
         wtr.write_u8(self.q as u8)?; // number of bits used for counting leading zeroes
         wtr.write_u8(self.ksize as u8)?; // ksize
-        wtr.write_all(self.registers.as_slice())?;
+        if !is_default {
+            wtr.write_u8(hash_function_code(&self.hash_function)?)?;
+            wtr.write_u64::<BigEndian>(self.seed)?;
+        }
+        wtr.write_all(&self.registers())?;
 
         Ok(())
     }
@@ -139,23 +453,28 @@ impl HyperLogLog {
         assert_eq!(signature, 0x484c4c);
 
         let version = rdr.read_u8()?;
-        assert_eq!(version, 1);
+        assert!(
+            version == 1 || version == 2,
+            "unknown HLL version {version}"
+        );
 
         let p = rdr.read_u8()? as usize;
         let q = rdr.read_u8()? as usize;
 
         let ksize = rdr.read_u8()? as usize;
+        let (hash_function, seed) = if version == 2 {
+            let hash_function = hash_function_from_code(rdr.read_u8()?)?;
+            (hash_function, rdr.read_u64::<BigEndian>()?)
+        } else {
+            (HashFunctions::Murmur64Dna, DEFAULT_SEED)
+        };
         let n_registers = 1 << p;
 
         let mut registers = vec![0u8; n_registers];
         rdr.read_exact(&mut registers)?;
 
-        Ok(HyperLogLog {
-            registers,
-            p,
-            q,
-            ksize,
-        })
+        Ok(HyperLogLog::from_registers(registers, p, q, ksize)
+            .with_hash_function(hash_function, seed))
     }
 
     pub fn from_path<P: AsRef<Path>>(path: P) -> Result<HyperLogLog, Error> {
@@ -164,13 +483,128 @@ impl HyperLogLog {
     }
 }
 
+impl Default for HyperLogLog {
+    fn default() -> HyperLogLog {
+        HyperLogLog {
+            registers: Vec::new(),
+            p: 0,
+            q: 0,
+            ksize: 0,
+            sparse: Vec::new(),
+            pending: Vec::new(),
+            hash_function: HashFunctions::Murmur64Dna,
+            seed: DEFAULT_SEED,
+        }
+    }
+}
+
+impl PartialEq for HyperLogLog {
+    fn eq(&self, other: &HyperLogLog) -> bool {
+        self.p == other.p
+            && self.q == other.q
+            && self.ksize == other.ksize
+            && self.seed == other.seed
+            && self.hash_function == other.hash_function
+            && if self.is_sparse() && other.is_sparse() {
+                self.sparse_entries() == other.sparse_entries()
+            } else {
+                self.registers() == other.registers()
+            }
+    }
+}
+
+impl Eq for HyperLogLog {}
+
+// Always serialized with dense registers, so the format doesn't depend on
+// the in-memory mode. Seed and molecule are only included if not the defaults.
+impl Serialize for HyperLogLog {
+    fn serialize<S>(&self, serializer: S) -> Result<S::Ok, S::Error>
+    where
+        S: Serializer,
+    {
+        let mut n_fields = 4;
+        if self.seed != DEFAULT_SEED {
+            n_fields += 1;
+        }
+        if !self.hash_function.dna() {
+            n_fields += 1;
+        }
+
+        let mut partial = serializer.serialize_struct("HyperLogLog", n_fields)?;
+        partial.serialize_field("registers", &self.registers())?;
+        partial.serialize_field("p", &self.p)?;
+        partial.serialize_field("q", &self.q)?;
+        partial.serialize_field("ksize", &self.ksize)?;
+        if self.seed != DEFAULT_SEED {
+            partial.serialize_field("seed", &self.seed)?;
+        }
+        if !self.hash_function.dna() {
+            partial.serialize_field("molecule", &self.hash_function.to_string())?;
+        }
+        partial.end()
+    }
+}
+
+impl<'de> Deserialize<'de> for HyperLogLog {
+    fn deserialize<D>(deserializer: D) -> Result<Self, D::Error>
+    where
+        D: Deserializer<'de>,
+    {
+        #[derive(Deserialize)]
+        struct TempHLL {
+            registers: Vec<CounterType>,
+            p: usize,
+            q: usize,
+            ksize: usize,
+            #[serde(default = "default_seed")]
+            seed: u64,
+            #[serde(default = "default_molecule")]
+            molecule: String,
+        }
+
+        fn default_seed() -> u64 {
+            DEFAULT_SEED
+        }
+
+        fn default_molecule() -> String {
+            "dna".into()
+        }
+
+        let tmp = TempHLL::deserialize(deserializer)?;
+        if tmp.registers.len() != 1 << tmp.p {
+            return Err(serde::de::Error::invalid_length(
+                tmp.registers.len(),
+                &"1 << p registers",
+            ));
+        }
+
+        let hash_function = match tmp.molecule.to_lowercase().as_ref() {
+            "dna" => HashFunctions::Murmur64Dna,
+            "protein" => HashFunctions::Murmur64Protein,
+            "dayhoff" => HashFunctions::Murmur64Dayhoff,
+            "hp" => HashFunctions::Murmur64Hp,
+            invalid => {
+                return Err(serde::de::Error::invalid_value(
+                    serde::de::Unexpected::Str(invalid),
+                    &"dna, protein, dayhoff or hp",
+                ))
+            }
+        };
+
+        Ok(
+            HyperLogLog::from_registers(tmp.registers, tmp.p, tmp.q, tmp.ksize)
+                .with_hash_function(hash_function, tmp.seed),
+        )
+    }
+}
+
 impl SigsTrait for HyperLogLog {
     fn size(&self) -> usize {
-        self.registers.len()
+        1 << self.p
     }
 
     fn to_vec(&self) -> Vec<u64> {
-        self.registers.iter().map(|x| *x as u64).collect()
+        self.registers().iter().map(|x| *x as u64).collect()
     }
 
     fn ksize(&self) -> usize {
@@ -178,28 +612,61 @@ impl SigsTrait for HyperLogLog {
     }
 
     fn seed(&self) -> u64 {
-        // TODO: support other seeds
-        42
+        self.seed
     }
 
     fn hash_function(&self) -> HashFunctions {
-        //TODO support other hash functions
-        HashFunctions::Murmur64Dna
+        self.hash_function.clone()
+    }
+
+    fn add_sequence(&mut self, seq: &[u8], force: bool) -> Result<(), Error> {
+        let hashes = SeqToHashes::new(
+            seq,
+            self.ksize,
+            force,
+            false,
+            self.hash_function.clone(),
+            self.seed,
+        );
+        self.add_hash_results(hashes)
+    }
+
+    fn add_protein(&mut self, seq: &[u8]) -> Result<(), Error> {
+        let hashes = SeqToHashes::new(
+            seq,
+            self.ksize,
+            false,
+            true,
+            self.hash_function.clone(),
+            self.seed,
+        );
+        self.add_hash_results(hashes)
     }
 
     fn add_hash(&mut self, hash: HashIntoType) {
-        let value = hash >> self.p;
-        let index = (hash - (value << self.p)) as usize;
+        let (index, leftmost) = self.index_and_rank(hash);
 
-        let leftmost = value.leading_zeros() + 1 - (self.p as u32);
+        if !self.is_sparse() {
+            let old_value = self.registers[index];
+            self.registers[index] = cmp::max(old_value, leftmost);
+            return;
+        }
 
-        let old_value = self.registers[index];
-        self.registers[index] = cmp::max(old_value, leftmost as CounterType);
+        // buffered, so sparse inserts are merged in batches instead of
+        // shifting the sorted entries once per hash
+        self.pending.push(sparse_entry(index, leftmost));
+        if self.pending.len() >= BATCH_SIZE {
+            self.flush_pending();
+        }
     }
 
     fn check_compatible(&self, other: &HyperLogLog) -> Result<(), Error> {
         if self.ksize() != other.ksize() {
             Err(Error::MismatchKSizes)
+        } else if self.hash_function != other.hash_function {
+            Err(Error::MismatchDNAProt)
+        } else if self.seed != other.seed {
+            Err(Error::MismatchSeed)
         } else if self.size() != other.size() {
             // TODO: create new error
             Err(Error::MismatchNum {
@@ -214,10 +681,13 @@ impl SigsTrait for HyperLogLog {
 
 impl Update<HyperLogLog> for KmerMinHash {
     fn update(&self, other: &mut HyperLogLog) -> Result<(), Error> {
-        for h in self.mins() {
-            other.add_hash(h);
+        if self.hash_function() != other.hash_function {
+            return Err(Error::MismatchDNAProt);
         }
-        Ok(())
+        if self.seed() != other.seed {
+            return Err(Error::MismatchSeed);
+        }
+        other.add_many(&self.mins())
     }
 }
 
@@ -227,7 +697,10 @@ mod test {
     use std::io::{BufReader, BufWriter, Read};
     use std::path::PathBuf;
 
+    use crate::encodings::HashFunctions;
+    use crate::prelude::*;
     use crate::signature::SigsTrait;
+    use crate::sketch::minhash::KmerMinHash;
     use needletail::{parse_fastx_file, parse_fastx_reader, Sequence};
 
     use super::HyperLogLog;
@@ -371,7 +844,164 @@ mod test {
 
         assert_eq!(hll_new.p, hll.p);
         assert_eq!(hll_new.q, hll.q);
-        assert_eq!(hll_new.registers, hll.registers);
+        assert_eq!(hll_new.registers(), hll.registers());
         assert_eq!(hll_new.ksize, hll.ksize);
     }
+
+    #[test]
+    fn sparse_matches_dense() {
+        let mut small = HyperLogLog::new(14, 21).unwrap();
+        let mut large = HyperLogLog::new(14, 21).unwrap();
+        let mut dense_small = HyperLogLog::new(14, 21).unwrap();
+        dense_small.densify();
+
+        for i in 0..1000u64 {
+            let hash = crate::_hash_murmur(&i.to_le_bytes(), 42);
+            small.add_hash(hash);
+            dense_small.add_hash(hash);
+        }
+        for i in 500..20000u64 {
+            large.add_hash(crate::_hash_murmur(&i.to_le_bytes(), 42));
+        }
+
+        assert!(small.is_sparse());
+        assert!(!dense_small.is_sparse());
+        assert!(!large.is_sparse());
+        assert_eq!(small, dense_small);
+        assert_eq!(small.registers(), dense_small.registers());
+        assert_eq!(small.cardinality(), dense_small.cardinality());
+        assert_eq!(small.similarity(&large), dense_small.similarity(&large));
+
+        // sparse + sparse stays sparse while small
+        let mut merged = small.clone();
+        merged.merge(&small).unwrap();
+        assert!(merged.is_sparse());
+        assert_eq!(merged, small);
+
+        // merging in a dense HLL densifies
+        let mut merged = small.clone();
+        merged.merge(&large).unwrap();
+        let mut dense_merged = dense_small.clone();
+        dense_merged.merge(&large).unwrap();
+        assert!(!merged.is_sparse());
+        assert_eq!(merged, dense_merged);
+
+        let mut merged = large.clone();
+        merged.merge(&small).unwrap();
+        assert_eq!(merged, dense_merged);
+
+        // the saved format is dense, and loading picks the compact form
+        let mut buf = Vec::new();
+        small.save_to_writer(&mut buf).unwrap();
+        assert_eq!(buf.len(), 7 + (1 << 14));
+        let loaded = HyperLogLog::from_reader(&buf[..]).unwrap();
+        assert!(loaded.is_sparse());
+        assert_eq!(loaded, small);
+
+        let json = serde_json::to_string(&small).unwrap();
+        assert_eq!(json, serde_json::to_string(&dense_small).unwrap());
+        let loaded: HyperLogLog = serde_json::from_str(&json).unwrap();
+        assert!(loaded.is_sparse());
+        assert_eq!(loaded, small);
+
+        merged.clear();
+        assert!(merged.is_sparse());
+        assert_eq!(merged.cardinality(), 0);
+    }
+
+    #[test]
+    fn buffered_add_hash_matches_add_many() {
+        // repeated hashes, and a count that leaves some entries pending
+        let hashes: Vec<u64> = (0..10_000u64)
+            .map(|i| crate::_hash_murmur(&(i % 7_000).to_le_bytes(), 42))
+            .collect();
+
+        let mut one_by_one = HyperLogLog::new(16, 21).unwrap();
+        for hash in &hashes {
+            one_by_one.add_hash(*hash);
+        }
+        let mut batched = HyperLogLog::new(16, 21).unwrap();
+        batched.add_many(&hashes).unwrap();
+
+        assert!(one_by_one.is_sparse());
+        assert_eq!(one_by_one, batched);
+        assert_eq!(one_by_one.registers(), batched.registers());
+        assert_eq!(one_by_one.cardinality(), batched.cardinality());
+
+        let mut merged = HyperLogLog::new(16, 21).unwrap();
+        merged.merge(&one_by_one).unwrap();
+        assert_eq!(merged, batched);
+    }
+
+    #[test]
+    fn add_sequence_matches_minhash_hashes() {
+        use rand::{Rng, SeedableRng};
+
+        let mut rng = rand::rngs::StdRng::seed_from_u64(1);
+        let seq: Vec<u8> = (0..5000).map(|_| b"ACGT"[rng.gen_range(0..4)]).collect();
+
+        let mut mh = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 7, false, 0);
+        mh.add_sequence(&seq, false).unwrap();
+
+        // small p densifies while adding batches, large p stays sparse
+        for p in [4, 16] {
+            let mut hll = HyperLogLog::new(p, 21)
+                .unwrap()
+                .with_hash_function(HashFunctions::Murmur64Dna, 7);
+            hll.add_sequence(&seq, false).unwrap();
+
+            let mut expected = hll.clone();
+            expected.clear();
+            for hash in mh.mins() {
+                expected.add_hash(hash);
+            }
+            assert_eq!(hll, expected);
+            assert_eq!(hll.is_sparse(), p == 16);
+        }
+    }
+
+    #[test]
+    fn hll_seed_and_hash_function() {
+        let seq = b"MVKVYAPASSANMSVGFDVLGAAVTPVDGALLGDVVTVEAAETFSLNNLGRFADKLPSEPRENIVYQCWER";
+
+        let mut mh = KmerMinHash::new(1, 30, HashFunctions::Murmur64Protein, 7, false, 0);
+        mh.add_protein(seq).unwrap();
+
+        let template = HyperLogLog::new(10, 30).unwrap();
+        let mut hll = template
+            .clone()
+            .with_hash_function(HashFunctions::Murmur64Protein, 7);
+        hll.add_protein(seq).unwrap();
+        assert_eq!(hll.seed(), 7);
+        assert_eq!(hll.hash_function(), HashFunctions::Murmur64Protein);
+
+        let mut from_mh = template
+            .clone()
+            .with_hash_function(HashFunctions::Murmur64Protein, 7);
+        mh.update(&mut from_mh).unwrap();
+        assert_eq!(hll, from_mh);
+
+        let mut default_seed = template
+            .clone()
+            .with_hash_function(HashFunctions::Murmur64Protein, 42);
+        default_seed.add_protein(seq).unwrap();
+        assert!(matches!(
+            default_seed.merge(&hll),
+            Err(crate::Error::MismatchSeed)
+        ));
+        assert!(matches!(
+            template.clone().merge(&hll),
+            Err(crate::Error::MismatchDNAProt)
+        ));
+        assert!(mh.update(&mut default_seed).is_err());
+
+        let mut buf = Vec::new();
+        hll.save_to_writer(&mut buf).unwrap();
+        assert_eq!(buf[3], 2);
+        assert_eq!(HyperLogLog::from_reader(&buf[..]).unwrap(), hll);
+
+        let json = serde_json::to_string(&hll).unwrap();
+        let loaded: HyperLogLog = serde_json::from_str(&json).unwrap();
+        assert_eq!(loaded, hll);
+    }
 }
@@ -1,15 +1,17 @@
 use std::cmp::Ordering;
 use std::collections::{BTreeMap, BTreeSet};
 use std::f64::consts::PI;
-use std::fmt::Write;
 use std::iter::Peekable;
 use std::str;
-use std::sync::Mutex;
 
 use itertools::Itertools;
+use once_cell::sync::OnceCell;
+#[cfg(feature = "parallel")]
+use rayon::prelude::*;
 use serde::de::Deserializer;
 use serde::ser::{SerializeStruct, Serializer};
 use serde::{Deserialize, Serialize};
+use stats::{median, stddev};
 use typed_builder::TypedBuilder;
 
 use crate::_hash_murmur;
@@ -33,6 +35,73 @@ pub fn scaled_for_max_hash(max_hash: u64) -> u64 {
     }
 }
 
+/// Error rate of the companion HLL; see `KmerMinHash::enable_hll`.
+pub const HLL_ERROR_RATE: f64 = 0.01;
+
+/// Combine the companion HLLs of two sketches being merged.
+///
+/// The result only counts every hash if both sides did; an empty side
+/// without an HLL doesn't contribute anything, so the other side is kept.
+fn merge_hll(
+    hll: Option<HyperLogLog>,
+    is_empty: bool,
+    other: Option<&HyperLogLog>,
+    other_is_empty: bool,
+) -> Result<Option<HyperLogLog>, Error> {
+    Ok(match (hll, other) {
+        (Some(mut hll), Some(other)) => {
+            hll.merge(other)?;
+            Some(hll)
+        }
+        (Some(hll), None) if other_is_empty => Some(hll),
+        (None, Some(other)) if is_empty => Some(other.clone()),
+        _ => None,
+    })
+}
+
+/// md5 of the decimal text of `ksize` followed by each hash, as used for
+/// signature md5sums.
+///
+/// Digits are formatted into a stack buffer and fed to md5 in blocks, so
+/// no strings are allocated per hash.
+fn compute_md5sum<'a, I>(ksize: usize, mins: I) -> String
+where
+    I: IntoIterator<Item = &'a u64>,
+{
+    const MAX_DIGITS: usize = 20; // u64::MAX has 20 digits
+    let mut buffer = [0u8; 4096];
+    let mut len = 0;
+
+    let mut md5_ctx = md5::Context::new();
+    let mut push = |mut value: u64| {
+        if len + MAX_DIGITS > buffer.len() {
+            md5_ctx.consume(&buffer[..len]);
+            len = 0;
+        }
+        let mut digits = [0u8; MAX_DIGITS];
+        let mut start = MAX_DIGITS;
+        loop {
+            start -= 1;
+            digits[start] = b'0' + (value % 10) as u8;
+            value /= 10;
+            if value == 0 {
+                break;
+            }
+        }
+        let n = MAX_DIGITS - start;
+        buffer[len..len + n].copy_from_slice(&digits[start..]);
+        len += n;
+    };
+
+    push(ksize as u64);
+    for &x in mins {
+        push(x);
+    }
+    md5_ctx.consume(&buffer[..len]);
+
+    format!("{:x}", md5_ctx.compute())
+}
+
 #[derive(Debug, TypedBuilder)]
 #[cfg_attr(
     feature = "rkyv",
@@ -57,10 +126,16 @@ pub struct KmerMinHash {
     #[builder(default)]
     abunds: Option<Vec<u64>>,
 
+    /// Optional companion HLL, fed every hash added (before the `max_hash`
+    /// filter), for estimating the number of distinct k-mers in the data.
+    #[builder(default)]
+    #[cfg_attr(feature = "rkyv", with(rkyv::with::Skip))]
+    hll: Option<HyperLogLog>,
+
     #[builder(default)]
     //#[cfg_attr(feature = "rkyv", with(rkyv::with::Lock))]
     #[cfg_attr(feature = "rkyv", with(rkyv::with::Skip))]
-    md5sum: Mutex<Option<String>>,
+    md5sum: OnceCell<String>,
 }
 
 impl PartialEq for KmerMinHash {
@@ -80,7 +155,8 @@ impl Clone for KmerMinHash {
             max_hash: self.max_hash,
             mins: self.mins.clone(),
             abunds: self.abunds.clone(),
-            md5sum: Mutex::new(Some(self.md5sum())),
+            hll: self.hll.clone(),
+            md5sum: self.md5sum.clone(),
         }
     }
 }
@@ -95,7 +171,8 @@ impl Default for KmerMinHash {
             max_hash: 0,
             mins: Vec::with_capacity(1000),
             abunds: None,
-            md5sum: Mutex::new(None),
+            hll: None,
+            md5sum: OnceCell::new(),
         }
     }
 }
@@ -108,7 +185,7 @@ impl Serialize for KmerMinHash {
         let n_fields = match &self.abunds {
             Some(_) => 8,
             _ => 7,
-        };
+        } + self.hll.is_some() as usize;
 
         let mut partial = serializer.serialize_struct("KmerMinHash", n_fields)?;
         partial.serialize_field("num", &self.num)?;
@@ -124,6 +201,10 @@ impl Serialize for KmerMinHash {
 
         partial.serialize_field("molecule", &self.hash_function.to_string())?;
 
+        if let Some(hll) = &self.hll {
+            partial.serialize_field("hll", hll)?;
+        }
+
         partial.end()
     }
 }
@@ -143,6 +224,7 @@ impl<'de> Deserialize<'de> for KmerMinHash {
             mins: Vec<u64>,
             abundances: Option<Vec<u64>>,
             molecule: String,
+            hll: Option<HyperLogLog>,
         }
 
         let tmpsig = TempSig::deserialize(deserializer)?;
@@ -175,10 +257,11 @@ impl<'de> Deserialize<'de> for KmerMinHash {
             ksize: tmpsig.ksize,
             seed: tmpsig.seed,
             max_hash: tmpsig.max_hash,
-            md5sum: Mutex::new(Some(tmpsig.md5sum)),
+            md5sum: OnceCell::with_value(tmpsig.md5sum),
             mins,
             abunds,
             hash_function,
+            hll: tmpsig.hll,
         })
     }
 }
@@ -214,7 +297,8 @@ impl KmerMinHash {
             max_hash,
             mins,
             abunds,
-            md5sum: Mutex::new(None),
+            hll: None,
+            md5sum: OnceCell::new(),
         }
     }
 
@@ -239,6 +323,10 @@ impl KmerMinHash {
         if let Some(ref mut abunds) = self.abunds {
             abunds.clear();
         }
+        if let Some(ref mut hll) = self.hll {
+            hll.clear();
+        }
+        self.reset_md5sum();
     }
 
     pub fn is_empty(&self) -> bool {
@@ -256,6 +344,10 @@ impl KmerMinHash {
             });
         }
 
+        self.hll = self
+            .hll
+            .take()
+            .map(|hll| hll.with_hash_function(h.clone(), self.seed));
         self.hash_function = h;
         Ok(())
     }
@@ -280,30 +372,54 @@ impl KmerMinHash {
         self.abunds = None;
     }
 
-    fn reset_md5sum(&self) {
-        let mut data = self.md5sum.lock().unwrap();
-        if data.is_some() {
-            *data = None;
+    /// Whether a companion HLL is collected while adding hashes.
+    pub fn track_hll(&self) -> bool {
+        self.hll.is_some()
+    }
+
+    /// Start collecting a companion HLL; like `enable_abundance`, only
+    /// allowed on an empty sketch, so the HLL sees every hash added.
+    pub fn enable_hll(&mut self) -> Result<(), Error> {
+        if !self.mins.is_empty() {
+            return Err(Error::NonEmptyMinHash {
+                message: "hll=True".into(),
+            });
         }
+
+        self.hll = Some(
+            HyperLogLog::with_error_rate(HLL_ERROR_RATE, self.ksize as usize)?
+                .with_hash_function(self.hash_function.clone(), self.seed),
+        );
+
+        Ok(())
+    }
+
+    pub fn disable_hll(&mut self) {
+        self.hll = None;
+    }
+
+    pub fn hll(&self) -> Option<&HyperLogLog> {
+        self.hll.as_ref()
+    }
+
+    /// Use `hll` as the companion HLL (when restoring a sketch, say); it
+    /// must be compatible with the one `enable_hll` creates.
+    pub fn set_hll(&mut self, hll: HyperLogLog) -> Result<(), Error> {
+        HyperLogLog::with_error_rate(HLL_ERROR_RATE, self.ksize as usize)?
+            .with_hash_function(self.hash_function.clone(), self.seed)
+            .check_compatible(&hll)?;
+        self.hll = Some(hll);
+        Ok(())
+    }
+
+    fn reset_md5sum(&mut self) {
+        self.md5sum.take();
     }
 
     pub fn md5sum(&self) -> String {
-        let mut data = self.md5sum.lock().unwrap();
-        if data.is_none() {
-            let mut buffer = String::with_capacity(20);
-
-            let mut md5_ctx = md5::Context::new();
-            write!(&mut buffer, "{}", self.ksize()).unwrap();
-            md5_ctx.consume(&buffer);
-            buffer.clear();
-            for x in &self.mins {
-                write!(&mut buffer, "{}", x).unwrap();
-                md5_ctx.consume(&buffer);
-                buffer.clear();
-            }
-            *data = Some(format!("{:x}", md5_ctx.compute()));
-        }
-        data.clone().unwrap()
+        self.md5sum
+            .get_or_init(|| compute_md5sum(self.ksize(), &self.mins))
+            .clone()
     }
 
     pub fn add_hash(&mut self, hash: u64) {
@@ -311,6 +427,12 @@ impl KmerMinHash {
     }
 
     pub fn add_hash_with_abundance(&mut self, hash: u64, abundance: u64) {
+        if abundance > 0 {
+            if let Some(hll) = &mut self.hll {
+                hll.add_hash(hash);
+            }
+        }
+
         let current_max = match self.mins.last() {
             Some(&x) => x,
             None => u64::max_value(),
@@ -404,6 +526,9 @@ impl KmerMinHash {
     }
 
     pub fn remove_hash(&mut self, hash: u64) {
+        // the companion HLL can't forget a hash, so it no longer
+        // describes the data once anything is removed.
+        self.hll = None;
         if let Ok(pos) = self.mins.binary_search(&hash) {
             if self.mins[pos] == hash {
                 self.mins.remove(pos);
@@ -416,12 +541,53 @@ impl KmerMinHash {
     }
 
     pub fn remove_from(&mut self, other: &KmerMinHash) -> Result<(), Error> {
-        for min in &other.mins {
-            self.remove_hash(*min);
+        self.remove_sorted(&other.mins);
+        Ok(())
+    }
+
+    /// Remove many hashes at once; see `remove_sorted`.
+    pub fn remove_many_sorted(&mut self, hashes: &[u64]) -> Result<(), Error> {
+        if hashes.windows(2).all(|w| w[0] <= w[1]) {
+            self.remove_sorted(hashes);
+        } else {
+            let mut hashes = hashes.to_vec();
+            hashes.sort_unstable();
+            self.remove_sorted(&hashes);
         }
         Ok(())
     }
 
+    fn remove_sorted(&mut self, hashes: &[u64]) {
+        if !hashes.is_empty() {
+            // see remove_hash
+            self.hll = None;
+        }
+
+        // both are sorted, so a single merge pass avoids paying for
+        // a binary search and a Vec::remove for every hash.
+        let mut mins = Vec::with_capacity(self.mins.len());
+        let mut abunds = self.abunds.as_ref().map(|a| Vec::with_capacity(a.len()));
+
+        let mut other_iter = hashes.iter().peekable();
+        for (i, hash) in self.mins.iter().enumerate() {
+            while other_iter.next_if(|&h| h < hash).is_some() {}
+            if other_iter.peek() == Some(&hash) {
+                continue;
+            }
+
+            mins.push(*hash);
+            if let (Some(new_abunds), Some(old_abunds)) = (abunds.as_mut(), self.abunds.as_ref()) {
+                new_abunds.push(old_abunds[i]);
+            }
+        }
+
+        if mins.len() != self.mins.len() {
+            self.mins = mins;
+            self.abunds = abunds;
+            self.reset_md5sum();
+        }
+    }
+
     pub fn remove_many<T: IntoIterator<Item = u64>>(&mut self, hashes: T) -> Result<(), Error> {
         for min in hashes {
             self.remove_hash(min);
@@ -431,6 +597,12 @@ impl KmerMinHash {
 
     pub fn merge(&mut self, other: &KmerMinHash) -> Result<(), Error> {
         self.check_compatible(other)?;
+        self.hll = merge_hll(
+            self.hll.take(),
+            self.is_empty(),
+            other.hll.as_ref(),
+            other.is_empty(),
+        )?;
         let max_size = self.mins.len() + other.mins.len();
 
         let mut merged: Vec<u64> = Vec::with_capacity(max_size);
@@ -523,10 +695,7 @@ impl KmerMinHash {
     }
 
     pub fn add_many(&mut self, hashes: &[u64]) -> Result<(), Error> {
-        for min in hashes {
-            self.add_hash(*min);
-        }
-        Ok(())
+        self.add_many_sorted(hashes, None)
     }
 
     pub fn add_many_with_abund(&mut self, hashes: &[(u64, u64)]) -> Result<(), Error> {
@@ -536,6 +705,137 @@ impl KmerMinHash {
         Ok(())
     }
 
+    /// Add many hashes at once, with their abundances if given.
+    ///
+    /// Same as calling `add_hash_with_abundance` for each hash (so an
+    /// abundance of 0 removes the hash), but the new hashes are merged into
+    /// the sketch in a single pass. Input that is already sorted is used
+    /// as-is; otherwise it is sorted first.
+    pub fn add_many_sorted(&mut self, hashes: &[u64], abunds: Option<&[u64]>) -> Result<(), Error> {
+        if hashes.is_empty() {
+            return Ok(());
+        }
+        if let Some(abunds) = abunds {
+            if abunds.len() != hashes.len() {
+                return Err(Error::Internal {
+                    message: "hashes and abundances must have the same length".into(),
+                });
+            }
+        }
+        if abunds.map_or(false, |abunds| abunds.contains(&0)) {
+            // an abundance of 0 removes the hash; see remove_hash
+            self.hll = None;
+        }
+        if let Some(hll) = &mut self.hll {
+            hll.add_many(hashes)?;
+        }
+
+        if hashes.windows(2).all(|w| w[0] <= w[1]) {
+            let pairs = hashes.iter().copied().zip(
+                abunds
+                    .into_iter()
+                    .flatten()
+                    .copied()
+                    .chain(std::iter::repeat(1)),
+            );
+            self.merge_sorted(pairs, hashes.len());
+        } else {
+            let mut pairs: Vec<(u64, u64)> = match abunds {
+                Some(abunds) => hashes.iter().copied().zip(abunds.iter().copied()).collect(),
+                None => hashes.iter().map(|&h| (h, 1)).collect(),
+            };
+            // stable, so repeated hashes (and removals with a 0 abundance)
+            // apply in input order, as in the already-sorted path.
+            pairs.sort_by_key(|&(h, _)| h);
+            self.merge_sorted(pairs.into_iter(), hashes.len());
+        }
+        Ok(())
+    }
+
+    /// Merge (hash, abundance) pairs, sorted by hash, into the sketch.
+    fn merge_sorted<I: Iterator<Item = (u64, u64)>>(&mut self, pairs: I, size_hint: usize) {
+        if self.num == 0 && self.max_hash == 0 {
+            // always empty, like add_hash_with_abundance
+            return;
+        }
+        let max_hash = if self.max_hash == 0 {
+            u64::max_value()
+        } else {
+            self.max_hash
+        };
+
+        fn push(mins: &mut Vec<u64>, abunds: &mut Option<Vec<u64>>, hash: u64, abund: u64) {
+            // repeated hashes add up, like repeated add_hash_with_abundance.
+            if mins.last() == Some(&hash) {
+                if let Some(abunds) = abunds {
+                    *abunds.last_mut().unwrap() += abund;
+                }
+            } else {
+                mins.push(hash);
+                if let Some(abunds) = abunds {
+                    abunds.push(abund);
+                }
+            }
+        }
+
+        // num sketches only keep the smallest `num` hashes; one extra hash
+        // is kept so that a removal of the last one is still handled.
+        let limit = if self.num == 0 {
+            usize::max_value()
+        } else {
+            self.num as usize + 1
+        };
+
+        let capacity = (self.mins.len() + size_hint).min(limit);
+        let mut mins = Vec::with_capacity(capacity);
+        let mut abunds = self.abunds.as_ref().map(|_| Vec::with_capacity(capacity));
+
+        let old_abunds = self.abunds.as_deref();
+        let old_abund = |i: usize| old_abunds.map_or(1, |a| a[i]);
+        let mut old = self.mins.iter().copied().enumerate().peekable();
+
+        for (hash, abund) in pairs.take_while(|&(h, _)| h <= max_hash) {
+            if mins.len() >= limit {
+                break;
+            }
+            while let Some((i, h)) = old.next_if(|&(_, h)| h < hash) {
+                push(&mut mins, &mut abunds, h, old_abund(i));
+            }
+            if let Some((i, _)) = old.next_if(|&(_, h)| h == hash) {
+                push(&mut mins, &mut abunds, hash, old_abund(i));
+            }
+
+            if abund == 0 {
+                // an abundance of 0 removes the hash
+                if mins.last() == Some(&hash) {
+                    mins.pop();
+                    if let Some(abunds) = abunds.as_mut() {
+                        abunds.pop();
+                    }
+                }
+            } else {
+                push(&mut mins, &mut abunds, hash, abund);
+            }
+        }
+        for (i, h) in old {
+            if mins.len() >= limit {
+                break;
+            }
+            push(&mut mins, &mut abunds, h, old_abund(i));
+        }
+
+        if self.num != 0 {
+            mins.truncate(self.num as usize);
+            if let Some(abunds) = abunds.as_mut() {
+                abunds.truncate(self.num as usize);
+            }
+        }
+
+        self.mins = mins;
+        self.abunds = abunds;
+        self.reset_md5sum();
+    }
+
     pub fn count_common(&self, other: &KmerMinHash, downsample: bool) -> Result<u64, Error> {
         if downsample && self.max_hash != other.max_hash {
             let (first, second) = if self.max_hash < other.max_hash {
@@ -543,22 +843,31 @@ impl KmerMinHash {
             } else {
                 (other, self)
             };
-            let downsampled_mh = second.downsample_max_hash(first.max_hash)?;
-            first.count_common(&downsampled_mh, false)
+            first
+                .view()
+                .count_common(&second.downsample_view(first.max_hash), false)
         } else {
-            self.check_compatible(other)?;
-            let iter = if self.size() < other.size() {
-                Intersection::new(self.mins.iter(), other.mins.iter())
-            } else {
-                Intersection::new(other.mins.iter(), self.mins.iter())
-            };
-
-            Ok(iter.count() as u64)
+            self.view().count_common(&other.view(), false)
         }
     }
 
     pub fn intersection(&self, other: &KmerMinHash) -> Result<(Vec<u64>, u64), Error> {
+        let mut common = vec![];
+        let union_size = self.intersection_into(other, &mut common)?;
+        Ok((common, union_size))
+    }
+
+    /// Like `intersection`, but writes the common hashes into `common`
+    /// (replacing its contents) so its allocation can be reused.
+    ///
+    /// Returns the size of the union.
+    pub fn intersection_into(
+        &self,
+        other: &KmerMinHash,
+        common: &mut Vec<u64>,
+    ) -> Result<u64, Error> {
         self.check_compatible(other)?;
+        common.clear();
 
         if self.num != 0 {
             // Intersection for regular MinHash sketches
@@ -581,43 +890,17 @@ impl KmerMinHash {
             let i1: Vec<u64> = it1.cloned().collect();
             let it2 = Intersection::new(i1.iter(), combined_mh.mins.iter());
 
-            let common: Vec<u64> = it2.cloned().collect();
-            Ok((common, combined_mh.mins.len() as u64))
+            common.extend(it2.cloned());
+            Ok(combined_mh.mins.len() as u64)
         } else {
-            Ok(intersection(self.mins.iter(), other.mins.iter()))
+            Ok(intersection(self.mins.iter(), other.mins.iter(), common))
         }
     }
 
     // FIXME: intersection_size and count_common should be the same?
     // (for scaled minhashes)
     pub fn intersection_size(&self, other: &KmerMinHash) -> Result<(u64, u64), Error> {
-        self.check_compatible(other)?;
-
-        if self.num != 0 {
-            // Intersection for regular MinHash sketches
-            let mut combined_mh = KmerMinHash::new(
-                self.scaled(),
-                self.ksize,
-                self.hash_function.clone(),
-                self.seed,
-                self.abunds.is_some(),
-                self.num,
-            );
-
-            combined_mh.merge(self)?;
-            combined_mh.merge(other)?;
-
-            let it1 = Intersection::new(self.mins.iter(), other.mins.iter());
-
-            // TODO: there is probably a way to avoid this Vec here,
-            // and pass the it1 as left in it2.
-            let i1: Vec<u64> = it1.cloned().collect();
-            let it2 = Intersection::new(i1.iter(), combined_mh.mins.iter());
-
-            Ok((it2.count() as u64, combined_mh.mins.len() as u64))
-        } else {
-            Ok(intersection_size(self.mins.iter(), other.mins.iter()))
-        }
+        self.view().intersection_size(&other.view())
     }
 
     // calculate Jaccard similarity, ignoring abundance.
@@ -633,50 +916,7 @@ impl KmerMinHash {
     // compare two minhashes, with abundance;
     // calculate their angular similarity.
     pub fn angular_similarity(&self, other: &KmerMinHash) -> Result<f64, Error> {
-        self.check_compatible(other)?;
-
-        if self.abunds.is_none() || other.abunds.is_none() {
-            return Err(Error::NeedsAbundanceTracking);
-        }
-
-        // TODO: check which one is smaller, swap around if needed
-
-        let abunds = self.abunds.as_ref().unwrap();
-        let other_abunds = other.abunds.as_ref().unwrap();
-
-        let mut prod = 0;
-        let mut other_iter = other.mins.iter().enumerate();
-        let mut next_hash = other_iter.next();
-        let a_sq: u64 = abunds.iter().map(|a| (a * a)).sum();
-        let b_sq: u64 = other_abunds.iter().map(|a| (a * a)).sum();
-
-        for (i, hash) in self.mins.iter().enumerate() {
-            while let Some((j, k)) = next_hash {
-                match k.cmp(hash) {
-                    Ordering::Less => next_hash = other_iter.next(),
-                    Ordering::Equal => {
-                        // Calling `get_unchecked` here is safe since
-                        // both `i` and `j` are valid indices
-                        // (`i` and `j` came from valid iterator calls)
-                        unsafe {
-                            prod += abunds.get_unchecked(i) * other_abunds.get_unchecked(j);
-                        }
-                        break;
-                    }
-                    Ordering::Greater => break,
-                }
-            }
-        }
-
-        let norm_a = (a_sq as f64).sqrt();
-        let norm_b = (b_sq as f64).sqrt();
-
-        if norm_a == 0. || norm_b == 0. {
-            return Ok(0.0);
-        }
-        let prod = f64::min(prod as f64 / (norm_a * norm_b), 1.);
-        let distance = 2. * prod.acos() / PI;
-        Ok(1. - distance)
+        self.view().angular_similarity(&other.view())
     }
 
     pub fn similarity(
@@ -691,12 +931,14 @@ impl KmerMinHash {
             } else {
                 (other, self)
             };
-            let downsampled_mh = second.downsample_max_hash(first.max_hash)?;
-            first.similarity(&downsampled_mh, ignore_abundance, false)
-        } else if ignore_abundance || self.abunds.is_none() || other.abunds.is_none() {
-            self.jaccard(other)
+            first.view().similarity(
+                &second.downsample_view(first.max_hash),
+                ignore_abundance,
+                false,
+            )
         } else {
-            self.angular_similarity(other)
+            self.view()
+                .similarity(&other.view(), ignore_abundance, false)
         }
     }
 
@@ -712,6 +954,11 @@ impl KmerMinHash {
         self.mins.clone()
     }
 
+    /// The hashes, in increasing order, without copying them.
+    pub fn mins_slice(&self) -> &[u64] {
+        &self.mins
+    }
+
     pub fn iter_mins(&self) -> impl Iterator<Item = &u64> {
         self.mins.iter()
     }
@@ -720,24 +967,105 @@ impl KmerMinHash {
         self.abunds.clone()
     }
 
+    /// The abundances, in the same order as `mins_slice`, without copying.
+    pub fn abunds_slice(&self) -> Option<&[u64]> {
+        self.abunds.as_deref()
+    }
+
     // create a downsampled copy of self
     pub fn downsample_max_hash(&self, max_hash: u64) -> Result<KmerMinHash, Error> {
-        let scaled = scaled_for_max_hash(max_hash);
+        let mut new_mh = KmerMinHash::builder()
+            .num(self.num)
+            .ksize(self.ksize)
+            .build();
+        self.downsample_max_hash_into(max_hash, &mut new_mh);
+        Ok(new_mh)
+    }
 
-        let mut new_mh = KmerMinHash::new(
-            scaled,
-            self.ksize,
-            self.hash_function.clone(),
-            self.seed,
-            self.abunds.is_some(),
-            self.num,
-        );
-        if self.abunds.is_some() {
-            new_mh.add_many_with_abund(&self.to_vec_abunds())?;
-        } else {
-            new_mh.add_many(&self.mins)?;
+    /// Like `downsample_max_hash`, but overwrites `target` instead of
+    /// allocating a new sketch, reusing its hash and abundance buffers.
+    pub fn downsample_max_hash_into(&self, max_hash: u64, target: &mut KmerMinHash) {
+        // same max_hash as a sketch created with the equivalent scaled
+        let max_hash = max_hash_for_scaled(scaled_for_max_hash(max_hash));
+
+        target.num = self.num;
+        target.ksize = self.ksize;
+        target.hash_function = self.hash_function.clone();
+        target.seed = self.seed;
+        target.max_hash = max_hash;
+        // the HLL counts the whole dataset, so it is not downsampled.
+        target.hll.clone_from(&self.hll);
+
+        let end = prefix_len(&self.mins, max_hash, self.num);
+
+        target.mins.clear();
+        target.mins.extend_from_slice(&self.mins[..end]);
+
+        match (&self.abunds, &mut target.abunds) {
+            (Some(abunds), Some(target_abunds)) => {
+                target_abunds.clear();
+                target_abunds.extend_from_slice(&abunds[..end]);
+            }
+            (Some(abunds), None) => target.abunds = Some(abunds[..end].to_vec()),
+            (None, _) => target.abunds = None,
         }
-        Ok(new_mh)
+
+        target.reset_md5sum();
+    }
+
+    /// Downsample in place: mins are sorted, so this only truncates
+    /// `mins` (and `abunds`) after a binary search, without copying.
+    pub fn downsample_max_hash_in_place(&mut self, max_hash: u64) {
+        let max_hash = max_hash_for_scaled(scaled_for_max_hash(max_hash));
+        let end = prefix_len(&self.mins, max_hash, self.num);
+
+        self.max_hash = max_hash;
+        self.mins.truncate(end);
+        if let Some(abunds) = &mut self.abunds {
+            abunds.truncate(end);
+        }
+        self.reset_md5sum();
+    }
+
+    /// Like `downsample_scaled`, but truncates self instead of copying;
+    /// see `downsample_max_hash_in_place`.
+    pub fn downsample_scaled_in_place(&mut self, scaled: u64) {
+        self.downsample_max_hash_in_place(max_hash_for_scaled(scaled));
+    }
+
+    /// A borrowed view of the whole sketch.
+    pub fn view(&self) -> MinHashView<'_> {
+        MinHashView {
+            num: self.num,
+            ksize: self.ksize,
+            hash_function: &self.hash_function,
+            seed: self.seed,
+            max_hash: self.max_hash,
+            mins: &self.mins,
+            abunds: self.abunds.as_deref(),
+        }
+    }
+
+    /// A borrowed view of the sketch downsampled to `max_hash`.
+    ///
+    /// This is what `downsample_max_hash` would return, but it only costs
+    /// a binary search over `mins`.
+    pub fn downsample_view(&self, max_hash: u64) -> MinHashView<'_> {
+        let max_hash = max_hash_for_scaled(scaled_for_max_hash(max_hash));
+        let end = prefix_len(&self.mins, max_hash, self.num);
+
+        MinHashView {
+            max_hash,
+            mins: &self.mins[..end],
+            abunds: self.abunds.as_deref().map(|abunds| &abunds[..end]),
+            ..self.view()
+        }
+    }
+
+    /// A borrowed view of the sketch downsampled to `scaled`; see
+    /// `downsample_view`.
+    pub fn downsample_scaled_view(&self, scaled: u64) -> MinHashView<'_> {
+        self.downsample_view(max_hash_for_scaled(scaled))
     }
 
     pub fn sum_abunds(&self) -> u64 {
@@ -765,7 +1093,9 @@ impl KmerMinHash {
     }
 
     pub fn as_hll(&self) -> HyperLogLog {
-        let mut hll = HyperLogLog::with_error_rate(0.01, self.ksize()).unwrap();
+        let mut hll = HyperLogLog::with_error_rate(0.01, self.ksize())
+            .unwrap()
+            .with_hash_function(self.hash_function.clone(), self.seed);
 
         for h in &self.mins {
             hll.add_hash(*h)
@@ -774,10 +1104,12 @@ impl KmerMinHash {
         hll
     }
 
-    // Approximate total number of kmers
-    // this could be improved by generating an HLL estimate while sketching instead
-    // (for scaled minhashes)
+    // Approximate total number of kmers: the companion HLL estimate if
+    // one was collected while sketching, otherwise size * scaled.
     pub fn n_unique_kmers(&self) -> u64 {
+        if let Some(hll) = &self.hll {
+            return hll.cardinality() as u64;
+        }
         self.size() as u64 * self.scaled() // + (self.ksize - 1) for bp estimation
     }
 
@@ -787,6 +1119,12 @@ impl KmerMinHash {
         self.downsample_max_hash(max_hash)
     }
 
+    /// Like `downsample_scaled`, but overwrites `target`; see
+    /// `downsample_max_hash_into`.
+    pub fn downsample_scaled_into(&self, scaled: u64, target: &mut KmerMinHash) {
+        self.downsample_max_hash_into(max_hash_for_scaled(scaled), target);
+    }
+
     pub fn inflate(&mut self, abunds_from: &KmerMinHash) -> Result<(), Error> {
         self.check_compatible(abunds_from)?;
 
@@ -813,38 +1151,47 @@ impl KmerMinHash {
 
         self.mins = mins;
         self.abunds = Some(abunds);
+        // only the intersection is kept, which the HLL doesn't describe.
+        self.hll = None;
 
         self.reset_md5sum();
         Ok(())
     }
 
     pub fn inflated_abundances(&self, abunds_from: &KmerMinHash) -> Result<(Vec<u64>, u64), Error> {
+        self.view().inflated_abundances(&abunds_from.view())
+    }
+
+    /// Intersection, union and abundance statistics against `other`; see
+    /// `MinHashView::comparison_stats`.
+    pub fn comparison_stats(
+        &self,
+        other: &KmerMinHash,
+        downsample: bool,
+    ) -> Result<ComparisonStats, Error> {
+        self.view().comparison_stats(&other.view(), downsample)
+    }
+
+    // sum of the abundances (taken from abunds_from) for all hashes in self.
+    // Same as the total from inflated_abundances, but without building
+    // the intermediate Vec. Hashes are looked up in abunds_from, so this
+    // is cheap when self is much smaller than abunds_from.
+    pub fn inflated_sum_abundances(&self, abunds_from: &KmerMinHash) -> Result<u64, Error> {
         self.check_compatible(abunds_from)?;
         // check that abunds_from has abundances
-        if abunds_from.abunds.is_none() {
-            return Err(Error::NeedsAbundanceTracking);
-        }
-
-        let self_iter = self.mins.iter();
-        let abunds_iter = abunds_from.abunds.as_ref().unwrap().iter();
-        let abunds_from_iter = abunds_from.mins.iter().zip(abunds_iter);
+        let abunds = match &abunds_from.abunds {
+            Some(abunds) => abunds,
+            None => return Err(Error::NeedsAbundanceTracking),
+        };
 
-        let (abundances, total_abundance): (Vec<u64>, u64) = self_iter
-            .merge_join_by(abunds_from_iter, |&self_val, &(other_val, _)| {
-                self_val.cmp(other_val)
-            })
-            .filter_map(|either| match either {
-                itertools::EitherOrBoth::Both(_self_val, (_other_val, other_abund)) => {
-                    Some(*other_abund)
-                }
-                _ => None,
-            })
-            .fold((Vec::new(), 0u64), |(mut acc_vec, acc_sum), abund| {
-                acc_vec.push(abund);
-                (acc_vec, acc_sum + abund)
-            });
+        let total = self
+            .mins
+            .iter()
+            .filter_map(|hash| abunds_from.mins.binary_search(hash).ok())
+            .map(|pos| abunds[pos])
+            .sum();
 
-        Ok((abundances, total_abundance))
+        Ok(total)
     }
 }
 
@@ -902,6 +1249,395 @@ impl SigsTrait for KmerMinHash {
     }
 }
 
+/// Number of leading `mins` kept when downsampling to `max_hash`.
+///
+/// `mins` are sorted, so a downsampled sketch is always a prefix of them.
+fn prefix_len(mins: &[u64], max_hash: u64, num: u32) -> usize {
+    if max_hash == 0 {
+        if num == 0 {
+            0
+        } else {
+            mins.len()
+        }
+    } else {
+        mins.partition_point(|&hash| hash <= max_hash)
+    }
+}
+
+/// A borrowed, possibly downsampled, view of a `KmerMinHash`.
+///
+/// Created with `KmerMinHash::view` or `KmerMinHash::downsample_view`.
+/// Comparisons on views behave like the same comparisons on the sketch
+/// returned by `downsample_max_hash`, without copying the hashes.
+#[derive(Debug, Clone, Copy)]
+pub struct MinHashView<'a> {
+    num: u32,
+    ksize: u32,
+    hash_function: &'a HashFunctions,
+    seed: u64,
+    max_hash: u64,
+    mins: &'a [u64],
+    abunds: Option<&'a [u64]>,
+}
+
+impl<'a> MinHashView<'a> {
+    pub fn num(&self) -> u32 {
+        self.num
+    }
+
+    pub fn ksize(&self) -> usize {
+        self.ksize as usize
+    }
+
+    pub fn seed(&self) -> u64 {
+        self.seed
+    }
+
+    pub fn max_hash(&self) -> u64 {
+        self.max_hash
+    }
+
+    pub fn scaled(&self) -> u64 {
+        scaled_for_max_hash(self.max_hash)
+    }
+
+    pub fn size(&self) -> usize {
+        self.mins.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.mins.is_empty()
+    }
+
+    pub fn mins(&self) -> &'a [u64] {
+        self.mins
+    }
+
+    pub fn abunds(&self) -> Option<&'a [u64]> {
+        self.abunds
+    }
+
+    /// Copy the view into a new, owned sketch.
+    pub fn to_minhash(&self) -> KmerMinHash {
+        KmerMinHash {
+            num: self.num,
+            ksize: self.ksize,
+            hash_function: self.hash_function.clone(),
+            seed: self.seed,
+            max_hash: self.max_hash,
+            mins: self.mins.to_vec(),
+            abunds: self.abunds.map(|abunds| abunds.to_vec()),
+            hll: None,
+            md5sum: OnceCell::new(),
+        }
+    }
+
+    /// Downsample the view further; see `KmerMinHash::downsample_view`.
+    pub fn downsample_view(&self, max_hash: u64) -> MinHashView<'a> {
+        let max_hash = max_hash_for_scaled(scaled_for_max_hash(max_hash));
+        let end = prefix_len(self.mins, max_hash, self.num);
+
+        MinHashView {
+            max_hash,
+            mins: &self.mins[..end],
+            abunds: self.abunds.map(|abunds| &abunds[..end]),
+            ..*self
+        }
+    }
+
+    pub fn check_compatible(&self, other: &MinHashView) -> Result<(), Error> {
+        if self.ksize != other.ksize {
+            return Err(Error::MismatchKSizes);
+        }
+        if self.hash_function != other.hash_function {
+            // TODO: fix this error
+            return Err(Error::MismatchDNAProt);
+        }
+        if self.max_hash != other.max_hash {
+            return Err(Error::MismatchScaled);
+        }
+        if self.seed != other.seed {
+            return Err(Error::MismatchSeed);
+        }
+        Ok(())
+    }
+
+    pub fn count_common(&self, other: &MinHashView, downsample: bool) -> Result<u64, Error> {
+        if downsample && self.max_hash != other.max_hash {
+            let (first, second) = if self.max_hash < other.max_hash {
+                (self, other)
+            } else {
+                (other, self)
+            };
+            first.count_common(&second.downsample_view(first.max_hash), false)
+        } else {
+            self.check_compatible(other)?;
+            let iter = if self.size() < other.size() {
+                Intersection::new(self.mins.iter(), other.mins.iter())
+            } else {
+                Intersection::new(other.mins.iter(), self.mins.iter())
+            };
+
+            Ok(iter.count() as u64)
+        }
+    }
+
+    pub fn intersection_size(&self, other: &MinHashView) -> Result<(u64, u64), Error> {
+        self.check_compatible(other)?;
+
+        if self.num != 0 {
+            // Intersection for regular MinHash sketches: only the `num`
+            // smallest hashes of the union are considered.
+            let (common, union_size) = self
+                .mins
+                .iter()
+                .merge_join_by(other.mins.iter(), |a, b| a.cmp(b))
+                .take(self.num as usize)
+                .fold((0u64, 0u64), |(common, union_size), either| match either {
+                    itertools::EitherOrBoth::Both(..) => (common + 1, union_size + 1),
+                    _ => (common, union_size + 1),
+                });
+            Ok((common, union_size))
+        } else {
+            Ok(intersection_size(self.mins.iter(), other.mins.iter()))
+        }
+    }
+
+    // calculate Jaccard similarity, ignoring abundance.
+    pub fn jaccard(&self, other: &MinHashView) -> Result<f64, Error> {
+        let (common, size) = self.intersection_size(other)?;
+        Ok(common as f64 / u64::max(1, size) as f64)
+    }
+
+    pub fn angular_similarity(&self, other: &MinHashView) -> Result<f64, Error> {
+        self.check_compatible(other)?;
+
+        if self.abunds.is_none() || other.abunds.is_none() {
+            return Err(Error::NeedsAbundanceTracking);
+        }
+
+        // TODO: check which one is smaller, swap around if needed
+
+        let abunds = self.abunds.unwrap();
+        let other_abunds = other.abunds.unwrap();
+
+        let mut prod = 0;
+        let mut other_iter = other.mins.iter().enumerate();
+        let mut next_hash = other_iter.next();
+        let a_sq: u64 = abunds.iter().map(|a| (a * a)).sum();
+        let b_sq: u64 = other_abunds.iter().map(|a| (a * a)).sum();
+
+        for (i, hash) in self.mins.iter().enumerate() {
+            while let Some((j, k)) = next_hash {
+                match k.cmp(hash) {
+                    Ordering::Less => next_hash = other_iter.next(),
+                    Ordering::Equal => {
+                        // Calling `get_unchecked` here is safe since
+                        // both `i` and `j` are valid indices
+                        // (`i` and `j` came from valid iterator calls)
+                        unsafe {
+                            prod += abunds.get_unchecked(i) * other_abunds.get_unchecked(j);
+                        }
+                        break;
+                    }
+                    Ordering::Greater => break,
+                }
+            }
+        }
+
+        let norm_a = (a_sq as f64).sqrt();
+        let norm_b = (b_sq as f64).sqrt();
+
+        if norm_a == 0. || norm_b == 0. {
+            return Ok(0.0);
+        }
+        let prod = f64::min(prod as f64 / (norm_a * norm_b), 1.);
+        let distance = 2. * prod.acos() / PI;
+        Ok(1. - distance)
+    }
+
+    pub fn similarity(
+        &self,
+        other: &MinHashView,
+        ignore_abundance: bool,
+        downsample: bool,
+    ) -> Result<f64, Error> {
+        if downsample && self.max_hash != other.max_hash {
+            let (first, second) = if self.max_hash < other.max_hash {
+                (self, other)
+            } else {
+                (other, self)
+            };
+            first.similarity(
+                &second.downsample_view(first.max_hash),
+                ignore_abundance,
+                false,
+            )
+        } else if ignore_abundance || self.abunds.is_none() || other.abunds.is_none() {
+            self.jaccard(other)
+        } else {
+            self.angular_similarity(other)
+        }
+    }
+
+    pub fn inflated_abundances(&self, abunds_from: &MinHashView) -> Result<(Vec<u64>, u64), Error> {
+        self.check_compatible(abunds_from)?;
+        // check that abunds_from has abundances
+        if abunds_from.abunds.is_none() {
+            return Err(Error::NeedsAbundanceTracking);
+        }
+
+        let self_iter = self.mins.iter();
+        let abunds_iter = abunds_from.abunds.unwrap().iter();
+        let abunds_from_iter = abunds_from.mins.iter().zip(abunds_iter);
+
+        let (abundances, total_abundance): (Vec<u64>, u64) = self_iter
+            .merge_join_by(abunds_from_iter, |&self_val, &(other_val, _)| {
+                self_val.cmp(other_val)
+            })
+            .filter_map(|either| match either {
+                itertools::EitherOrBoth::Both(_self_val, (_other_val, other_abund)) => {
+                    Some(*other_abund)
+                }
+                _ => None,
+            })
+            .fold((Vec::new(), 0u64), |(mut acc_vec, acc_sum), abund| {
+                acc_vec.push(abund);
+                (acc_vec, acc_sum + abund)
+            });
+
+        Ok((abundances, total_abundance))
+    }
+
+    /// Compute all the `ComparisonStats` between self and other in a
+    /// single merge pass over their hashes.
+    ///
+    /// Abundance statistics are taken from self. With `downsample` the
+    /// sketch with the lower scaled is viewed at the higher one first.
+    pub fn comparison_stats(
+        &self,
+        other: &MinHashView,
+        downsample: bool,
+    ) -> Result<ComparisonStats, Error> {
+        if downsample && self.max_hash != other.max_hash {
+            return if self.max_hash < other.max_hash {
+                self.comparison_stats(&other.downsample_view(self.max_hash), false)
+            } else {
+                self.downsample_view(other.max_hash)
+                    .comparison_stats(other, false)
+            };
+        }
+        self.check_compatible(other)?;
+
+        let mut stats = ComparisonStats {
+            ksize: self.ksize,
+            scaled: self.scaled(),
+            self_size: self.size() as u64,
+            other_size: other.size() as u64,
+            self_total_abund: self.abunds.map_or(self.size() as u64, |a| a.iter().sum()),
+            other_total_abund: other.abunds.map_or(other.size() as u64, |a| a.iter().sum()),
+            ..Default::default()
+        };
+
+        // num sketches only compare the `num` smallest hashes of the union
+        let limit = if self.num != 0 {
+            self.num as u64
+        } else {
+            u64::MAX
+        };
+        let mut common_abunds = vec![];
+
+        let (mut i, mut j) = (0, 0);
+        while i < self.mins.len() && j < other.mins.len() && stats.union_size < limit {
+            match self.mins[i].cmp(&other.mins[j]) {
+                Ordering::Less => i += 1,
+                Ordering::Greater => j += 1,
+                Ordering::Equal => {
+                    let self_abund = self.abunds.map_or(1, |a| a[i]);
+                    stats.common += 1;
+                    stats.self_common_abund += self_abund;
+                    stats.other_common_abund += other.abunds.map_or(1, |a| a[j]);
+                    if self.abunds.is_some() {
+                        common_abunds.push(self_abund);
+                    }
+                    i += 1;
+                    j += 1;
+                }
+            }
+            stats.union_size += 1;
+        }
+        let remaining = (self.mins.len() - i + other.mins.len() - j) as u64;
+        stats.union_size = u64::min(limit, stats.union_size + remaining);
+
+        if stats.common > 0 {
+            stats.mean_abund = stats.self_common_abund as f64 / stats.common as f64;
+            if self.abunds.is_some() {
+                stats.median_abund = median(common_abunds.iter().cloned()).unwrap();
+                stats.std_abund = stddev(common_abunds.iter().cloned());
+            } else {
+                stats.median_abund = 1.0;
+            }
+        }
+
+        Ok(stats)
+    }
+}
+
+/// Statistics comparing two sketches, all gathered in one merge pass by
+/// `MinHashView::comparison_stats`.
+///
+/// Abundances are counted as 1 for sketches without abundance tracking.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+#[repr(C)]
+pub struct ComparisonStats {
+    /// k-mer size of the compared sketches.
+    pub ksize: u32,
+    /// scaled of the compared sketches (0 for num sketches).
+    pub scaled: u64,
+    /// Number of hashes in self.
+    pub self_size: u64,
+    /// Number of hashes in other.
+    pub other_size: u64,
+    /// Number of hashes present in both sketches.
+    pub common: u64,
+    /// Number of hashes present in either sketch.
+    pub union_size: u64,
+    /// Sum of all abundances in self.
+    pub self_total_abund: u64,
+    /// Sum of all abundances in other.
+    pub other_total_abund: u64,
+    /// Sum of the abundances in self of the common hashes.
+    pub self_common_abund: u64,
+    /// Sum of the abundances in other of the common hashes.
+    pub other_common_abund: u64,
+    /// Mean abundance in self of the common hashes.
+    pub mean_abund: f64,
+    /// Median abundance in self of the common hashes.
+    pub median_abund: f64,
+    /// Standard deviation of the abundances in self of the common hashes.
+    pub std_abund: f64,
+}
+
+impl ComparisonStats {
+    /// Fraction of self contained in other.
+    pub fn containment(&self) -> f64 {
+        self.common as f64 / u64::max(1, self.self_size) as f64
+    }
+
+    /// Fraction of other contained in self.
+    pub fn other_containment(&self) -> f64 {
+        self.common as f64 / u64::max(1, self.other_size) as f64
+    }
+
+    pub fn max_containment(&self) -> f64 {
+        self.common as f64 / u64::max(1, u64::min(self.self_size, self.other_size)) as f64
+    }
+
+    pub fn jaccard(&self) -> f64 {
+        self.common as f64 / u64::max(1, self.union_size) as f64
+    }
+}
+
 struct Intersection<T, I: Iterator<Item = T>> {
     iter: Peekable<I>,
     other: Peekable<I>,
@@ -942,6 +1678,85 @@ impl<T: Ord, I: Iterator<Item = T>> Iterator for Intersection<T, I> {
     }
 }
 
+fn check_out_len(expected: usize, out: usize) -> Result<(), Error> {
+    if expected != out {
+        return Err(Error::Internal {
+            message: format!("output has {} entries, expected {}", out, expected),
+        });
+    }
+    Ok(())
+}
+
+/// Counts the hashes `query` has in common with each sketch in `others`,
+/// writing one count per sketch into `out`.
+pub fn count_common_many(
+    query: &KmerMinHash,
+    others: &[&KmerMinHash],
+    downsample: bool,
+    out: &mut [u64],
+) -> Result<(), Error> {
+    check_out_len(others.len(), out.len())?;
+
+    #[cfg(feature = "parallel")]
+    let iter = out.par_iter_mut().zip(others.par_iter());
+
+    #[cfg(not(feature = "parallel"))]
+    let mut iter = out.iter_mut().zip(others.iter());
+
+    iter.try_for_each(|(count, other)| {
+        *count = query.count_common(other, downsample)?;
+        Ok(())
+    })
+}
+
+/// Similarity between `query` and each sketch in `others`, as computed by
+/// [`KmerMinHash::similarity`], written into `out`.
+pub fn similarity_many(
+    query: &KmerMinHash,
+    others: &[&KmerMinHash],
+    ignore_abundance: bool,
+    downsample: bool,
+    out: &mut [f64],
+) -> Result<(), Error> {
+    check_out_len(others.len(), out.len())?;
+
+    #[cfg(feature = "parallel")]
+    let iter = out.par_iter_mut().zip(others.par_iter());
+
+    #[cfg(not(feature = "parallel"))]
+    let mut iter = out.iter_mut().zip(others.iter());
+
+    iter.try_for_each(|(sim, other)| {
+        *sim = query.similarity(other, ignore_abundance, downsample)?;
+        Ok(())
+    })
+}
+
+/// Similarity between every sketch in `rows` and every sketch in `cols`,
+/// written into `out` as a row-major `rows.len() x cols.len()` matrix.
+pub fn similarity_tile(
+    rows: &[&KmerMinHash],
+    cols: &[&KmerMinHash],
+    ignore_abundance: bool,
+    downsample: bool,
+    out: &mut [f64],
+) -> Result<(), Error> {
+    check_out_len(rows.len() * cols.len(), out.len())?;
+    if cols.is_empty() {
+        return Ok(());
+    }
+
+    #[cfg(feature = "parallel")]
+    let iter = out.par_chunks_mut(cols.len()).zip(rows.par_iter());
+
+    #[cfg(not(feature = "parallel"))]
+    let mut iter = out.chunks_mut(cols.len()).zip(rows.iter());
+
+    iter.try_for_each(|(row_out, row)| {
+        similarity_many(row, cols, ignore_abundance, downsample, row_out)
+    })
+}
+
 //#############
 // A MinHash implementation for low scaled or large cardinalities
 
@@ -972,10 +1787,15 @@ pub struct KmerMinHashBTree {
     #[builder(default = 0u64)]
     current_max: u64,
 
+    /// Optional companion HLL; see `KmerMinHash`.
+    #[builder(default)]
+    #[cfg_attr(feature = "rkyv", with(rkyv::with::Skip))]
+    hll: Option<HyperLogLog>,
+
     #[builder(default)]
     //#[cfg_attr(feature = "rkyv", with(rkyv::with::Lock))]
     #[cfg_attr(feature = "rkyv", with(rkyv::with::Skip))]
-    md5sum: Mutex<Option<String>>,
+    md5sum: OnceCell<String>,
 }
 
 impl PartialEq for KmerMinHashBTree {
@@ -996,7 +1816,8 @@ impl Clone for KmerMinHashBTree {
             mins: self.mins.clone(),
             abunds: self.abunds.clone(),
             current_max: self.current_max,
-            md5sum: Mutex::new(Some(self.md5sum())),
+            hll: self.hll.clone(),
+            md5sum: self.md5sum.clone(),
         }
     }
 }
@@ -1012,7 +1833,8 @@ impl Default for KmerMinHashBTree {
             mins: Default::default(),
             abunds: None,
             current_max: 0,
-            md5sum: Mutex::new(None),
+            hll: None,
+            md5sum: OnceCell::new(),
         }
     }
 }
@@ -1025,7 +1847,7 @@ impl Serialize for KmerMinHashBTree {
         let n_fields = match &self.abunds {
             Some(_) => 8,
             _ => 7,
-        };
+        } + self.hll.is_some() as usize;
 
         let mut partial = serializer.serialize_struct("KmerMinHashBTree", n_fields)?;
         partial.serialize_field("num", &self.num)?;
@@ -1042,6 +1864,10 @@ impl Serialize for KmerMinHashBTree {
 
         partial.serialize_field("molecule", &self.hash_function.to_string())?;
 
+        if let Some(hll) = &self.hll {
+            partial.serialize_field("hll", hll)?;
+        }
+
         partial.end()
     }
 }
@@ -1061,6 +1887,7 @@ impl<'de> Deserialize<'de> for KmerMinHashBTree {
             mins: Vec<u64>,
             abundances: Option<Vec<u64>>,
             molecule: String,
+            hll: Option<HyperLogLog>,
         }
 
         let tmpsig = TempSig::deserialize(deserializer)?;
@@ -1094,11 +1921,12 @@ impl<'de> Deserialize<'de> for KmerMinHashBTree {
             ksize: tmpsig.ksize,
             seed: tmpsig.seed,
             max_hash: tmpsig.max_hash,
-            md5sum: Mutex::new(Some(tmpsig.md5sum)),
+            md5sum: OnceCell::with_value(tmpsig.md5sum),
             mins,
             abunds,
             hash_function,
             current_max,
+            hll: tmpsig.hll,
         })
     }
 }
@@ -1131,7 +1959,8 @@ impl KmerMinHashBTree {
             mins,
             abunds,
             current_max: 0,
-            md5sum: Mutex::new(None),
+            hll: None,
+            md5sum: OnceCell::new(),
         }
     }
 
@@ -1156,6 +1985,10 @@ impl KmerMinHashBTree {
         if let Some(ref mut abunds) = self.abunds {
             abunds.clear();
         }
+        if let Some(ref mut hll) = self.hll {
+            hll.clear();
+        }
+        self.reset_md5sum();
         self.current_max = 0;
     }
 
@@ -1174,6 +2007,10 @@ impl KmerMinHashBTree {
             });
         }
 
+        self.hll = self
+            .hll
+            .take()
+            .map(|hll| hll.with_hash_function(h.clone(), self.seed));
         self.hash_function = h;
         Ok(())
     }
@@ -1198,33 +2035,53 @@ impl KmerMinHashBTree {
         self.abunds = None;
     }
 
-    fn reset_md5sum(&self) {
-        let mut data = self.md5sum.lock().unwrap();
-        if data.is_some() {
-            *data = None;
+    /// Whether a companion HLL is collected while adding hashes.
+    pub fn track_hll(&self) -> bool {
+        self.hll.is_some()
+    }
+
+    /// Start collecting a companion HLL; like `enable_abundance`, only
+    /// allowed on an empty sketch, so the HLL sees every hash added.
+    pub fn enable_hll(&mut self) -> Result<(), Error> {
+        if !self.mins.is_empty() {
+            return Err(Error::NonEmptyMinHash {
+                message: "hll=True".into(),
+            });
         }
+
+        self.hll = Some(
+            HyperLogLog::with_error_rate(HLL_ERROR_RATE, self.ksize as usize)?
+                .with_hash_function(self.hash_function.clone(), self.seed),
+        );
+
+        Ok(())
+    }
+
+    pub fn disable_hll(&mut self) {
+        self.hll = None;
+    }
+
+    pub fn hll(&self) -> Option<&HyperLogLog> {
+        self.hll.as_ref()
+    }
+
+    fn reset_md5sum(&mut self) {
+        self.md5sum.take();
     }
 
     pub fn md5sum(&self) -> String {
-        let mut data = self.md5sum.lock().unwrap();
-        if data.is_none() {
-            let mut buffer = String::with_capacity(20);
-
-            let mut md5_ctx = md5::Context::new();
-            write!(&mut buffer, "{}", self.ksize()).unwrap();
-            md5_ctx.consume(&buffer);
-            buffer.clear();
-            for x in &self.mins {
-                write!(&mut buffer, "{}", x).unwrap();
-                md5_ctx.consume(&buffer);
-                buffer.clear();
-            }
-            *data = Some(format!("{:x}", md5_ctx.compute()));
-        }
-        data.clone().unwrap()
+        self.md5sum
+            .get_or_init(|| compute_md5sum(self.ksize(), &self.mins))
+            .clone()
     }
 
     pub fn add_hash_with_abundance(&mut self, hash: u64, abundance: u64) {
+        if abundance > 0 {
+            if let Some(hll) = &mut self.hll {
+                hll.add_hash(hash);
+            }
+        }
+
         if hash > self.max_hash && self.max_hash != 0 {
             // This is a scaled minhash, and we don't need to add the new hash
             return;
@@ -1286,6 +2143,9 @@ impl KmerMinHashBTree {
     }
 
     pub fn remove_hash(&mut self, hash: u64) {
+        // the companion HLL can't forget a hash, so it no longer
+        // describes the data once anything is removed.
+        self.hll = None;
         if self.mins.remove(&hash) {
             self.reset_md5sum();
             if let Some(ref mut abunds) = self.abunds {
@@ -1306,6 +2166,12 @@ impl KmerMinHashBTree {
 
     pub fn merge(&mut self, other: &KmerMinHashBTree) -> Result<(), Error> {
         self.check_compatible(other)?;
+        self.hll = merge_hll(
+            self.hll.take(),
+            self.is_empty(),
+            other.hll.as_ref(),
+            other.is_empty(),
+        )?;
         let union = self.mins.union(&other.mins);
 
         let to_take = if self.num == 0 {
@@ -1404,7 +2270,9 @@ impl KmerMinHashBTree {
             Ok((common, combined_mh.mins.len() as u64))
         } else {
             // Intersection for scaled MinHash sketches
-            Ok(intersection(self.mins.iter(), other.mins.iter()))
+            let mut common = vec![];
+            let union_size = intersection(self.mins.iter(), other.mins.iter(), &mut common);
+            Ok((common, union_size))
         }
     }
 
@@ -1540,6 +2408,7 @@ impl KmerMinHashBTree {
             self.abunds.is_some(),
             self.num,
         );
+        new_mh.hll.clone_from(&self.hll);
         if self.abunds.is_some() {
             new_mh.add_many_with_abund(&self.to_vec_abunds())?;
         } else {
@@ -1642,9 +2511,11 @@ impl From<KmerMinHashBTree> for KmerMinHash {
         let abunds = other
             .abunds
             .map(|abunds| abunds.values().cloned().collect());
+        let hll = other.hll;
 
         new_mh.mins = mins;
         new_mh.abunds = abunds;
+        new_mh.hll = hll;
 
         new_mh
     }
@@ -1666,9 +2537,11 @@ impl From<&KmerMinHashBTree> for KmerMinHash {
             .abunds
             .as_ref()
             .map(|abunds| abunds.values().cloned().collect());
+        let hll = other.hll.clone();
 
         new_mh.mins = mins;
         new_mh.abunds = abunds;
+        new_mh.hll = hll;
 
         new_mh
     }
@@ -1689,9 +2562,11 @@ impl From<KmerMinHash> for KmerMinHashBTree {
         let abunds = other
             .abunds
             .map(|abunds| mins.iter().cloned().zip(abunds).collect());
+        let hll = other.hll;
 
         new_mh.mins = mins;
         new_mh.abunds = abunds;
+        new_mh.hll = hll;
 
         new_mh
     }
@@ -1700,10 +2575,10 @@ impl From<KmerMinHash> for KmerMinHashBTree {
 fn intersection<'a>(
     me_iter: impl Iterator<Item = &'a u64>,
     other_iter: impl Iterator<Item = &'a u64>,
-) -> (Vec<u64>, u64) {
+    common: &mut Vec<u64>,
+) -> u64 {
     let mut me = me_iter.peekable();
     let mut other = other_iter.peekable();
-    let mut common: Vec<u64> = vec![];
     let mut union_size = 0;
 
     loop {
@@ -1738,7 +2613,7 @@ fn intersection<'a>(
             _ => break,
         };
     }
-    (common, union_size as u64)
+    union_size as u64
 }
 
 fn intersection_size<'a>(
@@ -1,6 +1,7 @@
 pub mod hyperloglog;
 pub mod minhash;
 
+pub mod countgraph;
 pub mod nodegraph;
 
 use serde::{Deserialize, Serialize};
@@ -83,23 +83,7 @@ impl Nodegraph {
     }
 
     pub fn with_tables(tablesize: usize, n_tables: usize, ksize: usize) -> Nodegraph {
-        let mut tablesizes = Vec::with_capacity(n_tables);
-
-        let mut i = u64::max((tablesize - 1) as u64, 2);
-        if i % 2 == 0 {
-            i -= 1
-        }
-
-        while tablesizes.len() != n_tables {
-            if primal_check::miller_rabin(i) {
-                tablesizes.push(i as usize);
-            }
-            if i == 1 {
-                break;
-            }
-            i -= 2;
-        }
-
+        let tablesizes = prime_tablesizes(tablesize, n_tables);
         Nodegraph::new(tablesizes.as_slice(), ksize)
     }
 
@@ -321,6 +305,28 @@ impl Nodegraph {
     }
 }
 
+/// The `n_tables` largest primes below `tablesize`, as khmer does.
+pub(crate) fn prime_tablesizes(tablesize: usize, n_tables: usize) -> Vec<usize> {
+    let mut tablesizes = Vec::with_capacity(n_tables);
+
+    let mut i = u64::max((tablesize - 1) as u64, 2);
+    if i % 2 == 0 {
+        i -= 1
+    }
+
+    while tablesizes.len() != n_tables {
+        if primal_check::miller_rabin(i) {
+            tablesizes.push(i as usize);
+        }
+        if i == 1 {
+            break;
+        }
+        i -= 2;
+    }
+
+    tablesizes
+}
+
 fn twobit_repr(a: u8) -> HashIntoType {
     match a as char {
         'A' => 0,
@@ -349,7 +355,7 @@ fn uniqify_rc(f: HashIntoType, r: HashIntoType) -> HashIntoType {
     }
 }
 
-fn _hash(kmer: &[u8]) -> HashIntoType {
+pub(crate) fn _hash(kmer: &[u8]) -> HashIntoType {
     let ksize = kmer.len();
     let mut hash = 0;
     let mut rev = 0;
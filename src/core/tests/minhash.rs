@@ -9,7 +9,8 @@ use sourmash::encodings::HashFunctions;
 use sourmash::signature::SeqToHashes;
 use sourmash::signature::{Signature, SigsTrait};
 use sourmash::sketch::minhash::{
-    max_hash_for_scaled, scaled_for_max_hash, KmerMinHash, KmerMinHashBTree,
+    count_common_many, max_hash_for_scaled, scaled_for_max_hash, similarity_many, similarity_tile,
+    KmerMinHash, KmerMinHashBTree,
 };
 use sourmash::sketch::Sketch;
 
@@ -222,6 +223,257 @@ fn oracle_mins(hashes in vec(u64::ANY, 1..10000)) {
 }
 }
 
+proptest! {
+#[test]
+fn oracle_add_many_sorted(
+    hashes in vec(u64::ANY, 0..2000),
+    abunds in vec(0..5u64, 2000),
+    initial in vec(u64::ANY, 0..500),
+    num in 0..200u32,
+    sorted in proptest::bool::ANY,
+) {
+    let scaled = if num == 0 { 10 } else { 0 };
+    let mut hashes = hashes;
+    if sorted {
+        hashes.sort_unstable();
+    }
+    let abunds = &abunds[..hashes.len()];
+
+    let mut a = KmerMinHash::new(scaled, 21, HashFunctions::Murmur64Dna, 42, true, num);
+    a.add_many(&initial).unwrap();
+    let mut b = a.clone();
+    let mut c = KmerMinHash::new(scaled, 21, HashFunctions::Murmur64Dna, 42, false, num);
+    c.add_many(&initial).unwrap();
+    let mut d = c.clone();
+
+    for (hash, abund) in hashes.iter().zip(abunds) {
+        a.add_hash_with_abundance(*hash, *abund);
+        c.add_hash(*hash);
+    }
+    b.add_many_sorted(&hashes, Some(abunds)).unwrap();
+    d.add_many_sorted(&hashes, None).unwrap();
+
+    // removals during sequential adds can let later hashes into a num
+    // sketch, so only compare the bulk and sequential paths without them.
+    if num == 0 || abunds.iter().all(|&x| x > 0) {
+        assert_eq!(a.mins(), b.mins());
+        assert_eq!(a.abunds(), b.abunds());
+    }
+    assert_eq!(c.mins(), d.mins());
+    assert_eq!(c.md5sum(), d.md5sum());
+
+    d.remove_many_sorted(&hashes).unwrap();
+    c.remove_many(hashes.iter().copied()).unwrap();
+    assert_eq!(c.mins(), d.mins());
+}
+}
+
+proptest! {
+#[test]
+fn add_many_sorted_duplicates_in_order(
+    pairs in vec((1..20u64, 0..4u64), 0..200),
+) {
+    let (hashes, abunds): (Vec<u64>, Vec<u64>) = pairs.into_iter().unzip();
+
+    let mut a = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, true, 0);
+    for (hash, abund) in hashes.iter().zip(&abunds) {
+        a.add_hash_with_abundance(*hash, *abund);
+    }
+
+    // repeated hashes and 0 abundances apply in input order, as when
+    // adding one at a time.
+    let mut b = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, true, 0);
+    b.add_many_sorted(&hashes, Some(&abunds)).unwrap();
+    assert_eq!(a.mins(), b.mins());
+    assert_eq!(a.abunds(), b.abunds());
+}
+}
+
+proptest! {
+#[test]
+fn oracle_md5sum(hashes in vec(u64::ANY, 0..5000)) {
+    let mut a = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, false, 0);
+    let mut b = KmerMinHashBTree::new(1, 21, HashFunctions::Murmur64Dna, 42, false, 0);
+
+    // computing the md5sum caches it; mutations must invalidate the cache.
+    let empty = a.md5sum();
+    a.add_many(&hashes).unwrap();
+    b.add_many(&hashes).unwrap();
+
+    let mut text = a.ksize().to_string();
+    for hash in a.mins() {
+        text.push_str(&hash.to_string());
+    }
+    let expected = format!("{:x}", md5::compute(text));
+
+    assert_eq!(a.md5sum(), expected);
+    assert_eq!(b.md5sum(), expected);
+    assert_eq!(a.clone().md5sum(), expected);
+
+    a.clear();
+    b.clear();
+    assert_eq!(a.md5sum(), empty);
+    assert_eq!(b.md5sum(), empty);
+}
+}
+
+proptest! {
+#[test]
+fn oracle_downsample_into(
+    hashes in vec(u64::ANY, 0..2000),
+    other in vec(u64::ANY, 0..2000),
+    scaled in 1..100u64,
+    track_abundance in proptest::bool::ANY,
+) {
+    let mut a = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, track_abundance, 0);
+    a.add_many(&hashes).unwrap();
+
+    // reused buffers from an unrelated sketch must not leak into the result
+    let mut target = KmerMinHash::new(1, 31, HashFunctions::Murmur64Protein, 7, !track_abundance, 0);
+    target.add_many(&other).unwrap();
+
+    let expected = a.downsample_scaled(scaled).unwrap();
+    a.downsample_scaled_into(scaled, &mut target);
+
+    assert_eq!(target.max_hash(), expected.max_hash());
+    assert_eq!(target.ksize(), expected.ksize());
+    assert_eq!(target.hash_function(), expected.hash_function());
+    assert_eq!(target.seed(), expected.seed());
+    assert_eq!(target.mins(), expected.mins());
+    assert_eq!(target.abunds(), expected.abunds());
+    assert_eq!(target.md5sum(), expected.md5sum());
+
+    let mut b = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, false, 0);
+    b.add_many(&other).unwrap();
+    b.add_many(&hashes[..hashes.len() / 2]).unwrap();
+
+    let mut common = other.clone();
+    let union_size = a.intersection_into(&b, &mut common).unwrap();
+    assert_eq!((common, union_size), a.intersection(&b).unwrap());
+}
+}
+
+proptest! {
+#[test]
+fn oracle_downsample_view(
+    hashes in vec(u64::ANY, 0..2000),
+    other in vec(u64::ANY, 0..2000),
+    scaled in 1..100u64,
+    track_abundance in proptest::bool::ANY,
+) {
+    let mut a = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, track_abundance, 0);
+    a.add_many(&hashes).unwrap();
+    let mut b = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, true, 0);
+    b.add_many(&other).unwrap();
+    b.add_many(&hashes[..hashes.len() / 2]).unwrap();
+
+    let expected = a.downsample_scaled(scaled).unwrap();
+    let view = a.downsample_scaled_view(scaled);
+    assert_eq!(view.max_hash(), expected.max_hash());
+    assert_eq!(view.mins(), expected.mins_slice());
+    assert_eq!(view.abunds(), expected.abunds_slice());
+    assert_eq!(view.to_minhash().md5sum(), expected.md5sum());
+
+    let b_ds = b.downsample_scaled(scaled).unwrap();
+    let b_view = b.downsample_scaled_view(scaled);
+    assert_eq!(
+        view.count_common(&b_view, false).unwrap(),
+        expected.count_common(&b_ds, false).unwrap()
+    );
+    assert_eq!(
+        view.intersection_size(&b_view).unwrap(),
+        expected.intersection_size(&b_ds).unwrap()
+    );
+    assert_eq!(
+        view.similarity(&b_view, false, false).unwrap(),
+        expected.similarity(&b_ds, false, false).unwrap()
+    );
+    assert_eq!(
+        view.inflated_abundances(&b_view).unwrap(),
+        expected.inflated_abundances(&b_ds).unwrap()
+    );
+
+    // downsampling on the fly matches comparing against a copy
+    assert_eq!(
+        a.count_common(&b_ds, true).unwrap(),
+        expected.count_common(&b_ds, false).unwrap()
+    );
+    assert_eq!(
+        b_ds.similarity(&a, true, true).unwrap(),
+        b_ds.similarity(&expected, true, false).unwrap()
+    );
+
+    let mut in_place = a.clone();
+    in_place.downsample_scaled_in_place(scaled);
+    assert_eq!(in_place.max_hash(), expected.max_hash());
+    assert_eq!(in_place.mins(), expected.mins());
+    assert_eq!(in_place.abunds(), expected.abunds());
+    assert_eq!(in_place.md5sum(), expected.md5sum());
+}
+}
+
+proptest! {
+#[test]
+fn oracle_comparison_stats(
+    hashes in vec(u64::ANY, 1..2000),
+    other in vec(u64::ANY, 0..2000),
+    num in 0..500u32,
+) {
+    let scaled = if num == 0 { 1 } else { 0 };
+    let mut a = KmerMinHash::new(scaled, 21, HashFunctions::Murmur64Dna, 42, true, num);
+    let mut b = KmerMinHash::new(scaled, 21, HashFunctions::Murmur64Dna, 42, true, num);
+    a.add_many(&hashes).unwrap();
+    a.add_many(&hashes[..hashes.len() / 3]).unwrap();
+    b.add_many(&other).unwrap();
+    b.add_many(&hashes[..hashes.len() / 2]).unwrap();
+
+    let stats = a.comparison_stats(&b, false).unwrap();
+
+    let (common, union_size) = a.intersection_size(&b).unwrap();
+    assert_eq!(stats.common, common);
+    assert_eq!(stats.union_size, union_size);
+    assert_eq!(stats.self_size, a.size() as u64);
+    assert_eq!(stats.other_size, b.size() as u64);
+    assert_eq!(stats.self_total_abund, a.sum_abunds());
+    assert_eq!(stats.other_total_abund, b.sum_abunds());
+
+    if num == 0 {
+        assert_eq!(stats.common, a.count_common(&b, false).unwrap());
+
+        let (abunds, total) = b.inflated_abundances(&a).unwrap();
+        assert_eq!(stats.self_common_abund, total);
+        let (_, other_total) = a.inflated_abundances(&b).unwrap();
+        assert_eq!(stats.other_common_abund, other_total);
+        if !abunds.is_empty() {
+            assert_eq!(stats.mean_abund, total as f64 / abunds.len() as f64);
+        }
+    }
+}
+}
+
+proptest! {
+#[test]
+fn oracle_num_intersection_size(
+    hashes in vec(u64::ANY, 0..1000),
+    other in vec(u64::ANY, 0..1000),
+    num in 1..500u32,
+) {
+    let mut a = KmerMinHash::new(0, 21, HashFunctions::Murmur64Dna, 42, false, num);
+    let mut b = KmerMinHash::new(0, 21, HashFunctions::Murmur64Dna, 42, false, num);
+    a.add_many(&hashes).unwrap();
+    b.add_many(&other).unwrap();
+    b.add_many(&hashes[..hashes.len() / 2]).unwrap();
+
+    let a_btree: KmerMinHashBTree = a.clone().into();
+    let b_btree: KmerMinHashBTree = b.clone().into();
+
+    assert_eq!(
+        a.intersection_size(&b).unwrap(),
+        a_btree.intersection_size(&b_btree).unwrap()
+    );
+}
+}
+
 proptest! {
 #[test]
 fn oracle_mins_scaled(hashes in vec(u64::ANY, 1..10000)) {
@@ -834,6 +1086,41 @@ fn test_inflated_abundances() {
     assert_eq!(total_abund, 6);
 }
 
+#[test]
+fn test_inflated_sum_abundances() {
+    let mut a = KmerMinHash::new(5, 3, HashFunctions::Murmur64Hp, 42, false, 0);
+    a.add_hash(10);
+    a.add_hash(20);
+    a.add_hash(30);
+
+    let mut b = KmerMinHash::new(5, 3, HashFunctions::Murmur64Hp, 42, true, 0);
+    b.add_hash_with_abundance(10, 2);
+    b.add_hash_with_abundance(20, 4);
+    b.add_hash_with_abundance(40, 9); // Non-matching hash
+
+    let (_, total_abund) = a.inflated_abundances(&b).unwrap();
+    assert_eq!(a.inflated_sum_abundances(&b).unwrap(), total_abund);
+    assert_eq!(total_abund, 6);
+
+    assert!(matches!(
+        a.inflated_sum_abundances(&a),
+        Err(sourmash::Error::NeedsAbundanceTracking)
+    ));
+}
+
+#[test]
+fn test_remove_from_abunds() {
+    let mut a = KmerMinHash::new(1, 3, HashFunctions::Murmur64Dna, 42, true, 0);
+    a.add_many_with_abund(&[(10, 1), (20, 2), (30, 3), (40, 4)])
+        .unwrap();
+
+    let mut b = KmerMinHash::new(1, 3, HashFunctions::Murmur64Dna, 42, false, 0);
+    b.add_many(&[5, 20, 40, 50]).unwrap();
+
+    a.remove_from(&b).unwrap();
+    assert_eq!(a.to_vec_abunds(), vec![(10, 1), (30, 3)]);
+}
+
 #[test]
 fn test_inflate_noabund() {
     // Setup minhash a with some mins but no abundances
@@ -889,3 +1176,105 @@ fn test_n_unique_kmers() {
     mh.add_hash(30);
     assert_eq!(mh.n_unique_kmers(), 30)
 }
+
+#[test]
+fn batch_comparisons_match_pairwise() {
+    let sketches: Vec<KmerMinHash> = (1..6u64)
+        .map(|i| {
+            let mut mh = KmerMinHash::new(1, 21, HashFunctions::Murmur64Dna, 42, true, 0);
+            for h in (0..200u64).filter(|h| h % i == 0) {
+                mh.add_hash_with_abundance(h, h % 7 + 1);
+            }
+            mh
+        })
+        .collect();
+    let others: Vec<&KmerMinHash> = sketches.iter().collect();
+    let query = &sketches[1];
+
+    let mut counts = vec![0; others.len()];
+    count_common_many(query, &others, false, &mut counts).unwrap();
+    let mut sims = vec![0.0; others.len()];
+    similarity_many(query, &others, false, false, &mut sims).unwrap();
+
+    for (i, other) in others.iter().enumerate() {
+        assert_eq!(counts[i], query.count_common(other, false).unwrap());
+        assert_eq!(sims[i], query.similarity(other, false, false).unwrap());
+    }
+
+    let mut tile = vec![0.0; 2 * others.len()];
+    similarity_tile(&others[..2], &others, true, false, &mut tile).unwrap();
+    for (i, row) in others[..2].iter().enumerate() {
+        for (j, col) in others.iter().enumerate() {
+            let expected = row.similarity(col, true, false).unwrap();
+            assert_eq!(tile[i * others.len() + j], expected);
+        }
+    }
+
+    // errors from any comparison are reported
+    let num_mh = KmerMinHash::new(0, 21, HashFunctions::Murmur64Dna, 42, false, 10);
+    let mut sims = vec![0.0; 2];
+    assert!(similarity_many(&num_mh, &others[..2], false, false, &mut sims).is_err());
+
+    // and so are output arrays of the wrong size
+    assert!(count_common_many(query, &others, false, &mut [0; 1]).is_err());
+}
+
+#[test]
+fn companion_hll() {
+    let mut mh = KmerMinHash::new(100, 21, HashFunctions::Murmur64Dna, 42, false, 0);
+    mh.enable_hll().unwrap();
+    let mut other = mh.clone();
+
+    // hashes are spread over the whole u64 range, like murmur output
+    let hash = |i: u64| i.wrapping_mul(0x9E37_79B9_7F4A_7C15);
+    let hashes: Vec<u64> = (0..20_000).map(hash).collect();
+    mh.add_many(&hashes[..10_000]).unwrap();
+    for h in &hashes[5_000..] {
+        other.add_hash(*h);
+    }
+
+    // every hash is counted, not only the ones kept for scaled=100
+    let n_unique = mh.n_unique_kmers() as f64;
+    assert!((n_unique - 10_000.0).abs() / 10_000.0 < 0.05);
+
+    mh.merge(&other).unwrap();
+    let n_unique = mh.n_unique_kmers() as f64;
+    assert!((n_unique - 20_000.0).abs() / 20_000.0 < 0.05);
+
+    // kept when downsampling and converting, and saved with the sketch
+    let down = mh.downsample_scaled(1000).unwrap();
+    assert_eq!(down.hll(), mh.hll());
+    let btree = KmerMinHashBTree::from(mh.clone());
+    assert_eq!(KmerMinHash::from(btree).hll(), mh.hll());
+
+    let buffer = serde_json::to_vec(&mh).unwrap();
+    let loaded: KmerMinHash = serde_json::from_slice(&buffer).unwrap();
+    assert_eq!(loaded.hll(), mh.hll());
+    assert_eq!(loaded.n_unique_kmers(), mh.n_unique_kmers());
+
+    let mut restored = KmerMinHash::new(100, 21, HashFunctions::Murmur64Dna, 42, false, 0);
+    restored.set_hll(mh.hll().unwrap().clone()).unwrap();
+    assert_eq!(restored.n_unique_kmers(), mh.n_unique_kmers());
+    let mut protein = KmerMinHash::new(100, 21, HashFunctions::Murmur64Protein, 42, false, 0);
+    assert!(protein.set_hll(mh.hll().unwrap().clone()).is_err());
+
+    // the HLL can't forget hashes, so removals drop it
+    let mut removed = mh.clone();
+    removed.remove_many_sorted(&[]).unwrap();
+    assert!(removed.track_hll());
+    removed.remove_from(&other).unwrap();
+    assert!(!removed.track_hll());
+    let mut btree = KmerMinHashBTree::from(mh.clone());
+    btree.remove_hash(hashes[0]);
+    assert!(!btree.track_hll());
+
+    // sketches without an HLL still load, and fall back to size * scaled
+    mh.disable_hll();
+    let buffer = serde_json::to_vec(&mh).unwrap();
+    let loaded: KmerMinHash = serde_json::from_slice(&buffer).unwrap();
+    assert!(!loaded.track_hll());
+    assert_eq!(loaded.n_unique_kmers(), loaded.size() as u64 * 100);
+
+    // only an empty sketch can start collecting an HLL
+    assert!(mh.enable_hll().is_err());
+}
@@ -107,6 +107,14 @@ def subparser(subparsers):
         default=None,
         help="Number of processes to use to calculate similarity",
     )
+    subparser.add_argument(
+        "-t",
+        "--threads",
+        metavar="N",
+        type=int,
+        default=None,
+        help="Number of threads to use to calculate similarity",
+    )
     subparser.add_argument(
         "--distance-matrix",
         action="store_true",
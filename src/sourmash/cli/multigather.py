@@ -34,6 +34,10 @@ can be turned into a multigather command like so:
 sourmash multigather --query query1.sig query2.sig --db db1
 ```
 
+Use `-p/--processes N` to run up to N queries at once.  Each worker
+process loads the databases itself, so memory use grows with N.  Output
+for each query is still reported in query order.
+
 """
 
 from sourmash.cli.utils import add_ksize_arg, add_moltype_args, add_scaled_arg
@@ -110,6 +114,14 @@ def subparser(subparsers):
         default=".sig",
         help="write signature files with this extension ('.sig' by default)",
     )
+    subparser.add_argument(
+        "-p",
+        "--processes",
+        metavar="N",
+        type=int,
+        default=None,
+        help="number of queries to run in parallel (default: 1)",
+    )
 
     add_ksize_arg(subparser)
     add_moltype_args(subparser)
@@ -14,6 +14,8 @@ One or more existing collections of signatures can be provided via
 '--already-done' and already-existing signatures (based on name and
 sketch type) will not be recalculated or output.
 
+Use '-t/--threads N' to sketch up to N input files at once.
+
 If a location is provided via '--output-signatures', signatures will be saved
 to that location.
 
@@ -58,6 +60,14 @@ def subparser(subparsers):
         action="store_true",
         help="complain if input sequence is invalid (NOTE: only checks DNA)",
     )
+    subparser.add_argument(
+        "-t",
+        "--threads",
+        metavar="N",
+        type=int,
+        default=1,
+        help="number of input files to sketch at once (default: 1)",
+    )
     file_args = subparser.add_argument_group("File handling options")
     file_args.add_argument(
         "-o",
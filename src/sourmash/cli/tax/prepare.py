@@ -42,7 +42,7 @@ def subparser(subparsers):
         "--database-format",
         help="format of output file; default is 'sql')",
         default="sql",
-        choices=["csv", "sql"],
+        choices=["csv", "sql", "bin"],
     )
     subparser.add_argument(
         "--keep-full-identifiers",
@@ -370,6 +370,7 @@ class ComputeParameters(RustObject):
         num_hashes=500,
         track_abundance=False,
         scaled=0,
+        hll=False,
     ):
         self._objptr = lib.computeparams_new()
 
@@ -382,6 +383,7 @@ class ComputeParameters(RustObject):
         self.num_hashes = num_hashes
         self.track_abundance = track_abundance
         self.scaled = scaled
+        self.hll = hll
 
     @classmethod
     def from_manifest_row(cls, row):
@@ -451,6 +453,9 @@ class ComputeParameters(RustObject):
             pi.append("abund")
         # noabund is default
 
+        if self.hll:
+            pi.append("hll")
+
         if self.seed != DEFAULT_MMHASH_SEED:
             pi.append(f"seed={self.seed}")
         # self.seed
@@ -458,7 +463,7 @@ class ComputeParameters(RustObject):
         return ",".join(pi)
 
     def __repr__(self):
-        return f"ComputeParameters(ksizes={self.ksizes}, seed={self.seed}, protein={self.protein}, dayhoff={self.dayhoff}, hp={self.hp}, dna={self.dna}, num_hashes={self.num_hashes}, track_abundance={self.track_abundance}, scaled={self.scaled})"
+        return f"ComputeParameters(ksizes={self.ksizes}, seed={self.seed}, protein={self.protein}, dayhoff={self.dayhoff}, hp={self.hp}, dna={self.dna}, num_hashes={self.num_hashes}, track_abundance={self.track_abundance}, scaled={self.scaled}, hll={self.hll})"
 
     def __eq__(self, other):
         return (
@@ -471,6 +476,7 @@ class ComputeParameters(RustObject):
             and self.num_hashes == other.num_hashes
             and self.track_abundance == other.track_abundance
             and self.scaled == other.scaled
+            and self.hll == other.hll
         )
 
     @staticmethod
@@ -577,3 +583,11 @@ class ComputeParameters(RustObject):
     @scaled.setter
     def scaled(self, v):
         return self._methodcall(lib.computeparams_set_scaled, int(v))
+
+    @property
+    def hll(self):
+        return self._methodcall(lib.computeparams_hll)
+
+    @hll.setter
+    def hll(self, v):
+        return self._methodcall(lib.computeparams_set_hll, v)
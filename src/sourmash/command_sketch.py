@@ -6,6 +6,7 @@ import os
 from collections import defaultdict, Counter
 import csv
 import shlex
+from concurrent.futures import ThreadPoolExecutor
 
 import screed
 
@@ -44,6 +45,8 @@ def _parse_params_str(params_str):
             params["track_abundance"] = True
         elif item == "noabund":
             params["track_abundance"] = False
+        elif item == "hll":
+            params["hll"] = True
         elif item.startswith("k"):
             if len(item) < 3 or item[1] != "=":
                 raise ValueError("k takes a parameter, e.g. 'k=31'")
@@ -169,6 +172,7 @@ class _signatures_for_sketch_factory:
                     num_hashes=params_d.get("num", def_num),
                     track_abundance=params_d.get("track_abundance", def_abund),
                     scaled=params_d.get("scaled", def_scaled),
+                    hll=params_d.get("hll", False),
                 )
 
             if split_ksizes:
@@ -309,55 +313,81 @@ def translate(args):
     _execute_sketch(args, signatures_factory)
 
 
-def _compute_sigs(to_build, output, *, check_sequence=False):
-    "actually build the signatures in 'to_build' and output them to 'output'"
-    save_sigs = sourmash_args.SaveSignaturesToLocation(output)
-    save_sigs.open()
+def _sketch_file(name, filename, param_objs, check_sequence):
+    "build the signatures in 'param_objs' from the sequences in 'filename'"
+    assert param_objs
+
+    # now, set up to iterate over sequences.
+    with screed.open(filename) as screed_iter:
+        if not screed_iter:
+            error(f"ERROR: no sequences found in '{filename}'?!")
+            sys.exit(-1)
+
+        # build the set of empty sigs
+        sigs = []
 
-    for (name, filename), param_objs in to_build.items():
-        assert param_objs
+        is_dna = param_objs[0].dna
+        for p in param_objs:
+            if p.dna:
+                assert is_dna
+            sig = SourmashSignature.from_params(p)
+            sigs.append(sig)
+
+        input_is_protein = not is_dna
 
-        # now, set up to iterate over sequences.
-        with screed.open(filename) as screed_iter:
-            if not screed_iter:
-                error(f"ERROR: no sequences found in '{filename}'?!")
+        # read sequence records & sketch
+        notify(f"... reading sequences from {filename}")
+        for n, record in enumerate(screed_iter):
+            if n % 10000 == 0:
+                if n:
+                    notify("\r...{} {}", filename, n, end="")
+
+            try:
+                add_seq(sigs, record.sequence, input_is_protein, check_sequence)
+            except ValueError as exc:
+                error(f"ERROR when reading from '{filename}' - ")
+                error(str(exc))
                 sys.exit(-1)
 
-            # build the set of empty sigs
-            sigs = []
+        notify("...{} {} sequences", filename, n, end="")
 
-            is_dna = param_objs[0].dna
-            for p in param_objs:
-                if p.dna:
-                    assert is_dna
-                sig = SourmashSignature.from_params(p)
-                sigs.append(sig)
-
-            input_is_protein = not is_dna
-
-            # read sequence records & sketch
-            notify(f"... reading sequences from {filename}")
-            for n, record in enumerate(screed_iter):
-                if n % 10000 == 0:
-                    if n:
-                        notify("\r...{} {}", filename, n, end="")
-
-                try:
-                    add_seq(sigs, record.sequence, input_is_protein, check_sequence)
-                except ValueError as exc:
-                    error(f"ERROR when reading from '{filename}' - ")
-                    error(str(exc))
-                    sys.exit(-1)
-
-            notify("...{} {} sequences", filename, n, end="")
-
-            set_sig_name(sigs, filename, name)
+        set_sig_name(sigs, filename, name)
+
+    return sigs, n + 1
+
+
+def _compute_sigs(to_build, output, *, check_sequence=False, n_threads=1):
+    """actually build the signatures in 'to_build' and output them to 'output'
+
+    With n_threads > 1, input files are sketched concurrently on a thread
+    pool; the FFI releases the GIL while hashing sequences. Signatures are
+    still saved in the order of 'to_build'.
+    """
+    save_sigs = sourmash_args.SaveSignaturesToLocation(output)
+    save_sigs.open()
+
+    def sketch_one(item):
+        (name, filename), param_objs = item
+        return filename, _sketch_file(name, filename, param_objs, check_sequence)
+
+    if n_threads > 1:
+        executor = ThreadPoolExecutor(max_workers=n_threads)
+        results = executor.map(sketch_one, to_build.items())
+    else:
+        executor = None
+        results = map(sketch_one, to_build.items())
+
+    try:
+        for filename, (sigs, n_seqs) in results:
             for sig in sigs:
                 save_sigs.add(sig)
 
             notify(
-                f"calculated {len(sigs)} signatures for {n+1} sequences in {filename}"
+                f"calculated {len(sigs)} signatures for {n_seqs} sequences in {filename}"
             )
+    finally:
+        if executor is not None:
+            executor.shutdown(cancel_futures=True)
 
     save_sigs.close()
     notify(
@@ -628,7 +658,10 @@ def fromfile(args):
 
     if args.output_signatures:  # actually compute
         _compute_sigs(
-            to_build, args.output_signatures, check_sequence=args.check_sequence
+            to_build,
+            args.output_signatures,
+            check_sequence=args.check_sequence,
+            n_threads=args.threads,
         )
 
     if args.output_csv_info:  # output info necessary to construct
@@ -220,6 +220,7 @@ def compare(args):
             args.ignore_abundance,
             n_jobs=args.processes,
             return_ani=return_ani,
+            n_threads=args.threads,
         )
 
     # if distance matrix desired, switch to 1-similarity
@@ -832,7 +833,12 @@ def categorize(args):
         csv_fp.close()
 
 
+# how often (in seconds) to report progress during gather.
+GATHER_PROGRESS_INTERVAL = 10
+
+
 def gather(args):
+    import time
     from .search import GatherDatabases, format_bp
 
     set_quiet(args.quiet, args.debug)
@@ -989,10 +995,17 @@ def gather(args):
         save_sig_obj = None
         save_sig = None
 
-    # save CSV?
+    # save CSV? rows are written and flushed as each round completes, so
+    # that long-running gathers produce results progressively. CSV output
+    # to stdout is buffered so that it doesn't interleave with the results.
+    stream_csv = args.output and args.output != "-"
+    csv_out_obj = None
     csv_outfp = io.StringIO()
     csv_writer = None
 
+    # report progress periodically for long-running gathers.
+    start_time = last_report = time.monotonic()
+
     try:
         for result in gather_iter:
             found += 1
@@ -1036,13 +1049,26 @@ def gather(args):
             # write out CSV
             if args.output:
                 if csv_writer is None:
+                    if stream_csv:
+                        csv_out_obj = FileOutputCSV(args.output)
+                        csv_outfp = csv_out_obj.open()
                     csv_writer = result.init_dictwriter(csv_outfp)
                 result.write(csv_writer)
+                csv_outfp.flush()
 
             # save matches?
             if save_sig is not None:
                 save_sig.add(result.match)
 
+            now = time.monotonic()
+            if now - last_report >= GATHER_PROGRESS_INTERVAL:
+                last_report = now
+                rate = found / max(now - start_time, 1e-6)
+                remaining_bp = format_bp(gather_iter.remaining_bp)
+                notify(
+                    f"...{found} rounds so far ({rate:.2f} rounds/sec); {remaining_bp} of query left"
+                )
+
             if args.num_results and found >= args.num_results:
                 break
     finally:
@@ -1050,6 +1076,9 @@ def gather(args):
             save_sig_obj.close()
             save_sig_obj = None
             save_sig = None
+        if csv_out_obj:
+            csv_out_obj.close()
+            csv_out_obj = None
 
     # report on thresholding -
     if gather_iter.query:
@@ -1085,8 +1114,12 @@ def gather(args):
             f"WARNING: final scaled was {gather_iter.scaled}, vs query scaled of {query.minhash.scaled}"
         )
 
-    # save CSV?
-    if (found and args.output) or args.create_empty_results:
+    # save CSV? (if streaming, results have already been written.)
+    if stream_csv:
+        if not found and args.create_empty_results:
+            with FileOutputCSV(args.output):
+                pass
+    elif (found and args.output) or args.create_empty_results:
         with FileOutputCSV(args.output) as fp:
             fp.write(csv_outfp.getvalue())
 
@@ -1120,10 +1153,288 @@ def gather(args):
     # DONE w/gather function.
 
 
-def multigather(args):
-    "Gather many signatures against multiple databases."
+def _multigather_tmp_path(path):
+    "Temporary path for 'path', keeping the extension for format detection."
+    dirname, basename = os.path.split(path)
+    return os.path.join(dirname, f".tmp.{os.getpid()}.{basename}")
+
+
+def _multigather_discard_tmp(path):
+    "Remove a temporary output left behind by a failed query, if any."
+    try:
+        os.unlink(path)
+    except FileNotFoundError:
+        pass
+
+
+def _multigather_query(query, output_base, databases, args):
+    """Run gather for a single multigather query, and write its outputs.
+
+    Outputs are written to temporary files and renamed into place once
+    complete, so an interrupted run never leaves partial CSVs behind.
+
+    Returns (found, size_may_be_inaccurate).
+    """
     from .search import GatherDatabases, format_bp
 
+    size_may_be_inaccurate = False
+
+    counters = []
+    prefetch_query = query.copy()
+    if prefetch_query.minhash.track_abundance:
+        with prefetch_query.update() as prefetch_query:
+            prefetch_query.minhash = prefetch_query.minhash.flatten()
+
+    ident_mh = prefetch_query.minhash.copy_and_clear()
+    noident_mh = prefetch_query.minhash.to_mutable()
+
+    counters = []
+    for db in databases:
+        try:
+            counter = db.counter_gather(prefetch_query, args.threshold_bp)
+        except ValueError:
+            # catch "no signatures to search" ValueError if empty db.
+            continue
+        counters.append(counter)
+
+        # track found/not found hashes
+        union_found = counter.union_found
+        noident_mh.remove_many(union_found)
+        ident_mh.add_many(union_found)
+
+    found = 0
+    is_abundance = query.minhash.track_abundance and not args.ignore_abundance
+    orig_query_mh = query.minhash
+    gather_iter = GatherDatabases(
+        query,
+        counters,
+        threshold_bp=args.threshold_bp,
+        ignore_abundance=args.ignore_abundance,
+        noident_mh=noident_mh,
+        ident_mh=ident_mh,
+    )
+
+    screen_width = _get_screen_width()
+    sum_f_uniq_found = 0.0
+    result = None
+
+    output_matches = output_base + ".matches.sig"
+    tmp_matches = _multigather_tmp_path(output_matches)
+    output_csv = output_base + ".csv"
+    tmp_csv = _multigather_tmp_path(output_csv)
+    save_sig_obj = csv_out_obj = None
+    try:
+        save_sig_obj = SaveSignaturesToLocation(tmp_matches)
+        save_sig = save_sig_obj.__enter__()
+        notify(f"saving all matching signatures to '{output_matches}'")
+
+        # write out basic CSV file
+        notify(f'saving all CSV matches to "{output_csv}"')
+        csv_out_obj = FileOutputCSV(tmp_csv)
+        csv_outfp = csv_out_obj.__enter__()
+        csv_writer = None
+
+        for result in gather_iter:
+            found += 1
+            sum_f_uniq_found += result.f_unique_to_query
+            if found == 1:  # first result? print header.
+                if is_abundance:
+                    print_results("")
+                    print_results("overlap     p_query p_match avg_abund")
+                    print_results("---------   ------- ------- ---------")
+                else:
+                    print_results("")
+                    print_results("overlap     p_query p_match")
+                    print_results("---------   ------- -------")
+
+            # print interim result & save in a list for later use
+            pct_query = f"{result.f_unique_weighted * 100:.1f}%"
+            pct_genome = f"{result.f_match * 100:.1f}%"
+
+            if is_abundance:
+                name = result.match._display_name(screen_width - 41)
+                average_abund = f"{result.average_abund:.1f}"
+                print_results(
+                    "{:9}   {:>7} {:>7} {:>9}    {}",
+                    format_bp(result.intersect_bp),
+                    pct_query,
+                    pct_genome,
+                    average_abund,
+                    name,
+                )
+            else:
+                name = result.match._display_name(screen_width - 31)
+                print_results(
+                    "{:9}   {:>7} {:>7}    {}",
+                    format_bp(result.intersect_bp),
+                    pct_query,
+                    pct_genome,
+                    name,
+                )
+
+            ## @CTB
+            if csv_writer is None:
+                csv_writer = result.init_dictwriter(csv_outfp)
+            result.write(csv_writer)
+
+            save_sig.add(result.match)
+
+            # check for size estimation accuracy, which impacts ANI estimation
+            if not size_may_be_inaccurate and result.size_may_be_inaccurate:
+                size_may_be_inaccurate = True
+
+        # report on thresholding -
+        if gather_iter.query.minhash:
+            # if still a query, then we failed the threshold.
+            notify(
+                f"found less than {format_bp(args.threshold_bp)} in common. => exiting"
+            )
+
+        # basic reporting
+        print_results("\nfound {} matches total;", found)
+
+        # close saving etc.
+        save_sig_obj.close()
+        save_sig_obj = save_sig = None
+        os.replace(tmp_matches, output_matches)
+
+        csv_out_obj.close()
+        csv_out_obj = csv_outfp = csv_writer = None
+        os.replace(tmp_csv, output_csv)
+    finally:
+        # on failure, close and remove the partial outputs.
+        for obj in (save_sig_obj, csv_out_obj):
+            if obj is not None:
+                obj.close()
+        _multigather_discard_tmp(tmp_matches)
+        _multigather_discard_tmp(tmp_csv)
+
+    if is_abundance and result:
+        p_covered = result.sum_weighted_found / result.total_weighted_hashes
+        p_covered *= 100
+        print_results(
+            f"the recovered matches hit {p_covered:.1f}% of the abundance-weighted query."
+        )
+
+    print_results(
+        f"the recovered matches hit {sum_f_uniq_found*100:.1f}% of the query k-mers (unweighted)."
+    )
+    print_results("")
+
+    if found == 0:
+        notify("nothing found... skipping.")
+        return found, size_may_be_inaccurate
+
+    output_unassigned = output_base + f".unassigned{args.extension}"
+    remaining_query = gather_iter.query
+    if noident_mh:
+        remaining_mh = remaining_query.minhash.to_mutable()
+        remaining_mh += noident_mh.downsample(scaled=remaining_mh.scaled)
+        remaining_query.minhash = remaining_mh
+
+    if is_abundance:
+        abund_query_mh = remaining_query.minhash.inflate(orig_query_mh)
+        remaining_query.minhash = abund_query_mh
+
+    if found == 0:
+        notify("nothing found - entire query signature unassigned.")
+    elif not remaining_query:
+        notify("no unassigned hashes! not saving.")
+    else:
+        notify(f'saving unassigned hashes to "{output_unassigned}"')
+
+    tmp_unassigned = _multigather_tmp_path(output_unassigned)
+    try:
+        with SaveSignaturesToLocation(tmp_unassigned) as save_sig:
+            save_sig.add(remaining_query)
+        os.replace(tmp_unassigned, output_unassigned)
+    finally:
+        _multigather_discard_tmp(tmp_unassigned)
+
+    return found, size_may_be_inaccurate
+
+
+# databases used by a multigather worker process; loaded by the pool
+# initializer.
+_multigather_worker_state = None
+
+
+def _multigather_worker_init(args, query):
+    """Load the multigather databases in a worker process.
+
+    Workers are spawned rather than forked: the parent holds native
+    threads and locks (rayon, RocksDB) that a forked child would inherit
+    in an unusable state. 'query' selects ksize and moltype, as in the
+    parent.
+    """
+    global _multigather_worker_state
+
+    # the parent already reported on loading the databases.
+    set_quiet(True)
+    databases = sourmash_args.load_dbs_and_sigs(
+        args.db, query, False, fail_on_empty_database=args.fail_on_empty_database
+    )
+    set_quiet(args.quiet)
+
+    _multigather_worker_state = (databases, args)
+
+
+def _multigather_worker(job):
+    "Run one multigather query in a worker process, capturing its output."
+    import contextlib
+
+    idx, query, output_base = job
+    databases, args = _multigather_worker_state
+
+    out, err = io.StringIO(), io.StringIO()
+    with contextlib.redirect_stdout(out), contextlib.redirect_stderr(err):
+        found, size_may_be_inaccurate = _multigather_query(
+            query, output_base, databases, args
+        )
+
+    return idx, out.getvalue(), err.getvalue(), found, size_may_be_inaccurate
+
+
+def _multigather_parallel(jobs, first_query, args):
+    """Run multigather jobs on a pool of spawned worker processes.
+
+    Each worker loads the databases once; see _multigather_worker_init.
+    Queries are scheduled largest first, but their output is reported in
+    the original query order.
+    """
+    import multiprocessing
+
+    ctx = multiprocessing.get_context("spawn")
+
+    # schedule the largest queries first, so they don't end up last.
+    order = sorted(jobs, key=lambda job: len(job[1].minhash), reverse=True)
+
+    n_processes = min(args.processes, len(jobs))
+    notify(f"running multigather on {n_processes} processes")
+
+    pending = {}
+    next_idx = 0
+    with ctx.Pool(
+        processes=n_processes,
+        initializer=_multigather_worker_init,
+        initargs=(args, first_query),
+    ) as pool:
+        for result in pool.imap_unordered(_multigather_worker, order):
+            pending[result[0]] = result
+
+            # report everything that is ready, in the original order.
+            while next_idx in pending:
+                _, out, err, found, size_may_be_inaccurate = pending.pop(next_idx)
+                sys.stderr.write(err)
+                sys.stdout.write(out)
+                sys.stdout.flush()
+                next_idx += 1
+
+                yield found, size_may_be_inaccurate
+
+
+def multigather(args):
+    "Gather many signatures against multiple databases."
     set_quiet(args.quiet)
     moltype = sourmash_args.calculate_moltype(args)
 
@@ -1159,10 +1470,14 @@ def multigather(args):
         args.db, query, False, fail_on_empty_database=args.fail_on_empty_database
     )
 
+    first_query = query
+    parallel = args.processes is not None and args.processes > 1
+
     # run gather on all the queries.
     n = 0
     size_may_be_inaccurate = False
     output_base_tracking = set()  # make sure we are not reusing 'output_base'
+    jobs = []
     for queryfile in inp_files:
         # load the query signature(s) & figure out all the things
         for query in sourmash_args.load_file_as_signatures(
@@ -1189,45 +1504,6 @@ def multigather(args):
                 error("no query hashes!? skipping to next..")
                 continue
 
-            counters = []
-            prefetch_query = query.copy()
-            if prefetch_query.minhash.track_abundance:
-                with prefetch_query.update() as prefetch_query:
-                    prefetch_query.minhash = prefetch_query.minhash.flatten()
-
-            ident_mh = prefetch_query.minhash.copy_and_clear()
-            noident_mh = prefetch_query.minhash.to_mutable()
-
-            counters = []
-            for db in databases:
-                try:
-                    counter = db.counter_gather(prefetch_query, args.threshold_bp)
-                except ValueError:
-                    # catch "no signatures to search" ValueError if empty db.
-                    continue
-                counters.append(counter)
-
-                # track found/not found hashes
-                union_found = counter.union_found
-                noident_mh.remove_many(union_found)
-                ident_mh.add_many(union_found)
-
-            found = 0
-            is_abundance = query.minhash.track_abundance and not args.ignore_abundance
-            orig_query_mh = query.minhash
-            gather_iter = GatherDatabases(
-                query,
-                counters,
-                threshold_bp=args.threshold_bp,
-                ignore_abundance=args.ignore_abundance,
-                noident_mh=noident_mh,
-                ident_mh=ident_mh,
-            )
-
-            screen_width = _get_screen_width()
-            sum_f_uniq_found = 0.0
-            result = None
-
             query_filename = query.filename
             if not query_filename or query_filename == "-":
                 # use md5sum if query.filename not properly set
@@ -1258,125 +1534,26 @@ def multigather(args):
 
             output_base_tracking.add(output_base)
 
-            output_matches = output_base + ".matches.sig"
-            save_sig_obj = SaveSignaturesToLocation(output_matches)
-            save_sig = save_sig_obj.__enter__()
-            notify(f"saving all matching signatures to '{output_matches}'")
-
-            # write out basic CSV file
-            output_csv = output_base + ".csv"
-            notify(f'saving all CSV matches to "{output_csv}"')
-            csv_out_obj = FileOutputCSV(output_csv)
-            csv_outfp = csv_out_obj.__enter__()
-            csv_writer = None
-
-            for result in gather_iter:
-                found += 1
-                sum_f_uniq_found += result.f_unique_to_query
-                if found == 1:  # first result? print header.
-                    if is_abundance:
-                        print_results("")
-                        print_results("overlap     p_query p_match avg_abund")
-                        print_results("---------   ------- ------- ---------")
-                    else:
-                        print_results("")
-                        print_results("overlap     p_query p_match")
-                        print_results("---------   ------- -------")
-
-                # print interim result & save in a list for later use
-                pct_query = f"{result.f_unique_weighted * 100:.1f}%"
-                pct_genome = f"{result.f_match * 100:.1f}%"
-
-                if is_abundance:
-                    name = result.match._display_name(screen_width - 41)
-                    average_abund = f"{result.average_abund:.1f}"
-                    print_results(
-                        "{:9}   {:>7} {:>7} {:>9}    {}",
-                        format_bp(result.intersect_bp),
-                        pct_query,
-                        pct_genome,
-                        average_abund,
-                        name,
-                    )
-                else:
-                    name = result.match._display_name(screen_width - 31)
-                    print_results(
-                        "{:9}   {:>7} {:>7}    {}",
-                        format_bp(result.intersect_bp),
-                        pct_query,
-                        pct_genome,
-                        name,
-                    )
-
-                ## @CTB
-                if csv_writer is None:
-                    csv_writer = result.init_dictwriter(csv_outfp)
-                result.write(csv_writer)
-
-                save_sig.add(result.match)
-
-                # check for size estimation accuracy, which impacts ANI estimation
-                if not size_may_be_inaccurate and result.size_may_be_inaccurate:
-                    size_may_be_inaccurate = True
-
-            # report on thresholding -
-            if gather_iter.query.minhash:
-                # if still a query, then we failed the threshold.
-                notify(
-                    f"found less than {format_bp(args.threshold_bp)} in common. => exiting"
-                )
-
-            # basic reporting
-            print_results("\nfound {} matches total;", found)
-
-            # close saving etc.
-            save_sig_obj.close()
-            save_sig_obj = save_sig = None
-
-            csv_out_obj.close()
-            csv_out_obj = csv_outfp = csv_writer = None
-
-            if is_abundance and result:
-                p_covered = result.sum_weighted_found / result.total_weighted_hashes
-                p_covered *= 100
-                print_results(
-                    f"the recovered matches hit {p_covered:.1f}% of the abundance-weighted query."
-                )
-
-            print_results(
-                f"the recovered matches hit {sum_f_uniq_found*100:.1f}% of the query k-mers (unweighted)."
-            )
-            print_results("")
-
-            if found == 0:
-                notify("nothing found... skipping.")
+            if parallel:
+                # queue up, and run everything at once below.
+                jobs.append((len(jobs), query, output_base))
                 continue
 
-            output_unassigned = output_base + f".unassigned{args.extension}"
-            remaining_query = gather_iter.query
-            if noident_mh:
-                remaining_mh = remaining_query.minhash.to_mutable()
-                remaining_mh += noident_mh.downsample(scaled=remaining_mh.scaled)
-                remaining_query.minhash = remaining_mh
-
-            if is_abundance:
-                abund_query_mh = remaining_query.minhash.inflate(orig_query_mh)
-                remaining_query.minhash = abund_query_mh
-
-            if found == 0:
-                notify("nothing found - entire query signature unassigned.")
-            elif not remaining_query:
-                notify("no unassigned hashes! not saving.")
-            else:
-                notify(f'saving unassigned hashes to "{output_unassigned}"')
-
-            with SaveSignaturesToLocation(output_unassigned) as save_sig:
-                save_sig.add(remaining_query)
-
-            n += 1
+            found, inaccurate = _multigather_query(
+                query, output_base, databases, args
+            )
+            size_may_be_inaccurate = size_may_be_inaccurate or inaccurate
+            if found:
+                n += 1
 
         # fini, next query!
 
+    if jobs:
+        for found, inaccurate in _multigather_parallel(jobs, first_query, args):
+            size_may_be_inaccurate = size_may_be_inaccurate or inaccurate
+            if found:
+                n += 1
+
     # done! report at end.
     notify(f"\nconducted gather searches on {n} signatures")
     if size_may_be_inaccurate:
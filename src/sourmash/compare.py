@@ -4,6 +4,7 @@ import itertools
 from functools import partial
 import time
 import multiprocessing
+from concurrent.futures import ThreadPoolExecutor
 
 from sourmash.sketchcomparison import FracMinHashComparison
 
@@ -37,21 +38,29 @@ def compare_serial(siglist, ignore_abundance, *, downsample=False, return_ani=Fa
 
     similarities = np.ones((n, n))
 
-    for i, j in iterator:
-        if return_ani:
-            ani_result = siglist[i].jaccard_ani(siglist[j], downsample=downsample)
-            if not potential_false_negatives and ani_result.p_exceeds_threshold:
-                potential_false_negatives = True
-            if not jaccard_ani_untrustworthy and ani_result.je_exceeds_threshold:
-                jaccard_ani_untrustworthy = True
-            ani = ani_result.ani
-            if ani is None:
-                ani = 0.0
-            similarities[i][j] = similarities[j][i] = ani
-        else:
-            similarities[i][j] = similarities[j][i] = siglist[i].similarity(
-                siglist[j], ignore_abundance=ignore_abundance, downsample=downsample
+    if not return_ani:
+        # compare each signature against all later ones in a single call
+        minhashes = [ss.minhash for ss in siglist]
+        for i in range(n - 1):
+            row = minhashes[i].similarity_many(
+                minhashes[i + 1 :],
+                ignore_abundance=ignore_abundance,
+                downsample=downsample,
             )
+            similarities[i, i + 1 :] = row
+            similarities[i + 1 :, i] = row
+        return similarities
+
+    for i, j in iterator:
+        ani_result = siglist[i].jaccard_ani(siglist[j], downsample=downsample)
+        if not potential_false_negatives and ani_result.p_exceeds_threshold:
+            potential_false_negatives = True
+        if not jaccard_ani_untrustworthy and ani_result.je_exceeds_threshold:
+            jaccard_ani_untrustworthy = True
+        ani = ani_result.ani
+        if ani is None:
+            ani = 0.0
+        similarities[i][j] = similarities[j][i] = ani
 
     if jaccard_ani_untrustworthy:
         notify(
@@ -325,12 +334,67 @@ def compare_parallel(
     return np.memmap(filename, dtype=np.float64, shape=(length_siglist, length_siglist))
 
 
+def compare_threaded(
+    siglist, ignore_abundance, downsample, n_threads, *, return_ani=False
+):
+    """Compare all combinations of signatures and return a matrix
+    of similarities. Processes combinations on a pool of n_threads
+    threads within this process; the comparisons release the GIL, so
+    this scales across cores without copying siglist to other processes.
+
+    :param list siglist: list of signatures to compare
+    :param boolean ignore_abundance
+        If the sketches are not abundance weighted, or ignore_abundance=True,
+        compute Jaccard similarity.
+
+        If the sketches are abundance weighted, calculate the angular
+        similarity.
+    :param boolean downsample by scaled if True
+    :param int n_threads number of threads to run the similarity calculations on
+    :return: np.array similarity matrix
+    """
+    import numpy as np
+
+    start_initial = time.time()
+
+    length_siglist = len(siglist)
+    similarities = np.eye(length_siglist, dtype=np.float64)
+
+    func = partial(
+        get_similarities_at_index,
+        siglist=siglist,
+        ignore_abundance=ignore_abundance,
+        downsample=downsample,
+        return_ani=return_ani,
+    )
+
+    with ThreadPoolExecutor(max_workers=n_threads) as executor:
+        result = executor.map(func, range(length_siglist))
+
+        for index, l in enumerate(result):
+            col_idx = index + 1
+            similarities[index, col_idx:] = l
+            similarities[col_idx:, index] = l
+
+    notify(
+        f"Time taken to compare all pairs on {n_threads} threads is {time.time() - start_initial:.5f} seconds "
+    )
+    return similarities
+
+
 def compare_all_pairs(
-    siglist, ignore_abundance, downsample=False, n_jobs=None, return_ani=False
+    siglist,
+    ignore_abundance,
+    downsample=False,
+    n_jobs=None,
+    return_ani=False,
+    *,
+    n_threads=None,
 ):
     """Compare all combinations of signatures and return a matrix
     of similarities. Processes combinations either serially or
-    based on parallely on number of processes given by n_jobs
+    based on parallely on number of processes given by n_jobs, or
+    on number of threads given by n_threads
 
     :param list siglist: list of signatures to compare
     :param boolean ignore_abundance
@@ -342,9 +406,15 @@ def compare_all_pairs(
     :param boolean downsample by scaled if True
     :param int n_jobs number of processes to run the similarity calculations on,
     if number of jobs is None or 1, compare serially, otherwise parallely.
+    :param int n_threads number of threads to run the similarity calculations
+    on; takes precedence over n_jobs when greater than 1.
     :return: np.array similarity matrix
     """
-    if n_jobs is None or n_jobs == 1:
+    if n_threads is not None and n_threads > 1:
+        similarities = compare_threaded(
+            siglist, ignore_abundance, downsample, n_threads, return_ani=return_ani
+        )
+    elif n_jobs is None or n_jobs == 1:
         similarities = compare_serial(
             siglist,
             ignore_abundance=ignore_abundance,
@@ -0,0 +1,110 @@
+# -*- coding: UTF-8 -*-
+
+from tempfile import NamedTemporaryFile
+
+from ._lowlevel import ffi, lib
+from .minhash import to_bytes, MinHash
+from .utils import RustObject, rustcall
+
+
+class Countgraph(RustObject):
+    """A count-min sketch with 8-bit saturating counters.
+
+    The counting variant of Nodegraph, saved in the khmer countgraph format.
+    """
+
+    __dealloc_func__ = lib.countgraph_free
+
+    def __init__(self, ksize, starting_size, n_tables):
+        self._objptr = lib.countgraph_with_tables(ksize, int(starting_size), n_tables)
+
+    @staticmethod
+    def load(filename):
+        cg_ptr = rustcall(lib.countgraph_from_path, to_bytes(filename))
+        return Countgraph._from_objptr(cg_ptr)
+
+    @staticmethod
+    def from_buffer(buf):
+        cg_ptr = rustcall(lib.countgraph_from_buffer, buf, len(buf))
+        return Countgraph._from_objptr(cg_ptr)
+
+    def save(self, filename):
+        self._methodcall(lib.countgraph_save, to_bytes(filename))
+
+    def to_bytes(self, compression=1):
+        size = ffi.new("uintptr_t *")
+        rawbuf = self._methodcall(lib.countgraph_to_buffer, compression, size)
+        size = size[0]
+
+        rawbuf = ffi.gc(rawbuf, lambda o: lib.nodegraph_buffer_free(o, size), size)
+        buf = ffi.buffer(rawbuf, size)
+
+        return buf
+
+    def update(self, other):
+        "Merge in another Countgraph (keeping the largest counts) or a MinHash."
+        if isinstance(other, Countgraph):
+            return self._methodcall(lib.countgraph_update, other._objptr)
+        elif isinstance(other, MinHash):
+            return self._methodcall(lib.countgraph_update_mh, other._objptr)
+        else:
+            raise TypeError("Must be a Countgraph or MinHash")
+
+    def count(self, h, abundance=1):
+        if isinstance(h, str):
+            if abundance != 1:
+                raise ValueError("abundance can only be set for hashes")
+            return self._methodcall(lib.countgraph_count_kmer, to_bytes(h))
+        return self._methodcall(lib.countgraph_count_with_abundance, h, abundance)
+
+    def get(self, h):
+        if isinstance(h, str):
+            return self._methodcall(lib.countgraph_get_kmer, to_bytes(h))
+        return self._methodcall(lib.countgraph_get, h)
+
+    def n_occupied(self):
+        return self._methodcall(lib.countgraph_noccupied)
+
+    def ksize(self):
+        return self._methodcall(lib.countgraph_ksize)
+
+    def hashsizes(self):
+        size = ffi.new("uintptr_t *")
+        ptr = self._methodcall(lib.countgraph_hashsizes, size)
+        size = size[0]
+        hashsizes = ffi.unpack(ptr, size)
+        lib.kmerminhash_slice_free(ptr, size)
+
+        return hashsizes
+
+    @property
+    def expected_collisions(self):
+        return self._methodcall(lib.countgraph_expected_collisions)
+
+    def matches(self, mh):
+        if not isinstance(mh, MinHash):
+            raise ValueError("mh must be a MinHash")
+
+        return self._methodcall(lib.countgraph_matches, mh._objptr)
+
+    def matches_weighted(self, mh):
+        """Sum over the hashes in 'mh' of the smaller of their abundance in
+        'mh' (1 without abundance tracking) and their count here."""
+        if not isinstance(mh, MinHash):
+            raise ValueError("mh must be a MinHash")
+
+        return self._methodcall(lib.countgraph_matches_weighted, mh._objptr)
+
+    def to_khmer_countgraph(self):
+        import khmer
+
+        try:
+            load_countgraph = khmer.load_countgraph
+        except AttributeError:
+            load_countgraph = khmer.Countgraph.load
+
+        with NamedTemporaryFile() as f:
+            self.save(f.name)
+            f.file.flush()
+            f.file.seek(0)
+            return load_countgraph(f.name)
@@ -4,13 +4,16 @@ Equations from: https://github.com/KoslickiLab/mutation-rate-ci-calculator
 Reference: https://doi.org/10.1101/2022.01.11.475870
 """
 from dataclasses import dataclass, field
+from functools import lru_cache
 from scipy.optimize import brentq
 from scipy.stats import norm as scipy_norm
 from scipy.stats import binom
 import numpy as np
 from math import log, exp
 
+from ._lowlevel import ffi, lib
 from .logging import notify
+from .utils import rustcall
 
 
 def check_distance(dist):
@@ -160,7 +163,9 @@ def exp_n_mutated_squared(L, k, p):
     return var_n_mutated(L, k, p) + exp_n_mutated(L, k, p) ** 2
 
 
+@lru_cache(maxsize=32)
 def probit(p):
+    # nearly every caller asks for the same few quantiles; cache them.
     return scipy_norm.ppf(p)
 
 
@@ -345,6 +350,79 @@ def containment_to_distance(
     )
 
 
+def containment_to_distance_many(
+    containments,
+    ksize,
+    scaled,
+    *,
+    n_unique_kmers,
+    confidence=0.95,
+    estimate_ci=False,
+    prob_threshold=1e-3,
+):
+    """
+    Containment --> distance CI for many comparisons at once.
+
+    'ksize', 'scaled' and 'n_unique_kmers' can be single values or have one
+    entry per containment. Point estimates are computed with NumPy, and
+    confidence intervals in parallel in the Rust core.
+
+    Returns a list of ciANIResult, in the same order as 'containments'.
+    """
+    containments = np.ascontiguousarray(containments, dtype=np.float64)
+    n = len(containments)
+    ksizes = np.ascontiguousarray(np.broadcast_to(ksize, n), dtype=np.uint32)
+    scaled = np.ascontiguousarray(np.broadcast_to(scaled, n), dtype=np.uint64)
+    n_unique_kmers = np.ascontiguousarray(
+        np.broadcast_to(n_unique_kmers, n), dtype=np.uint64
+    )
+
+    point_estimates = 1.0 - containments ** (1.0 / ksizes)
+    point_estimates[containments == 0] = 1.0
+    point_estimates[containments == 1] = 0.0
+
+    # see get_exp_probability_nothing_common
+    exp_nmut = n_unique_kmers * (1 - (1 - point_estimates) ** ksizes)
+    with np.errstate(divide="ignore", invalid="ignore"):
+        log_probs = (n_unique_kmers - exp_nmut) * np.log(1.0 - 1.0 / scaled)
+    probs = np.exp(log_probs)
+    probs[point_estimates == 1.0] = 1.0
+    probs[point_estimates == 0.0] = 0.0
+
+    dists_low = dists_high = [None] * n
+    if estimate_ci and n:
+        ani_low = np.zeros(n, dtype=np.float64)
+        ani_high = np.zeros(n, dtype=np.float64)
+        rustcall(
+            lib.sourmash_ani_ci_from_containment_many,
+            ffi.from_buffer("double[]", containments),
+            ffi.from_buffer("uint32_t[]", ksizes),
+            ffi.from_buffer("uint64_t[]", scaled),
+            ffi.from_buffer("uint64_t[]", n_unique_kmers),
+            n,
+            confidence,
+            ffi.from_buffer("double[]", ani_low),
+            ffi.from_buffer("double[]", ani_high),
+        )
+        if np.isnan(ani_low).any():
+            notify(
+                "WARNING: Cannot estimate some ANI confidence intervals from containment. Do your sketches contain enough hashes?"
+            )
+        dists_low = [None if np.isnan(x) else 1.0 - x for x in ani_high]
+        dists_high = [None if np.isnan(x) else 1.0 - x for x in ani_low]
+
+    return [
+        ciANIResult(
+            float(point_estimates[i]),
+            float(probs[i]),
+            dist_low=dists_low[i],
+            dist_high=dists_high[i],
+            p_threshold=prob_threshold,
+        )
+        for i in range(n)
+    ]
+
+
 def jaccard_to_distance(
     jaccard,
     ksize,
@@ -6,14 +6,38 @@ from tempfile import NamedTemporaryFile
 from ._lowlevel import ffi, lib
 from .utils import RustObject, rustcall, decode_str
 from .exceptions import SourmashError
-from .minhash import to_bytes, MinHash
+from .minhash import to_bytes, MinHash, MINHASH_DEFAULT_SEED
 
 
 class HLL(RustObject):
     __dealloc_func__ = lib.hll_free
 
-    def __init__(self, error_rate, ksize):
-        self._objptr = lib.hll_with_error_rate(error_rate, ksize)
+    def __init__(
+        self,
+        error_rate,
+        ksize,
+        *,
+        is_protein=False,
+        dayhoff=False,
+        hp=False,
+        seed=MINHASH_DEFAULT_SEED,
+    ):
+        # same k-mer size and hash function conventions as MinHash
+        if dayhoff:
+            hash_function = lib.HASH_FUNCTIONS_MURMUR64_DAYHOFF
+        elif hp:
+            hash_function = lib.HASH_FUNCTIONS_MURMUR64_HP
+        elif is_protein:
+            hash_function = lib.HASH_FUNCTIONS_MURMUR64_PROTEIN
+        else:
+            hash_function = lib.HASH_FUNCTIONS_MURMUR64_DNA
+
+        if hash_function != lib.HASH_FUNCTIONS_MURMUR64_DNA:
+            ksize = ksize * 3
+
+        self._objptr = rustcall(
+            lib.hll_with_hash_function, error_rate, ksize, hash_function, seed
+        )
 
     def __len__(self):
         return self.cardinality()
@@ -23,12 +47,43 @@ class HLL(RustObject):
 
     @property
     def ksize(self):
-        return self._methodcall(lib.hll_ksize)
+        k = self._methodcall(lib.hll_ksize)
+        if not self.is_dna:
+            k = k // 3
+        return k
+
+    @property
+    def seed(self):
+        return self._methodcall(lib.hll_seed)
+
+    @property
+    def is_dna(self):
+        return self._methodcall(lib.hll_hash_function) == (
+            lib.HASH_FUNCTIONS_MURMUR64_DNA
+        )
+
+    @property
+    def moltype(self):
+        return {
+            lib.HASH_FUNCTIONS_MURMUR64_DNA: "DNA",
+            lib.HASH_FUNCTIONS_MURMUR64_PROTEIN: "protein",
+            lib.HASH_FUNCTIONS_MURMUR64_DAYHOFF: "dayhoff",
+            lib.HASH_FUNCTIONS_MURMUR64_HP: "hp",
+        }[self._methodcall(lib.hll_hash_function)]
+
+    @property
+    def relative_error(self):
+        "Relative standard error of the cardinality estimate."
+        return self._methodcall(lib.hll_relative_error)
 
     def add_sequence(self, sequence, force=False):
         "Add a sequence into the sketch."
         self._methodcall(lib.hll_add_sequence, to_bytes(sequence), len(sequence), force)
 
+    def add_protein(self, sequence):
+        "Add a protein sequence into the sketch."
+        self._methodcall(lib.hll_add_protein, to_bytes(sequence), len(sequence))
+
     def add_kmer(self, kmer):
         "Add a kmer into the sketch."
         if len(kmer) != self.ksize:
@@ -44,7 +44,7 @@ from sourmash.search import (
     make_containment_query,
     calc_threshold_from_bp,
 )
-from sourmash.manifest import CollectionManifest
+from sourmash.manifest import CollectionManifest, ColumnarCollectionManifest
 from sourmash.logging import debug_literal
 from sourmash.signature import load_signatures, save_signatures
 from sourmash.minhash import (
@@ -650,6 +650,14 @@ class ZipFileLinearIndex(Index):
             manifest = self.manifest
             assert not selection_dict
 
+            if self.supports_transform:
+                # load & parse ahead of time in the Rust core, in row order;
+                # like the loop below, rows not found in their file are skipped.
+                yield from self.storage.iter_sigs(
+                    manifest._columns, manifest._row_indices()
+                )
+                return
+
             # yield all signatures found in manifest
             for filename in manifest.locations():
                 data = self.storage.load(filename)
@@ -725,6 +733,52 @@ class ZipFileLinearIndex(Index):
                 use_manifest=False,
             )
 
+    @property
+    def supports_transform(self):
+        "Can the Rust core load and transform signatures in this collection?"
+        manifest = self.manifest
+        return (
+            isinstance(manifest, ColumnarCollectionManifest)
+            and manifest._columns is not None
+            and bool(self.storage._objptr)
+        )
+
+    def transform_signatures(
+        self, *, flatten=False, scaled=0, num=0, compression=1, batch_size=1000
+    ):
+        """Load, transform and serialize all signatures in this collection.
+
+        Signatures are loaded, optionally flattened or downsampled, and
+        serialized in parallel in the Rust core, 'batch_size' at a time.
+        Yields (row, data) tuples in manifest order, where 'row' is a
+        manifest row for the transformed signature and 'data' is the
+        serialized signature (gzipped JSON unless 'compression' is 0).
+
+        With no transform, signatures stored alone in gzipped members are
+        copied verbatim, without decoding them.
+        """
+        if not self.supports_transform:
+            raise NotImplementedError
+
+        columns = self.manifest._columns
+        indices = self.manifest._row_indices()
+        copy_only = not (flatten or scaled or num)
+        for start in range(0, len(indices), batch_size):
+            batch = indices[start : start + batch_size]
+            if copy_only:
+                yield from self.storage.copy_sigs(
+                    columns, batch, compression=compression
+                )
+            else:
+                yield from self.storage.transform_sigs(
+                    columns,
+                    batch,
+                    flatten=flatten,
+                    scaled=scaled,
+                    num=num,
+                    compression=compression,
+                )
+
 
 class CounterGather:
     """This is an ancillary class that is used to implement "fast
@@ -346,7 +346,7 @@ class SqliteIndex(Index):
 
         # insert all the hashes
         hashes_to_sketch = []
-        for h in ss.minhash.hashes:
+        for h in ss.minhash.hashes_array.tolist():
             hh = convert_hash_to(h)
             hashes_to_sketch.append((hh, sketch_id))
 
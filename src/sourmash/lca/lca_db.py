@@ -202,7 +202,7 @@ class LCA_Database(Index):
             except TypeError:
                 raise ValueError("lineage cannot be used as a key?!")
 
-        for hashval in minhash.hashes:
+        for hashval in minhash.hashes_array.tolist():
             self._hashval_to_idx[hashval].add(idx)
 
         return len(minhash)
@@ -637,7 +637,7 @@ class LCA_Database(Index):
 
         # collect matching hashes for the query:
         c = Counter()
-        query_hashes = set(query_mh.hashes)
+        query_hashes = set(query_mh.hashes_array.tolist())
         for hashval in query_hashes:
             idx_list = self._hashval_to_idx.get(hashval, [])
             for idx in idx_list:
@@ -4,11 +4,16 @@ Manifests for collections of signatures.
 import csv
 import ast
 import gzip
+import io
 import os.path
 from abc import abstractmethod
+from array import array
 import itertools
 
 from sourmash import picklist
+from ._lowlevel import ffi, lib
+from .exceptions import SourmashError
+from .utils import RustObject, rustcall, decode_str
 
 
 class BaseCollectionManifest:
@@ -63,7 +68,6 @@ class BaseCollectionManifest:
     @classmethod
     def load_from_csv(cls, fp):
         "load a manifest from a CSV file."
-        manifest_list = []
         firstline = fp.readline().rstrip()
         if not firstline.startswith("# SOURMASH-MANIFEST-VERSION: "):
             raise ValueError("manifest is missing version header")
@@ -72,15 +76,33 @@ class BaseCollectionManifest:
         if float(version) != 1.0:
             raise ValueError(f"unknown manifest version number {version}")
 
-        r = csv.DictReader(fp)
-        if not r.fieldnames:
+        data = fp.read()
+        fieldnames = next(csv.reader(io.StringIO(data)), None)
+        if not fieldnames:
             raise ValueError("missing column headers in manifest")
 
         for k in cls.required_keys:
-            if k not in r.fieldnames:
+            if k not in fieldnames:
                 raise ValueError(f"missing column '{k}' in manifest.")
 
-        row = None
+        # the columnar manifest only keeps the standard columns; keep any
+        # extra columns around by loading row-wise instead.
+        if set(fieldnames) - set(cls.required_keys):
+            r = csv.DictReader(io.StringIO(data))
+            return CollectionManifest(cls._load_rows_from_csv(r))
+
+        # parse into columns in the Rust core; rows are built on demand.
+        try:
+            columns = _ManifestColumns.from_csv(data.encode("utf-8"))
+        except SourmashError as exc:
+            raise ValueError(f"cannot read manifest: {exc}") from exc
+
+        return ColumnarCollectionManifest(columns)
+
+    @classmethod
+    def _load_rows_from_csv(cls, r):
+        "convert rows from a manifest csv.DictReader to their proper types."
+        manifest_list = []
 
         # do row type conversion
         introws = ("num", "scaled", "ksize", "n_hashes")
@@ -94,7 +116,7 @@ class BaseCollectionManifest:
             row["signature"] = None
             manifest_list.append(row)
 
-        return CollectionManifest(manifest_list)
+        return manifest_list
 
     @classmethod
     def load_from_sql(cls, filename):
@@ -370,3 +392,264 @@ class CollectionManifest(BaseCollectionManifest):
         pl.pickset = {pl._get_value_for_manifest_row(row) for row in self.rows}
 
         return pl
+
+
+class _ManifestColumns(RustObject):
+    "Manifest columns held in the Rust core, with row selection by index."
+
+    __dealloc_func__ = lib.manifest_free
+
+    @classmethod
+    def from_csv(cls, data):
+        ptr = rustcall(lib.manifest_from_buffer, data, len(data))
+        return cls._from_objptr(ptr)
+
+    def __len__(self):
+        return self._methodcall(lib.manifest_len)
+
+    @staticmethod
+    def _indices_arg(indices):
+        if indices is None:
+            return ffi.NULL, 0
+        return ffi.from_buffer("uint64_t[]", indices), len(indices)
+
+    def select(self, indices, *, ksize=None, moltype=None, scaled=False, abund=False):
+        "Return an array of the indices of matching rows, in manifest order."
+        indices_ptr, n_indices = self._indices_arg(indices)
+        moltype = moltype.encode("utf-8") if moltype else ffi.NULL
+
+        size = ffi.new("uintptr_t *")
+        ptr = self._methodcall(
+            lib.manifest_select,
+            indices_ptr,
+            n_indices,
+            ksize or 0,
+            moltype,
+            bool(scaled),
+            bool(abund),
+            size,
+        )
+        size = size[0]
+        try:
+            return array("Q", ffi.buffer(ptr, size * 8))
+        finally:
+            lib.manifest_indices_free(ptr, size)
+
+    def select_picklist(self, indices, matcher):
+        "Return an array of the indices of rows passing the picklist matcher."
+        indices_ptr, n_indices = self._indices_arg(indices)
+
+        size = ffi.new("uintptr_t *")
+        ptr = self._methodcall(
+            lib.manifest_select_picklist,
+            indices_ptr,
+            n_indices,
+            matcher._get_objptr(),
+            size,
+        )
+        size = size[0]
+        try:
+            return array("Q", ffi.buffer(ptr, size * 8))
+        finally:
+            lib.manifest_indices_free(ptr, size)
+
+    def _str_column(self, column, indices_ptr, n_indices):
+        "Return the values of a string column for the given rows."
+        ids = ffi.new("uint32_t[]", n_indices)
+        offsets = ffi.new("const uint64_t **")
+        size = ffi.new("uintptr_t *")
+        text = decode_str(
+            self._methodcall(
+                lib.manifest_str_column,
+                column.encode("utf-8"),
+                indices_ptr,
+                n_indices,
+                ids,
+                offsets,
+                size,
+            )
+        )
+        size = size[0]
+        try:
+            bounds = ffi.unpack(offsets[0], size + 1)
+        finally:
+            lib.manifest_indices_free(ffi.cast("uint64_t *", offsets[0]), size + 1)
+
+        values = [text[start:end] for start, end in zip(bounds, bounds[1:])]
+        return [values[i] for i in ffi.unpack(ids, n_indices)]
+
+    def rows(self, indices=None):
+        "Build row dictionaries for the given rows (default all)."
+        if indices is None:
+            indices = array("Q", range(len(self)))
+        indices_ptr, n_indices = self._indices_arg(indices)
+        if not n_indices:
+            return []
+
+        ksize = ffi.new("uint32_t[]", n_indices)
+        num = ffi.new("uint32_t[]", n_indices)
+        scaled = ffi.new("uint64_t[]", n_indices)
+        n_hashes = ffi.new("uint64_t[]", n_indices)
+        with_abundance = ffi.new("bool[]", n_indices)
+        self._methodcall(
+            lib.manifest_numeric_columns,
+            indices_ptr,
+            n_indices,
+            ksize,
+            num,
+            scaled,
+            n_hashes,
+            with_abundance,
+        )
+
+        columns = {
+            k: self._str_column(k, indices_ptr, n_indices)
+            for k in ("internal_location", "md5", "moltype", "name", "filename")
+        }
+        return [
+            {
+                "internal_location": location,
+                "md5": md5,
+                "md5short": md5[:8],
+                "ksize": k,
+                "moltype": moltype,
+                "num": n,
+                "scaled": sc,
+                "n_hashes": nh,
+                "with_abundance": abund,
+                "name": name,
+                "filename": filename,
+                "signature": None,
+            }
+            for location, md5, k, moltype, n, sc, nh, abund, name, filename in zip(
+                columns["internal_location"],
+                columns["md5"],
+                ffi.unpack(ksize, n_indices),
+                columns["moltype"],
+                ffi.unpack(num, n_indices),
+                ffi.unpack(scaled, n_indices),
+                ffi.unpack(n_hashes, n_indices),
+                ffi.unpack(with_abundance, n_indices),
+                columns["name"],
+                columns["filename"],
+            )
+        ]
+
+    def to_csv(self, indices=None):
+        "Write the given rows (default all) as manifest CSV text."
+        indices_ptr, n_indices = self._indices_arg(indices)
+        return decode_str(
+            self._methodcall(lib.manifest_rows_to_csv, indices_ptr, n_indices)
+        )
+
+
+class ColumnarCollectionManifest(CollectionManifest):
+    """
+    An in-memory manifest stored column-wise in the Rust core.
+
+    Selection runs over the columns and returns a manifest that shares them,
+    restricted to the indices of the matching rows. Row dictionaries are
+    only built when 'rows' is accessed, and only for the selected rows.
+    """
+
+    def __init__(self, columns, indices=None):
+        self._columns = columns
+        self._indices = indices  # None => all rows
+        self._rows = None
+        self._md5s = None
+
+    @classmethod
+    def load_from_manifest(cls, manifest, **kwargs):
+        "Load this manifest from another manifest object."
+        return CollectionManifest(manifest.rows)
+
+    @property
+    def rows(self):
+        if self._rows is None:
+            self._rows = self._columns.rows(self._indices)
+        return self._rows
+
+    @property
+    def _md5_set(self):
+        if self._md5s is None:
+            self._md5s = {row["md5"] for row in self.rows}
+        return self._md5s
+
+    def _add_rows(self, rows):
+        # once rows are added, the columns are out of date; switch over to
+        # the materialized rows.
+        self._md5_set
+        self._columns = self._indices = None
+        super()._add_rows(rows)
+
+    def __bool__(self):
+        return len(self) > 0
+
+    def __len__(self):
+        if self._rows is not None:
+            return len(self._rows)
+        if self._indices is not None:
+            return len(self._indices)
+        return len(self._columns)
+
+    def _row_indices(self):
+        "Return the indices of this manifest's rows in the shared columns."
+        if self._indices is not None:
+            return self._indices
+        return array("Q", range(len(self._columns)))
+
+    def filter_rows(self, row_filter_fn):
+        "Create a new manifest filtered through row_filter_fn."
+        if self._columns is None:
+            return super().filter_rows(row_filter_fn)
+
+        indices = array("Q")
+        rows = []
+        for i, row in zip(self._row_indices(), self.rows):
+            if row_filter_fn(row):
+                indices.append(i)
+                rows.append(row)
+
+        mf = ColumnarCollectionManifest(self._columns, indices)
+        mf._rows = rows
+        return mf
+
+    def select_to_manifest(self, **kwargs):
+        "Do a 'select' and return a new manifest object."
+        if self._columns is None or kwargs.get("num"):
+            # num selection is rare; fall back to filtering rows.
+            return super().select_to_manifest(**kwargs)
+
+        scaled = kwargs.get("scaled")
+        containment = kwargs.get("containment")
+        if containment and not scaled:
+            raise ValueError("'containment' requires 'scaled' in Index.select'")
+
+        indices = self._columns.select(
+            self._indices,
+            ksize=kwargs.get("ksize"),
+            moltype=kwargs.get("moltype"),
+            scaled=scaled or containment,
+            abund=kwargs.get("abund"),
+        )
+        mf = ColumnarCollectionManifest(self._columns, indices)
+
+        pl = kwargs.get("picklist")
+        if pl:
+            mf = mf._select_picklist(pl)
+
+        return mf
+
+    def _select_picklist(self, pl):
+        "Select rows using a native matcher, updating the picklist's counts."
+        matcher, values = pl._native_matcher()
+        indices = self._columns.select_picklist(self._indices, matcher)
+        mf = ColumnarCollectionManifest(self._columns, indices)
+
+        pl.n_queries += len(self)
+        if pl.pickstyle == picklist.PickStyle.INCLUDE:
+            pl.found.update(values[i] for i in matcher.found())
+        else:
+            pl.found.update(pl._get_value_for_manifest_row(row) for row in mf.rows)
+
+        return mf
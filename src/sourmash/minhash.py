@@ -8,6 +8,7 @@ from .distance_utils import (
     jaccard_to_distance,
     containment_to_distance,
     set_size_exact_prob,
+    probit,
 )
 from .logging import notify
 
@@ -20,8 +21,10 @@ __all__ = [
     "hash_murmur",
     "MinHash",
     "FrozenMinHash",
+    "similarity_tile",
 ]
 
+from collections import namedtuple
 from collections.abc import Mapping
 
 from . import VERSION
@@ -133,6 +136,112 @@ def flatten_and_intersect_scaled(mh1, mh2):
     return mh1 & mh2
 
 
+def _borrow_array(mh, func):
+    """Return a read-only NumPy view of a u64 array owned by 'mh'.
+
+    'func' is a *_view FFI function; the view keeps 'mh' alive. Returns
+    None if 'func' returns NULL.
+    """
+    size = ffi.new("uintptr_t *")
+    ptr = mh._methodcall(func, size)
+    size = size[0]
+    if ptr == ffi.NULL:
+        return None
+
+    # the destructor closes over 'mh', so it lives as long as the buffer.
+    ptr = ffi.gc(ptr, lambda _, mh=mh: None)
+    arr = np.frombuffer(ffi.buffer(ptr, size * 8), dtype=np.uint64)
+    arr.flags.writeable = False
+    return arr
+
+
+def _as_hash_array(values):
+    "Return 'values' as a contiguous uint64 NumPy array, copying only if needed."
+    arr = np.asarray(values)
+    if arr.dtype.kind not in "iu" and arr.size:
+        raise TypeError(f"hashes must be integers, not {arr.dtype}")
+    return np.ascontiguousarray(arr, dtype=np.uint64)
+
+
+def _array_ptr(arr):
+    "A uint64_t pointer into the memory of NumPy array 'arr'."
+    return ffi.from_buffer("uint64_t[]", arr)
+
+
+ComparisonStats = namedtuple(
+    "ComparisonStats",
+    [
+        "ksize",
+        "scaled",
+        "self_size",
+        "other_size",
+        "common",
+        "union_size",
+        "self_total_abund",
+        "other_total_abund",
+        "self_common_abund",
+        "other_common_abund",
+        "mean_abund",
+        "median_abund",
+        "std_abund",
+    ],
+)
+ComparisonStats.__doc__ = """\
+Intersection, union and abundance statistics for two sketches.
+
+See ``MinHash.comparison_stats``.
+"""
+
+
+def _debiased_containment(common, denom, scaled):
+    "Containment of 'common' hashes out of 'denom', corrected for FracMinHash bias."
+    if not denom:
+        return 0.0
+    total_denom = float(denom * scaled)  # would be better if hll estimate - see #1798
+    bias_factor = 1.0 - (1.0 - 1.0 / scaled) ** total_denom
+    containment = common / (denom * bias_factor)
+    # debiasing containment can lead to vals outside of 0-1 range. constrain.
+    if containment >= 1:
+        return 1.0
+    elif containment <= 0:
+        return 0.0
+    else:
+        return containment
+
+
+def _objptr_array(minhashes):
+    "A C array of the object pointers of MinHash objects 'minhashes'."
+    ptrs = []
+    for mh in minhashes:
+        if not isinstance(mh, MinHash):
+            raise TypeError("Must be a MinHash!")
+        ptrs.append(mh._get_objptr())
+    return ffi.new("SourmashKmerMinHash *[]", ptrs)
+
+
+def similarity_tile(rows, cols, ignore_abundance=False, downsample=False):
+    """Calculate the similarity of every sketch in ``rows`` with every
+    sketch in ``cols``, in a single call to the Rust core.
+
+    Returns a ``len(rows) x len(cols)`` NumPy array; see
+    ``MinHash.similarity`` for the measure used.
+    """
+    rows = list(rows)
+    cols = list(cols)
+    out = np.zeros((len(rows), len(cols)), dtype=np.float64)
+    rustcall(
+        lib.kmerminhash_similarity_tile,
+        _objptr_array(rows),
+        len(rows),
+        _objptr_array(cols),
+        len(cols),
+        ignore_abundance,
+        downsample,
+        ffi.from_buffer("double[]", out),
+    )
+    return out
+
+
 class _HashesWrapper(Mapping):
     "A read-only view of the hashes contained by a MinHash object."
 
@@ -285,12 +394,27 @@ class MinHash(RustObject):
             self.dayhoff,
             self.hp,
             self.hashes,
-            None,
+            self._hll_bytes(),
             self.track_abundance,
             self._max_hash,
             self.seed,
         )
 
+    def _hll_bytes(self):
+        "The companion HLL, serialized; None if there is none."
+        hll = self.hll
+        if hll is None:
+            return None
+        return bytes(hll.to_bytes())
+
+    def _set_hll_bytes(self, buf):
+        "Restore the companion HLL saved by _hll_bytes."
+        from .hll import HLL
+
+        if buf is not None:
+            hll = HLL.from_buffer(buf)
+            self._methodcall(lib.kmerminhash_set_hll, hll._objptr)
+
     def __setstate__(self, tup):
         "support pickling via __getstate__/__setstate__"
         (
@@ -300,7 +424,7 @@ class MinHash(RustObject):
             dayhoff,
             hp,
             mins,
-            _,
+            hll,
             track_abundance,
             max_hash,
             seed,
@@ -326,10 +450,13 @@ class MinHash(RustObject):
             self.set_abundances(mins)
         else:
             self.add_many(mins)
+        self._set_hll_bytes(hll)
 
     def __eq__(self, other):
         "equality testing via =="
-        return self.__getstate__() == other.__getstate__()
+        # the companion HLL (the 7th field) doesn't take part in equality.
+        state, other_state = self.__getstate__(), other.__getstate__()
+        return state[:6] + state[7:] == other_state[:6] + other_state[7:]
 
     def copy_and_clear(self):
         "Create an empty copy of this MinHash."
@@ -471,22 +598,30 @@ class MinHash(RustObject):
     def add_many(self, hashes):
         """Add many hashes to the sketch at once.
 
-        ``hashes`` can be either an iterable (list, set, etc.), or another
-        ``MinHash`` object.
+        ``hashes`` can be either an iterable (list, set, etc.), another
+        ``MinHash`` object, or a NumPy array of hashes. Arrays are passed
+        to the Rust core without copying (if already ``uint64``); sorted
+        arrays are merged into the sketch in a single pass.
         """
         if isinstance(hashes, MinHash):
             self._methodcall(lib.kmerminhash_add_from, hashes._objptr)
+        elif isinstance(hashes, np.ndarray):
+            arr = _as_hash_array(hashes)
+            self._methodcall(lib.kmerminhash_add_many, _array_ptr(arr), len(arr))
         else:
             self._methodcall(lib.kmerminhash_add_many, list(hashes), len(hashes))
 
     def remove_many(self, hashes):
         """Remove many hashes from a sketch at once.
 
-        ``hashes`` can be either an iterable (list, set, etc.), or another
-        ``MinHash`` object.
+        ``hashes`` can be either an iterable (list, set, etc.), another
+        ``MinHash`` object, or a NumPy array of hashes.
         """
         if isinstance(hashes, MinHash):
             self._methodcall(lib.kmerminhash_remove_from, hashes._objptr)
+        elif isinstance(hashes, np.ndarray):
+            arr = _as_hash_array(hashes)
+            self._methodcall(lib.kmerminhash_remove_many, _array_ptr(arr), len(arr))
         else:
             self._methodcall(lib.kmerminhash_remove_many, list(hashes), len(hashes))
 
@@ -521,27 +656,33 @@ class MinHash(RustObject):
 
     @property
     def hashes(self):
-        size = ffi.new("uintptr_t *")
-        mins_ptr = self._methodcall(lib.kmerminhash_get_mins, size)
-        size = size[0]
+        mins = _borrow_array(self, lib.kmerminhash_mins_view).tolist()
+        if self.track_abundance:
+            abunds = _borrow_array(self, lib.kmerminhash_abunds_view).tolist()
+            assert len(mins) == len(abunds)
+            return _HashesWrapper(dict(zip(mins, abunds)))
+        else:
+            return _HashesWrapper(dict.fromkeys(mins, 1))
 
-        try:
-            if self.track_abundance:
-                size_abunds = ffi.new("uintptr_t *")
-                abunds_ptr = self._methodcall(lib.kmerminhash_get_abunds, size_abunds)
-                size_abunds = size_abunds[0]
-                assert size == size_abunds
-                result = dict(
-                    zip(ffi.unpack(mins_ptr, size), ffi.unpack(abunds_ptr, size))
-                )
-                lib.kmerminhash_slice_free(abunds_ptr, size)
-                return _HashesWrapper(result)
-            else:
-                d = ffi.unpack(mins_ptr, size)
-                return _HashesWrapper({k: 1 for k in d})
+    @property
+    def hashes_array(self):
+        """The hashes in this sketch, in increasing order, as a NumPy array.
 
-        finally:
-            lib.kmerminhash_slice_free(mins_ptr, size)
+        Unlike 'hashes', no Python objects are created per hash. This is a
+        copy; for a FrozenMinHash it is a read-only view, without copying.
+        """
+        return _borrow_array(self, lib.kmerminhash_mins_view).copy()
+
+    @property
+    def abunds_array(self):
+        """The abundances, in the same order as 'hashes_array'.
+
+        None if abundances are not tracked. Copied like 'hashes_array'.
+        """
+        abunds = _borrow_array(self, lib.kmerminhash_abunds_view)
+        if abunds is None:
+            return None
+        return abunds.copy()
 
     @property
     def seed(self):
@@ -615,6 +756,33 @@ class MinHash(RustObject):
         else:
             self._methodcall(lib.kmerminhash_enable_abundance)
 
+    @property
+    def track_hll(self):
+        "Whether a companion HLL counts every k-mer added, for size estimates."
+        return self._methodcall(lib.kmerminhash_track_hll)
+
+    @track_hll.setter
+    def track_hll(self, b):
+        if self.track_hll == b:
+            return
+
+        if b is False:
+            self._methodcall(lib.kmerminhash_disable_hll)
+        elif len(self) > 0:
+            raise RuntimeError("Can only set track_hll=True if the MinHash is empty")
+        else:
+            self._methodcall(lib.kmerminhash_enable_hll)
+
+    @property
+    def hll(self):
+        "A copy of the companion HLL, or None if track_hll is False."
+        from .hll import HLL
+
+        ptr = self._methodcall(lib.kmerminhash_hll)
+        if ptr == ffi.NULL:
+            return None
+        return HLL._from_objptr(ptr)
+
     def add_hash(self, h):
         "Add a single hash value."
         return self._methodcall(lib.kmerminhash_add_hash, h)
@@ -645,6 +813,24 @@ class MinHash(RustObject):
             lib.kmerminhash_count_common, other._get_objptr(), downsample
         )
 
+    def count_common_many(self, others, downsample=False):
+        """\
+        Return the number of hashes in common between ``self`` and each of
+        ``others``, as a NumPy array.
+
+        The comparisons run in a single call to the Rust core.
+        """
+        others = list(others)
+        out = np.zeros(len(others), dtype=np.uint64)
+        self._methodcall(
+            lib.kmerminhash_count_common_many,
+            _objptr_array(others),
+            len(others),
+            downsample,
+            _array_ptr(out),
+        )
+        return out
+
     def intersection_and_union_size(self, other):
         "Calculate intersection and union sizes between `self` and `other`."
         if not isinstance(other, MinHash):
@@ -660,6 +846,24 @@ class MinHash(RustObject):
         usize = ffi.unpack(usize, 1)[0]
         return common, usize
 
+    def comparison_stats(self, other, downsample=False):
+        """\
+        Return a ``ComparisonStats`` tuple with intersection, union and
+        abundance statistics between ``self`` and ``other``.
+
+        Everything is computed in a single pass in the Rust core. Abundance
+        statistics are taken from ``self``. Optionally downsample ``scaled``
+        objects to highest ``scaled`` value.
+        """
+        if not isinstance(other, MinHash):
+            raise TypeError("Must be a MinHash!")
+        stats = self._methodcall(
+            lib.kmerminhash_comparison_stats, other._get_objptr(), downsample
+        )
+        return ComparisonStats._make(
+            getattr(stats, field) for field in ComparisonStats._fields
+        )
+
     def downsample(self, *, num=None, scaled=None):
         """Copy this object and downsample new object to either `num` or
         `scaled`.
@@ -694,9 +898,10 @@ class MinHash(RustObject):
                     f"new scaled {scaled} is lower than current sample scaled {self.scaled}"
                 )
 
-            # acceptable scaled value? reconfigure max_hash, keep num 0.
-            max_hash = _get_max_hash_for_scaled(scaled)
-            num = 0
+            # acceptable scaled value? let the Rust core build the new
+            # object directly, instead of round-tripping the hashes.
+            ptr = self._methodcall(lib.kmerminhash_downsample_scaled, scaled)
+            return MinHash._from_objptr(ptr)
 
         # end checks! create new object:
         a = MinHash(
@@ -731,7 +936,8 @@ class MinHash(RustObject):
                 seed=self.seed,
                 max_hash=self._max_hash,
             )
-            a.add_many(self)
+            # merge (rather than add_many) keeps the companion HLL.
+            a.merge(self)
 
             return a
         return self
@@ -766,10 +972,9 @@ class MinHash(RustObject):
             other_mh = other.downsample(scaled=scaled)
         if jaccard is None:
             jaccard = self_mh.similarity(other_mh, ignore_abundance=True)
-        avg_sketch_kmers = (len(self_mh) + len(other_mh)) / 2
         avg_n_kmers = round(
-            avg_sketch_kmers * scaled
-        )  # would be better if hll estimate - see #1798
+            (self_mh.unique_dataset_hashes + other_mh.unique_dataset_hashes) / 2
+        )
         j_aniresult = jaccard_to_distance(
             jaccard,
             self_mh.ksize,
@@ -804,6 +1009,24 @@ class MinHash(RustObject):
             downsample,
         )
 
+    def similarity_many(self, others, ignore_abundance=False, downsample=False):
+        """Calculate the similarity of ``self`` with each of ``others``,
+        as a NumPy array; see ``similarity``.
+
+        The comparisons run in a single call to the Rust core.
+        """
+        others = list(others)
+        out = np.zeros(len(others), dtype=np.float64)
+        self._methodcall(
+            lib.kmerminhash_similarity_many,
+            _objptr_array(others),
+            len(others),
+            ignore_abundance,
+            downsample,
+            ffi.from_buffer("double[]", out),
+        )
+        return out
+
     def angular_similarity(self, other):
         "Calculate the angular similarity."
         if not (self.track_abundance and other.track_abundance):
@@ -826,18 +1049,8 @@ class MinHash(RustObject):
         denom = len(self)
         if not denom:
             return 0.0
-        total_denom = float(
-            denom * self.scaled
-        )  # would be better if hll estimate - see #1798
-        bias_factor = 1.0 - (1.0 - 1.0 / self.scaled) ** total_denom
-        containment = self.count_common(other, downsample) / (denom * bias_factor)
-        # debiasing containment can lead to vals outside of 0-1 range. constrain.
-        if containment >= 1:
-            return 1.0
-        elif containment <= 0:
-            return 0.0
-        else:
-            return containment
+        common = self.count_common(other, downsample)
+        return _debiased_containment(common, denom, self.scaled)
 
     def containment_ani(
         self,
@@ -861,7 +1074,7 @@ class MinHash(RustObject):
             other_mh = other.downsample(scaled=scaled)
         if containment is None:
             containment = self_mh.contained_by(other_mh)
-        n_kmers = len(self_mh) * scaled  # would be better if hll estimate - see #1798
+        n_kmers = self_mh.unique_dataset_hashes
 
         c_aniresult = containment_to_distance(
             containment,
@@ -888,20 +1101,8 @@ class MinHash(RustObject):
         min_denom = min((len(self), len(other)))
         if not min_denom:
             return 0.0
-        total_denom = float(
-            min_denom * self.scaled
-        )  # would be better if hll estimate - see #1798
-        bias_factor = 1.0 - (1.0 - 1.0 / self.scaled) ** total_denom
-        max_containment = self.count_common(other, downsample) / (
-            min_denom * bias_factor
-        )
-        # debiasing containment can lead to vals outside of 0-1 range. constrain.
-        if max_containment >= 1:
-            return 1.0
-        elif max_containment <= 0:
-            return 0.0
-        else:
-            return max_containment
+        common = self.count_common(other, downsample)
+        return _debiased_containment(common, min_denom, self.scaled)
 
     def max_containment_ani(
         self,
@@ -925,8 +1126,7 @@ class MinHash(RustObject):
             other_mh = other.downsample(scaled=scaled)
         if max_containment is None:
             max_containment = self_mh.max_containment(other_mh)
-        min_n_kmers = min(len(self_mh), len(other_mh))
-        n_kmers = min_n_kmers * scaled  # would be better if hll estimate - see #1798
+        n_kmers = min(self_mh.unique_dataset_hashes, other_mh.unique_dataset_hashes)
 
         c_aniresult = containment_to_distance(
             max_containment,
@@ -1018,8 +1218,29 @@ class MinHash(RustObject):
 
         If ``abund`` value is set to zero, the ``hash`` will be removed from the sketch.
         ``abund`` cannot be set to a negative value.
+
+        ``values`` can also be a ``(hashes, abunds)`` pair of NumPy arrays,
+        which are passed to the Rust core without building a dictionary.
         """
         if self.track_abundance:
+            if isinstance(values, tuple):
+                hashes, abunds = values
+                if np.any(np.asarray(abunds) < 0):
+                    raise ValueError("Abundance cannot be set to a negative value.")
+                hashes = _as_hash_array(hashes)
+                abunds = _as_hash_array(abunds)
+                if len(hashes) != len(abunds):
+                    raise ValueError("hashes and abundances must have the same length")
+
+                self._methodcall(
+                    lib.kmerminhash_set_abundances,
+                    _array_ptr(hashes),
+                    _array_ptr(abunds),
+                    len(hashes),
+                    clear,
+                )
+                return
+
             hashes = []
             abunds = []
 
@@ -1089,6 +1310,17 @@ class MinHash(RustObject):
                 "inflate operates on a flat MinHash and takes a MinHash object with track_abundance=True"
             )
 
+    def inflated_sum_abundances(self, from_mh):
+        """Sum of the abundances in 'from_mh' for all hashes in this MinHash.
+
+        Hashes not present in 'from_mh' are ignored.
+        """
+        if not from_mh.track_abundance:
+            raise ValueError("inflated_sum_abundances requires track_abundance=True")
+        return self._methodcall(
+            lib.kmerminhash_inflated_sum_abundances, from_mh._get_objptr()
+        )
+
     @property
     def sum_abundances(self):
         if self.track_abundance:
@@ -1116,14 +1348,15 @@ class MinHash(RustObject):
     @property
     def unique_dataset_hashes(self):
         """
-        Approximate total number of hashes (num_hashes *scaled).
+        Approximate total number of hashes: the companion HLL estimate if
+        one was collected while sketching, otherwise num_hashes * scaled.
         """
         if not self.scaled:
             raise TypeError(
                 "can only approximate unique_dataset_hashes for scaled MinHashes"
             )
-        # TODO: replace set_size with HLL estimate when that gets implemented
-        return len(self) * self.scaled  # + (self.ksize - 1) for bp estimation
+        # + (self.ksize - 1) for bp estimation
+        return self._methodcall(lib.kmerminhash_n_unique_kmers)
 
     def size_is_accurate(self, relative_error=0.20, confidence=0.95):
         """
@@ -1132,6 +1365,9 @@ class MinHash(RustObject):
         is binomially distributed with parameters sketch_size and 1/scaled. The two-sided Chernoff
         bounds are used.
         Returns True if probability is greater than or equal to the desired confidence.
+
+        If a companion HLL was collected, and has seen any data, its (normal)
+        standard error is used instead.
         """
         if not self.scaled:
             raise TypeError(
@@ -1141,7 +1377,10 @@ class MinHash(RustObject):
             raise ValueError(
                 "Error: relative error and confidence values must be between 0 and 1."
             )
-        # to do: replace unique_dataset_hashes with HLL estimation when it gets implemented
+        if self.track_hll and self.unique_dataset_hashes > 0:
+            z = probit(0.5 + confidence / 2)
+            hll_error = self._methodcall(lib.kmerminhash_hll_relative_error)
+            return z * hll_error <= relative_error
         probability = set_size_exact_prob(
             self.unique_dataset_hashes, self.scaled, relative_error=relative_error
         )
@@ -1176,6 +1415,10 @@ class FrozenMinHash(MinHash):
     def add_protein(self, *args, **kwargs):
         raise TypeError("FrozenMinHash does not support modification")
 
+    @MinHash.track_hll.setter
+    def track_hll(self, b):
+        raise TypeError("FrozenMinHash does not support modification")
+
     def downsample(self, *, num=None, scaled=None):
         if scaled and self.scaled == scaled:
             return self
@@ -1199,13 +1442,21 @@ class FrozenMinHash(MinHash):
     def merge(self, *args, **kwargs):
         raise TypeError("FrozenMinHash does not support modification")
 
+    @property
+    def hashes_array(self):
+        "The hashes in this sketch, as a read-only view into the Rust core."
+        return _borrow_array(self, lib.kmerminhash_mins_view)
+
+    @property
+    def abunds_array(self):
+        "The abundances, as a read-only view; None if not tracked."
+        return _borrow_array(self, lib.kmerminhash_abunds_view)
+
     def to_mutable(self):
         "Return a copy of this MinHash that can be changed."
-        mut = MinHash.__new__(MinHash)
-        state_tup = self.__getstate__()
-
-        mut.__setstate__(state_tup)
-        return mut
+        # copy through the Rust core, avoiding __getstate__ and the
+        # conversion of all hashes into Python objects.
+        return MinHash.__copy__(self)
 
     def to_frozen(self):
         "Return a frozen copy of this MinHash that cannot be changed."
@@ -1224,7 +1475,7 @@ class FrozenMinHash(MinHash):
             dayhoff,
             hp,
             mins,
-            _,
+            hll,
             track_abundance,
             max_hash,
             seed,
@@ -1250,6 +1501,7 @@ class FrozenMinHash(MinHash):
             MinHash.set_abundances(self, mins)
         else:
             MinHash.add_many(self, mins)
+        MinHash._set_hll_bytes(self, hll)
 
     def __copy__(self):
         return self
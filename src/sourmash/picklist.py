@@ -10,9 +10,13 @@ and operate efficiently on manifests, so when used with e.g. zipfiles,
 only the selected sketches are loaded.
 """
 import csv
+import itertools
 import os
 from enum import Enum
 
+from ._lowlevel import ffi, lib
+from .utils import RustObject, rustcall
+
 # set up preprocessing functions for column stuff
 preprocess = {}
 
@@ -121,6 +125,7 @@ class SignaturePicklist:
         self.pickset = None
         self.found = set()
         self.n_queries = 0
+        self._matcher = None
 
     @classmethod
     def from_picklist_args(cls, argstr):
@@ -298,6 +303,25 @@ class SignaturePicklist:
                 return True
         return False
 
+    def _native_matcher(self):
+        """Return the pickset loaded into the Rust core for manifest matching.
+
+        Returns the matcher and the list of values, indexed by matcher id.
+        The matcher is cached until the pickset changes.
+        """
+        pickset = self.pickset
+        if self._matcher is not None:
+            matcher, values, snapshot = self._matcher
+            # compare contents, so in-place changes to the pickset are seen.
+            if snapshot == pickset:
+                return matcher, values
+
+        snapshot = frozenset(pickset)
+        values = list(snapshot)
+        matcher = _PicklistMatcher.create(self.coltype, self.pickstyle, values)
+        self._matcher = (matcher, values, snapshot)
+        return matcher, values
+
     def matched_csv_row(self, row):
         """did the given CSV row object match this picklist?
 
@@ -317,6 +341,40 @@ class SignaturePicklist:
                 yield ss
 
 
+class _PicklistMatcher(RustObject):
+    "Hash-indexed picklist values in the Rust core."
+
+    __dealloc_func__ = lib.picklist_matcher_free
+
+    @classmethod
+    def create(cls, coltype, pickstyle, values):
+        ptr = rustcall(
+            lib.picklist_matcher_new, coltype.encode("utf-8"), pickstyle.value
+        )
+        matcher = cls._from_objptr(ptr)
+
+        # (ident, md5short) tuples are passed in as alternating values
+        if coltype in SignaturePicklist.meta_coltypes:
+            values = itertools.chain.from_iterable(values)
+        buf = b"".join(v.encode("utf-8") + b"\0" for v in values)
+        matcher._methodcall(lib.picklist_matcher_add_many, buf, len(buf))
+
+        return matcher
+
+    def __len__(self):
+        return self._methodcall(lib.picklist_matcher_len)
+
+    def found(self):
+        "Return the ids of all values matched so far."
+        size = ffi.new("uintptr_t *")
+        ptr = self._methodcall(lib.picklist_matcher_found, size)
+        size = size[0]
+        try:
+            return ffi.unpack(ptr, size)
+        finally:
+            lib.manifest_indices_free(ptr, size)
+
+
 def passes_all_picklists(ss, picklists):
     "does the signature 'ss' pass all of the picklists?"
     for picklist in picklists:
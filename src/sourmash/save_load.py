@@ -292,6 +292,14 @@ class Base_SaveSignaturesToLocation:
         for ss in sslist:
             self.add(ss)
 
+    def add_serialized(self, data, row):
+        """Add an already-serialized signature, described by manifest 'row'.
+
+        By default the signature is loaded and passed to 'add'.
+        """
+        for ss in sigmod.load_signatures(data):
+            self.add(ss)
+
 
 def _get_signatures_from_rust(siglist):
     # this function deals with a disconnect between the way Rust
@@ -537,6 +545,21 @@ class SaveSignatures_ZipFile(Base_SaveSignaturesToLocation):
             self.manifest_rows.append(row)
             super().add(ss)
 
+    def add_serialized(self, data, row):
+        "Write an already-serialized signature straight into the zip file."
+        if not self.storage:
+            raise ValueError("this output is not open")
+
+        storage = self.storage
+        path = f"{storage.subdir}/{row['md5']}.sig.gz"
+        location = storage.save(path, data)
+
+        row = dict(row)
+        row.pop("signature", None)
+        row["internal_location"] = location
+        self.manifest_rows.append(row)
+        self.count += 1
+
 
 _save_classes = [
     (10, SaveSignatures_NoOutput),
@@ -1,5 +1,6 @@
 import abc
-from io import BytesIO
+import csv
+from io import BytesIO, StringIO
 import os
 import shutil
 import sys
@@ -92,6 +93,47 @@ class FSStorage(Storage):
         return path.read_bytes()
 
 
+class _SigBatch(RustObject):
+    "Serialized signatures and their manifest rows, from transform_sigs."
+
+    __dealloc_func__ = lib.sigbatch_free
+
+    def __len__(self):
+        return self._methodcall(lib.sigbatch_len)
+
+    def items(self):
+        from .manifest import CollectionManifest
+
+        fp = StringIO(decode_str(self._methodcall(lib.sigbatch_manifest_csv)))
+        fp.readline()  # skip version header
+        rows = CollectionManifest._load_rows_from_csv(csv.DictReader(fp))
+
+        size = ffi.new("uintptr_t *")
+        items = []
+        for i, row in enumerate(rows):
+            ptr = self._methodcall(lib.sigbatch_data, i, size)
+            items.append((row, ffi.buffer(ptr, size[0])[:]))
+
+        return items
+
+
+class _SigIter(RustObject):
+    "Signatures loaded ahead of time in the Rust core, from iter_sigs."
+
+    __dealloc_func__ = lib.sigiter_free
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        from .signature import SourmashSignature
+
+        ptr = self._methodcall(lib.sigiter_next)
+        if ptr == ffi.NULL:
+            raise StopIteration
+        return SourmashSignature._from_objptr(ptr)
+
+
 class ZipStorage(RustObject, Storage):
     __dealloc_func__ = lib.zipstorage_free
 
@@ -167,6 +209,60 @@ class ZipStorage(RustObject, Storage):
         except ValueError:
             raise FileNotFoundError(path)
 
+    def transform_sigs(
+        self, columns, indices, *, flatten=False, scaled=0, num=0, compression=1
+    ):
+        """Load, transform and serialize the signatures for manifest rows.
+
+        'columns' are manifest columns in the Rust core, and 'indices' is an
+        array of row indices. Signatures are processed in parallel; returns
+        a list of (row, data) tuples in the order of 'indices'.
+        """
+        ptr = self._methodcall(
+            lib.zipstorage_transform_sigs,
+            columns._get_objptr(),
+            ffi.from_buffer("uint64_t[]", indices),
+            len(indices),
+            flatten,
+            scaled or 0,
+            num or 0,
+            compression,
+        )
+        return _SigBatch._from_objptr(ptr).items()
+
+    def copy_sigs(self, columns, indices, *, compression=1):
+        """Serialize the signatures for manifest rows, without transforms.
+
+        Like 'transform_sigs', but gzipped members holding a single
+        signature are copied verbatim instead of being decoded.
+        """
+        ptr = self._methodcall(
+            lib.zipstorage_copy_sigs,
+            columns._get_objptr(),
+            ffi.from_buffer("uint64_t[]", indices),
+            len(indices),
+            compression,
+        )
+        return _SigBatch._from_objptr(ptr).items()
+
+    def iter_sigs(self, columns, indices, *, read_ahead=64):
+        """Iterate over the signatures for manifest rows.
+
+        'columns' are manifest columns in the Rust core, and 'indices' is an
+        array of row indices. Signatures are decompressed and parsed on a
+        background thread, up to 'read_ahead' at a time, and yielded in the
+        order of 'indices'. Rows whose md5 is not found in their storage
+        member are skipped.
+        """
+        ptr = self._methodcall(
+            lib.zipstorage_iter_sigs,
+            columns._get_objptr(),
+            ffi.from_buffer("uint64_t[]", indices),
+            len(indices),
+            read_ahead,
+        )
+        return _SigIter._from_objptr(ptr)
+
     def list_sbts(self):
         if self.__inner:
             return self.__inner.list_sbts()
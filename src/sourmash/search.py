@@ -2,6 +2,7 @@
 Code for searching collections of signatures.
 """
 import csv
+import warnings
 import numpy as np
 from enum import Enum
 from dataclasses import dataclass
@@ -473,7 +474,8 @@ class GatherResult(PrefetchResult):
     gather_querymh: MinHash = None
     gather_result_rank: int = None
     orig_query_len: int = None
-    orig_query_abunds: list = None
+    orig_query_abund_mh: MinHash = None
+    orig_query_abunds: dict = None  # deprecated; use orig_query_abund_mh
     sum_weighted_found: int = None
     total_weighted_hashes: int = None
 
@@ -543,19 +545,34 @@ class GatherResult(PrefetchResult):
             raise ValueError(
                 "Error: must provide sum of all abundances ('total_weighted_hashes') to GatherResult"
             )
-        if not self.orig_query_abunds:
+        if self.orig_query_abund_mh is None and self.orig_query_abunds:
+            warnings.warn(
+                "GatherResult 'orig_query_abunds' is deprecated; "
+                "pass the original query sketch as 'orig_query_abund_mh'",
+                DeprecationWarning,
+                stacklevel=4,
+            )
+            abund_mh = self.query.minhash.copy_and_clear()
+            abund_mh.track_abundance = True
+            abund_mh.set_abundances(self.orig_query_abunds)
+            self.orig_query_abund_mh = abund_mh
+        if self.orig_query_abund_mh is None:
             raise ValueError(
-                "Error: must provide original query abundances ('orig_query_abunds') to GatherResult"
+                "Error: must provide original query sketch ('orig_query_abund_mh') to GatherResult"
             )
 
     def build_gather_result(self):
         # build gather-specific attributes
 
         # the 'query' that is passed into gather is all _matched_ hashes, after subtracting noident_mh
-        # this affects estimation of original query information, and requires us to pass in orig_query_len and orig_query_abunds.
+        # this affects estimation of original query information, and requires us to pass in orig_query_len and orig_query_abund_mh.
         # we also need to overwrite self.query_bp, self.query_n_hashes, and self.query_abundance
         # todo: find a better solution?
-        self.query_bp = self.orig_query_len * self.query.minhash.scaled
+        if self.orig_query_abund_mh.track_hll:
+            # the companion HLL counts every k-mer of the original query.
+            self.query_bp = self.orig_query_abund_mh.unique_dataset_hashes
+        else:
+            self.query_bp = self.orig_query_len * self.query.minhash.scaled
         self.query_n_hashes = self.orig_query_len
 
         # calculate intersection with query hashes:
@@ -568,23 +585,11 @@ class GatherResult(PrefetchResult):
         self.f_match = (
             self.gather_comparison.mh2_containment_in_mh1
         )  # unique match containment
-        self.f_orig_query = len(self.cmp.intersect_mh) / self.orig_query_len
-        assert (
-            self.gather_comparison.intersect_mh.contained_by(
-                self.gather_comparison.mh1_cmp
-            )
-            == 1.0
-        )
+        self.f_orig_query = self.cmp.stats.common / self.orig_query_len
 
         # calculate fractions wrt second denominator - metagenome size
-        assert (
-            self.gather_comparison.intersect_mh.contained_by(
-                self.gather_comparison.mh2_cmp
-            )
-            == 1.0
-        )
         self.f_unique_to_query = (
-            len(self.gather_comparison.intersect_mh) / self.orig_query_len
+            self.gather_comparison.stats.common / self.orig_query_len
         )
 
         # here, need to make sure to use the mh1_cmp (bc was downsampled to cmp_scaled)
@@ -595,23 +600,18 @@ class GatherResult(PrefetchResult):
 
         # calculate stats on abundances, if desired.
         self.average_abund, self.median_abund, self.std_abund = None, None, None
-        if not self.ignore_abundance:
-            self.query_weighted_unique_intersection = (
-                self.gather_comparison.weighted_intersection(
-                    from_abundD=self.orig_query_abunds
-                )
-            )
-            self.average_abund = self.query_weighted_unique_intersection.mean_abundance
-            self.median_abund = self.query_weighted_unique_intersection.median_abundance
-            self.std_abund = self.query_weighted_unique_intersection.std_abundance
-            # 'query' will be flattened by default. reset track abundance if we have abunds
-            self.query_abundance = (
-                self.query_weighted_unique_intersection.track_abundance
-            )
-            # calculate scores weighted by abundances
-            self.n_unique_weighted_found = (
-                self.query_weighted_unique_intersection.sum_abundances
-            )
+        if not self.ignore_abundance and self.orig_query_abund_mh.track_abundance:
+            # take abundances of the unique intersection from the original
+            # query, in a single pass.
+            abund_mh = self.orig_query_abund_mh
+            if abund_mh.scaled != self.cmp_scaled:
+                abund_mh = abund_mh.downsample(scaled=self.cmp_scaled)
+            stats = abund_mh.comparison_stats(self.gather_comparison.intersect_mh)
+            self.average_abund = stats.mean_abund
+            self.median_abund = stats.median_abund
+            self.std_abund = stats.std_abund
+            self.query_abundance = True
+            self.n_unique_weighted_found = stats.self_common_abund
             self.f_unique_weighted = (
                 self.n_unique_weighted_found / self.total_weighted_hashes
             )
@@ -798,13 +798,9 @@ class GatherDatabases:
         self.orig_query_name = query.name
         self.orig_query_md5 = query.md5sum()[:8]
 
-        # do we pay attention to abundances?
+        # keep the original query sketch for abundance-weighted sums.
         query_mh = query.minhash
-        query_hashes = query_mh.hashes
-        if track_abundance:
-            orig_query_abunds = query_hashes
-        else:
-            orig_query_abunds = {k: 1 for k in query_hashes}
+        query_abund_mh = query_mh
 
         # adjust for not found...
         if noident_mh is None:  # create empty
@@ -818,6 +814,9 @@ class GatherDatabases:
             query_mh = ident_mh.to_mutable()
 
         orig_query_mh = query_mh.flatten()
+        # the remaining query loses hashes every round, which a companion
+        # HLL can't follow, so its size is estimated from the hashes alone.
+        orig_query_mh.track_hll = False
 
         # query.minhash will be assigned to repeatedly in gather; make mutable.
         query = query.to_mutable()
@@ -832,7 +831,9 @@ class GatherDatabases:
 
         self.track_abundance = track_abundance
         self.orig_query_mh = orig_query_mh
-        self.orig_query_abunds = orig_query_abunds
+        # abundance-weighted sums are computed against this sketch
+        # in the Rust core.
+        self.orig_query_abund_mh = query_abund_mh
 
         self.cmp_scaled = 0  # initialize with something very low!
         self._update_scaled(cmp_scaled)
@@ -846,28 +847,39 @@ class GatherDatabases:
         if self.cmp_scaled != max_scaled:
             self.cmp_scaled = max_scaled
 
-            # CTB note: this can be expensive
             self.orig_query_mh = self.orig_query_mh.downsample(scaled=scaled)
             self.noident_mh = self.noident_mh.downsample(scaled=scaled)
-
-            # NOTE: orig_query_abunds can be used w/o downsampling
-            orig_query_abunds = self.orig_query_abunds
-            self.noident_query_sum_abunds = sum(
-                orig_query_abunds[k] for k in self.noident_mh.hashes
-            )
-            self.total_weighted_hashes = sum(
-                orig_query_abunds[k] for k in self.orig_query_mh.hashes
+            self.orig_query_abund_mh = self.orig_query_abund_mh.downsample(
+                scaled=scaled
             )
+
+            self.noident_query_sum_abunds = self._weighted_sum(self.noident_mh)
+            self.total_weighted_hashes = self._weighted_sum(self.orig_query_mh)
             self.total_weighted_hashes += self.noident_query_sum_abunds
 
+            # remaining query weight needs to be recalculated at new scaled.
+            self.remaining_weighted_hashes = None
+
         if max_scaled != scaled:
             return max_scaled
         return max_scaled
 
+    def _weighted_sum(self, mh):
+        "Sum of the original query abundances for the hashes in 'mh'."
+        if self.track_abundance:
+            return mh.inflated_sum_abundances(self.orig_query_abund_mh)
+        return len(mh)
+
     @property
     def scaled(self):
         return self.cmp_scaled
 
+    @property
+    def remaining_bp(self):
+        "Estimated bp of the query not yet assigned to a match."
+        query_mh = self.query.minhash
+        return len(query_mh) * query_mh.scaled
+
     def __iter__(self):
         return self
 
@@ -881,7 +893,6 @@ class GatherDatabases:
 
         # will not be changed::
         threshold_bp = self.threshold_bp
-        orig_query_abunds = self.orig_query_abunds
 
         # find the best match!
         best_result, intersect_mh = _find_best(counters, query, threshold_bp)
@@ -911,14 +922,19 @@ class GatherDatabases:
         query_mh = query.minhash.downsample(scaled=scaled)
         found_mh = best_match.minhash.downsample(scaled=scaled).flatten()
 
+        if self.remaining_weighted_hashes is None:
+            self.remaining_weighted_hashes = self._weighted_sum(query_mh)
+
         # construct a new query, subtracting hashes found in previous one.
         new_query_mh = query_mh.to_mutable()
         new_query_mh.remove_many(found_mh)
         new_query = SourmashSignature(new_query_mh)
 
-        # compute weighted information for remaining query hashes
-        query_hashes = set(new_query_mh.hashes)
-        n_weighted_missed = sum(orig_query_abunds[k] for k in query_hashes)
+        # update weighted information for remaining query hashes, by
+        # subtracting the weight of the hashes removed in this round.
+        removed_mh = query_mh.intersection(found_mh)
+        self.remaining_weighted_hashes -= self._weighted_sum(removed_mh)
+        n_weighted_missed = self.remaining_weighted_hashes
         n_weighted_missed += self.noident_query_sum_abunds
         sum_weighted_found = total_weighted_hashes - n_weighted_missed
 
@@ -933,7 +949,7 @@ class GatherDatabases:
             ignore_abundance=not self.track_abundance,
             threshold_bp=threshold_bp,
             orig_query_len=orig_query_len,
-            orig_query_abunds=self.orig_query_abunds,
+            orig_query_abund_mh=self.orig_query_abund_mh,
             estimate_ani_ci=self.estimate_ani_ci,
             sum_weighted_found=sum_weighted_found,
             total_weighted_hashes=total_weighted_hashes,
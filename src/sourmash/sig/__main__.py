@@ -47,6 +47,7 @@ from sourmash.logging import (
 from sourmash import sourmash_args
 from sourmash.minhash import _get_max_hash_for_scaled
 from sourmash.manifest import CollectionManifest
+from sourmash.save_load import SaveSignatures_ZipFile
 
 
 usage = """
@@ -129,25 +130,26 @@ def cat(args):
 
     _extend_signatures_with_from_file(args)
 
-    # start loading!
+    def keep_row(row):
+        md5 = row["md5"]
+        encountered_md5sums[md5] += 1
+        return not (args.unique and encountered_md5sums[md5] > 1)
+
+    # start loading! zip to zip copies skip decoding where possible.
     progress = sourmash_args.SignatureLoadingProgress()
-    loader = sourmash_args.load_many_signatures(
+    sourmash_args.transform_many_signatures(
         args.signatures,
+        progress,
+        save_sigs,
+        native_transform=lambda manifest: {},
+        row_filter=keep_row,
         ksize=args.ksize,
         moltype=moltype,
         picklist=picklist,
-        progress=progress,
         yield_all_files=args.force,
         force=args.force,
         pattern=pattern_search,
     )
-    for ss, sigloc in loader:
-        md5 = ss.md5sum()
-        encountered_md5sums[md5] += 1
-        if args.unique and encountered_md5sums[md5] > 1:
-            continue
-
-        save_sigs.add(ss)
 
     notify(f"loaded {len(save_sigs)} signatures total.")
     if picklist:
@@ -419,8 +421,8 @@ def overlap(args):
 
     scaled = sig1.minhash.scaled
 
-    hashes_1 = set(sig1.minhash.hashes)
-    hashes_2 = set(sig2.minhash.hashes)
+    hashes_1 = set(sig1.minhash.hashes_array.tolist())
+    hashes_2 = set(sig2.minhash.hashes_array.tolist())
 
     num_common = len(hashes_1 & hashes_2)
     disjoint_1 = len(hashes_1 - hashes_2)
@@ -552,7 +554,7 @@ def intersect(args):
     for sigobj, sigloc in loader:
         if first_sig is None:
             first_sig = sigobj
-            mins = set(sigobj.minhash.hashes)
+            mins = set(sigobj.minhash.hashes_array.tolist())
         else:
             # check signature compatibility -- if no ksize/moltype specified
             # 'first_sig' may be incompatible with later sigs.
@@ -560,7 +562,7 @@ def intersect(args):
                 error("incompatible minhashes; specify -k and/or molecule type.")
                 sys.exit(-1)
 
-        mins.intersection_update(sigobj.minhash.hashes)
+        mins.intersection_update(sigobj.minhash.hashes_array.tolist())
 
     if first_sig is None:
         notify("no signatures provided to intersect!?")
@@ -659,7 +661,7 @@ def subtract(args):
         error("Cannot use subtract on signatures with abundance tracking, sorry!")
         sys.exit(1)
 
-    subtract_mins = set(from_mh.hashes)
+    subtract_mins = set(from_mh.hashes_array.tolist())
 
     notify(f"loaded signature from {from_sigfile}...", end="\r")
 
@@ -679,7 +681,7 @@ def subtract(args):
                 )
                 sys.exit(1)
 
-            subtract_mins -= set(sigobj.minhash.hashes)
+            subtract_mins.difference_update(sigobj.minhash.hashes_array.tolist())
 
             notify(f"loaded and subtracted signatures from {sigfile}...", end="\r")
 
@@ -810,6 +812,14 @@ def extract(args):
                 error("** and then pipe the output to 'sourmash sig extract")
                 sys.exit(-1)
 
+        # zip to zip? serialize in the Rust core, in parallel.
+        if getattr(idx, "supports_transform", False) and isinstance(
+            save_sigs, SaveSignatures_ZipFile
+        ):
+            for row, data in idx.transform_signatures():
+                save_sigs.add_serialized(data, row)
+            continue
+
         for ss in idx.signatures():
             save_sigs.add(ss)
 
@@ -889,30 +899,38 @@ def flatten(args):
     save_sigs = sourmash_args.SaveSignaturesToLocation(args.output)
     save_sigs.open()
 
+    def keep_row(row):
+        # select!
+        if args.md5 is not None:
+            if args.md5 not in row["md5"]:
+                return False  # skip
+
+        if args.name is not None:
+            if args.name not in (row["name"] or ""):
+                return False  # skip
+
+        return True
+
+    def flatten_sig(ss):
+        ss = ss.to_mutable()
+        ss.minhash = ss.minhash.flatten()
+        return ss
+
     # start loading!
     progress = sourmash_args.SignatureLoadingProgress()
-    loader = sourmash_args.load_many_signatures(
+    sourmash_args.transform_many_signatures(
         args.signatures,
+        progress,
+        save_sigs,
+        transform_fn=flatten_sig,
+        native_transform=lambda manifest: dict(flatten=True),
+        row_filter=keep_row,
         ksize=args.ksize,
         moltype=moltype,
         picklist=picklist,
-        progress=progress,
         yield_all_files=args.force,
         force=args.force,
     )
-    for ss, sigloc in loader:
-        # select!
-        if args.md5 is not None:
-            if args.md5 not in ss.md5sum():
-                continue  #  skip
-
-        if args.name is not None:
-            if args.name not in ss.name:
-                continue  # skip
-
-        ss = ss.to_mutable()
-        ss.minhash = ss.minhash.flatten()
-        save_sigs.add(ss)
 
     save_sigs.close()
 
@@ -943,18 +961,17 @@ def downsample(args):
     save_sigs = sourmash_args.SaveSignaturesToLocation(args.output)
     save_sigs.open()
 
-    # start loading!
-    progress = sourmash_args.SignatureLoadingProgress()
-    loader = sourmash_args.load_many_signatures(
-        args.signatures,
-        ksize=args.ksize,
-        moltype=moltype,
-        picklist=picklist,
-        progress=progress,
-        yield_all_files=args.force,
-        force=args.force,
-    )
-    for ss, sigloc in loader:
+    def native_downsample(manifest):
+        # the Rust core only downsamples scaled to scaled and num to num;
+        # interconversion and errors go through downsample_sig.
+        for row in manifest.rows:
+            if args.scaled and not (row["scaled"] and row["scaled"] <= args.scaled):
+                return None
+            if args.num_hashes and not (row["num"] >= args.num_hashes):
+                return None
+        return dict(scaled=int(args.scaled or 0), num=args.num_hashes or 0)
+
+    def downsample_sig(ss):
         sigobj = ss.to_mutable()
         mh = sigobj.minhash
 
@@ -988,7 +1005,22 @@ def downsample(args):
                 _set_num_scaled(mh_new, args.num_hashes, 0)
 
         sigobj.minhash = mh_new
-        save_sigs.add(sigobj)
+        return sigobj
+
+    # start loading!
+    progress = sourmash_args.SignatureLoadingProgress()
+    sourmash_args.transform_many_signatures(
+        args.signatures,
+        progress,
+        save_sigs,
+        transform_fn=downsample_sig,
+        native_transform=native_downsample,
+        ksize=args.ksize,
+        moltype=moltype,
+        picklist=picklist,
+        yield_all_files=args.force,
+        force=args.force,
+    )
 
     save_sigs.close()
 
@@ -1293,8 +1325,8 @@ def kmers(args):
     # calculate overlap, even for num minhashes which ordinarily don't
     # permit it, because here we are interested in knowing how many
     # of the expected hashes we found.
-    query_hashes = set(query_mh.hashes)
-    found_hashes = set(found_mh.hashes)
+    query_hashes = set(query_mh.hashes_array.tolist())
+    found_hashes = set(found_mh.hashes_array.tolist())
     cont = len(query_hashes.intersection(found_hashes)) / len(query_hashes)
 
     notify(f"found {len(found_mh)} distinct matching hashes ({cont*100:.1f}%)")
@@ -3,8 +3,10 @@ Sketch Comparison Classes
 """
 import numpy as np
 from dataclasses import dataclass
+from functools import cached_property
 
-from .minhash import MinHash
+from .minhash import MinHash, _debiased_containment
+from .distance_utils import containment_to_distance_many
 
 
 @dataclass
@@ -50,6 +52,11 @@ class BaseMinHashComparison:
         self.ksize = self.mh1.ksize
         self.moltype = self.mh1.moltype
 
+    @cached_property
+    def stats(self):
+        "Intersection, union and abundance stats for the compared sketches."
+        return self.mh1_cmp.comparison_stats(self.mh2_cmp)
+
     @property
     def intersect_mh(self):
         # flatten and intersect
@@ -57,7 +64,8 @@ class BaseMinHashComparison:
 
     @property
     def jaccard(self):
-        return self.mh1_cmp.jaccard(self.mh2_cmp)
+        stats = self.stats
+        return stats.common / max(1, stats.union_size)
 
     def estimate_jaccard_ani(self, jaccard=None):
         jinfo = self.mh1_cmp.jaccard_ani(self.mh2_cmp, jaccard=jaccard)
@@ -131,15 +139,16 @@ class FracMinHashComparison(BaseMinHashComparison):
         To get true bp estimates, we would need to add `(k-1)`. However, this complicates
         the iterative gather algorithm, so let's stick with hashes.
         """
-        return (
-            len(self.intersect_mh) * self.cmp_scaled
-        )  # + (ksize-1) #for bp estimation
+        return self.stats.common * self.cmp_scaled  # + (ksize-1) #for bp estimation
 
     @property
     def mh1_containment_in_mh2(self):
-        return self.mh1_cmp.contained_by(self.mh2_cmp)
+        stats = self.stats
+        return _debiased_containment(stats.common, stats.self_size, self.cmp_scaled)
 
     def estimate_ani_from_mh1_containment_in_mh2(self, containment=None):
+        if containment is None:
+            containment = self.mh1_containment_in_mh2
         # build result once
         m1_cani = self.mh1_cmp.containment_ani(
             self.mh2_cmp,
@@ -148,6 +157,9 @@ class FracMinHashComparison(BaseMinHashComparison):
             estimate_ci=self.estimate_ani_ci,
         )
         #                                            prob_threshold=self.pfn_threshold)
+        self._set_ani_from_mh1_containment_in_mh2(m1_cani)
+
+    def _set_ani_from_mh1_containment_in_mh2(self, m1_cani):
         # propagate params
         self.ani_from_mh1_containment_in_mh2 = m1_cani.ani
         if m1_cani.p_exceeds_threshold:
@@ -159,9 +171,12 @@ class FracMinHashComparison(BaseMinHashComparison):
 
     @property
     def mh2_containment_in_mh1(self):
-        return self.mh2_cmp.contained_by(self.mh1_cmp)
+        stats = self.stats
+        return _debiased_containment(stats.common, stats.other_size, self.cmp_scaled)
 
     def estimate_ani_from_mh2_containment_in_mh1(self, containment=None):
+        if containment is None:
+            containment = self.mh2_containment_in_mh1
         m2_cani = self.mh2_cmp.containment_ani(
             self.mh1_cmp,
             containment=containment,
@@ -169,6 +184,9 @@ class FracMinHashComparison(BaseMinHashComparison):
             estimate_ci=self.estimate_ani_ci,
         )
         #                                            prob_threshold=self.pfn_threshold)
+        self._set_ani_from_mh2_containment_in_mh1(m2_cani)
+
+    def _set_ani_from_mh2_containment_in_mh1(self, m2_cani):
         self.ani_from_mh2_containment_in_mh1 = m2_cani.ani
         if m2_cani.p_exceeds_threshold:
             self.potential_false_negative = True
@@ -178,9 +196,13 @@ class FracMinHashComparison(BaseMinHashComparison):
 
     @property
     def max_containment(self):
-        return self.mh1_cmp.max_containment(self.mh2_cmp)
+        stats = self.stats
+        min_denom = min(stats.self_size, stats.other_size)
+        return _debiased_containment(stats.common, min_denom, self.cmp_scaled)
 
     def estimate_max_containment_ani(self, max_containment=None):
+        if max_containment is None:
+            max_containment = self.max_containment
         mc_ani_info = self.mh1_cmp.max_containment_ani(
             self.mh2_cmp,
             max_containment=max_containment,
@@ -198,7 +220,7 @@ class FracMinHashComparison(BaseMinHashComparison):
 
     @property
     def avg_containment(self):
-        return self.mh1_cmp.avg_containment(self.mh2_cmp)
+        return (self.mh1_containment_in_mh2 + self.mh2_containment_in_mh1) / 2
 
     @property
     def avg_containment_ani(self):
@@ -219,9 +241,29 @@ class FracMinHashComparison(BaseMinHashComparison):
             ) / 2
 
     def estimate_all_containment_ani(self):
-        "Estimate all containment ANI values."
-        self.estimate_ani_from_mh1_containment_in_mh2()
-        self.estimate_ani_from_mh2_containment_in_mh1()
+        """Estimate all containment ANI values.
+
+        Both directions of this comparison go through one
+        containment_to_distance_many call, so the confidence interval roots
+        are found in the Rust core.
+        """
+        m1_cani, m2_cani = containment_to_distance_many(
+            [self.mh1_containment_in_mh2, self.mh2_containment_in_mh1],
+            self.mh1_cmp.ksize,
+            self.cmp_scaled,
+            n_unique_kmers=[
+                self.mh1_cmp.unique_dataset_hashes,
+                self.mh2_cmp.unique_dataset_hashes,
+            ],
+            confidence=self.ani_confidence,
+            estimate_ci=self.estimate_ani_ci,
+        )
+        # null out ANI if either mh size estimation is inaccurate
+        if self.size_may_be_inaccurate:
+            m1_cani.size_is_inaccurate = True
+            m2_cani.size_is_inaccurate = True
+        self._set_ani_from_mh1_containment_in_mh2(m1_cani)
+        self._set_ani_from_mh2_containment_in_mh1(m2_cani)
         if any(
             [
                 self.ani_from_mh1_containment_in_mh2 is None,
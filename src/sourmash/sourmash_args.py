@@ -48,10 +48,15 @@ import argparse
 
 from .logging import notify, error, debug_literal
 
-from .index import LinearIndex
+from .index import LinearIndex, ZipFileLinearIndex
 from .picklist import SignaturePicklist, PickStyle
 from .manifest import CollectionManifest
-from .save_load import SaveSignaturesToLocation, load_file_as_index, _load_database
+from .save_load import (
+    SaveSignaturesToLocation,
+    SaveSignatures_ZipFile,
+    load_file_as_index,
+    _load_database,
+)
 
 
 DEFAULT_LOAD_K = 31
@@ -522,6 +527,12 @@ class _DictReader_with_version:
     def __iter__(self):
         yield from self.reader
 
+    def rows(self):
+        "Iterate over the remaining rows as lists, in 'fieldnames' order."
+        for row in self.reader.reader:
+            if row:  # skip blank lines, as DictReader does
+                yield row
+
 
 @contextlib.contextmanager
 def FileInputCSV(
@@ -666,9 +677,10 @@ class SignatureLoadingProgress:
         self.short_notify(f"Loaded {n_this} sigs from '{location}'", end="\r")
 
 
-def load_many_signatures(
+def _load_many_from_indexes(
     locations,
     progress,
+    load_fn,
     *,
     yield_all_files=False,
     ksize=None,
@@ -678,16 +690,8 @@ def load_many_signatures(
     pattern=None,
 ):
     """
-    Load many signatures from multiple files, with progress indicators.
-
-    Takes ksize, moltype, and picklist selectors.
-
-    If 'yield_all_files=True' then tries to load all files in specified
-    directories.
-
-    If 'force=True' then continues past survivable errors.
-
-    Yields (sig, location) tuples.
+    Open and select each location in turn, and yield the items returned by
+    'load_fn(idx)', with progress indicators and error handling.
     """
     for loc in locations:
         try:
@@ -698,12 +702,12 @@ def load_many_signatures(
             idx = apply_picklist_and_pattern(idx, picklist, pattern)
 
             # start up iterator,
-            loader = idx.signatures_with_location()
+            loader = load_fn(idx)
 
             # go!
             n = 0  # count signatures loaded
-            for sig, sigloc in progress.start_file(loc, loader):
-                yield sig, sigloc
+            for item in progress.start_file(loc, loader):
+                yield item
                 n += 1
             notify(f"loaded {n} signatures from '{loc}'", end="\r")
         except ValueError as exc:
@@ -723,6 +727,129 @@ def load_many_signatures(
     notify(f"loaded {len(progress)} signatures total, from {n_files} files")
 
 
+def load_many_signatures(
+    locations,
+    progress,
+    *,
+    yield_all_files=False,
+    ksize=None,
+    moltype=None,
+    picklist=None,
+    force=False,
+    pattern=None,
+):
+    """
+    Load many signatures from multiple files, with progress indicators.
+
+    Takes ksize, moltype, and picklist selectors.
+
+    If 'yield_all_files=True' then tries to load all files in specified
+    directories.
+
+    If 'force=True' then continues past survivable errors.
+
+    Yields (sig, location) tuples.
+    """
+    yield from _load_many_from_indexes(
+        locations,
+        progress,
+        lambda idx: idx.signatures_with_location(),
+        yield_all_files=yield_all_files,
+        ksize=ksize,
+        moltype=moltype,
+        picklist=picklist,
+        force=force,
+        pattern=pattern,
+    )
+
+
+def transform_many_signatures(
+    locations,
+    progress,
+    save_sigs,
+    *,
+    transform_fn=None,
+    native_transform=None,
+    row_filter=None,
+    yield_all_files=False,
+    ksize=None,
+    moltype=None,
+    picklist=None,
+    force=False,
+    pattern=None,
+):
+    """
+    Load signatures from multiple files, transform them, and save them.
+
+    Selection, progress and error handling are as in 'load_many_signatures';
+    progress counts the signatures saved.
+
+    If 'row_filter' is given, only signatures whose manifest rows pass it
+    are saved. 'transform_fn(ss)' returns the signature to save.
+
+    When saving to a zip file, zip collections with manifests bypass
+    'transform_fn' and are instead loaded, transformed and serialized in
+    parallel by the Rust core. 'native_transform(manifest)' returns the
+    keyword arguments for 'ZipFileLinearIndex.transform_signatures', or
+    None if this manifest must go through 'transform_fn'.
+
+    Returns the number of signatures saved.
+    """
+    use_native = native_transform is not None and isinstance(
+        save_sigs, SaveSignatures_ZipFile
+    )
+
+    def save_native(idx, kwargs):
+        if row_filter is not None:
+            manifest = idx.manifest.filter_rows(row_filter)
+            idx = ZipFileLinearIndex(
+                idx.storage,
+                traverse_yield_all=idx.traverse_yield_all,
+                manifest=manifest,
+                use_manifest=True,
+            )
+
+        for row, data in idx.transform_signatures(**kwargs):
+            save_sigs.add_serialized(data, row)
+            yield row
+
+    def save_each(idx):
+        for ss, sigloc in idx.signatures_with_location():
+            if row_filter is not None:
+                row = CollectionManifest.make_manifest_row(
+                    ss, sigloc, include_signature=False
+                )
+                if not row_filter(row):
+                    continue
+
+            if transform_fn is not None:
+                ss = transform_fn(ss)
+            save_sigs.add(ss)
+            yield ss
+
+    def load_fn(idx):
+        kwargs = None
+        if use_native and getattr(idx, "supports_transform", False):
+            kwargs = native_transform(idx.manifest)
+
+        if kwargs is not None:
+            return save_native(idx, kwargs)
+        return save_each(idx)
+
+    saved = _load_many_from_indexes(
+        locations,
+        progress,
+        load_fn,
+        yield_all_files=yield_all_files,
+        ksize=ksize,
+        moltype=moltype,
+        picklist=picklist,
+        force=force,
+        pattern=pattern,
+    )
+    return sum(1 for _ in saved)
+
+
 def get_manifest(idx, *, require=True, rebuild=False):
     """
     Retrieve a manifest for this idx, loaded with `load_file_as_index`.
@@ -6,8 +6,11 @@ import csv
 from collections import abc, defaultdict
 from itertools import zip_longest
 from typing import NamedTuple
-from dataclasses import dataclass, field, replace, asdict, fields
+from dataclasses import MISSING, dataclass, field, replace, asdict, fields
 import gzip
+import struct
+
+import numpy as np
 
 from sourmash import sqlite_utils, sourmash_args
 from sourmash.exceptions import IndexNotSupported
@@ -810,6 +813,57 @@ def parse_lingroups(lingroupD):
     return lg_ranks, all_lgs
 
 
+def get_lineages(tax_assignments, idents):
+    """Retrieve lineages for many identifiers in one call, if the taxonomy
+    supports it. Returns a dictionary; missing identifiers are skipped."""
+    try:
+        get_many = tax_assignments.get_many
+    except AttributeError:
+        pass
+    else:
+        return get_many(idents)
+
+    results = {}
+    for ident in set(idents):
+        lin = tax_assignments.get(ident)
+        if lin is not None:
+            results[ident] = lin
+    return results
+
+
+def _gather_columns(gather_csv, header, rows):
+    """
+    Split gather CSV rows into columns, keyed by GatherRow field name.
+
+    Raises ValueError if any essential GatherRow column is missing; optional
+    columns that are not in the CSV are filled with their default.
+    """
+    col_idx = {name: i for i, name in enumerate(header)}
+    # 'match_name' and 'name' should be interchangeable (sourmash 4.x)
+    if "match_name" in col_idx and "name" not in col_idx:
+        col_idx["name"] = col_idx["match_name"]
+
+    missing_msg = f"'{gather_csv}' is missing columns needed for taxonomic summarization. Please run gather with sourmash >= 4.4."
+
+    columns = {}
+    for fld in fields(GatherRow):
+        i = col_idx.get(fld.name)
+        if i is None:
+            if fld.default is MISSING:
+                raise ValueError(missing_msg)
+            columns[fld.name] = [fld.default] * len(rows)
+        elif fld.default is MISSING:
+            # short rows are missing this column, too.
+            if any(i >= len(row) for row in rows):
+                raise ValueError(missing_msg)
+            columns[fld.name] = [row[i] for row in rows]
+        else:
+            columns[fld.name] = [
+                row[i] if i < len(row) else fld.default for row in rows
+            ]
+    return columns
+
+
 def load_gather_results(
     gather_csv,
     tax_assignments,
@@ -822,10 +876,19 @@ def load_gather_results(
     keep_identifier_versions=False,
     lins=False,
     ictv=False,
+    lineages=None,
 ):
-    "Load a single gather csv"
+    """
+    Load a single gather csv.
+
+    The CSV is read into columns, and each query's rows are added to its
+    QueryTaxResult as arrays. Match lineages are interned in 'lineages', a
+    LineageInterner that can be shared across CSVs.
+    """
     if not seen_queries:
         seen_queries = set()
+    if lineages is None:
+        lineages = LineageInterner(lins=lins, ictv=ictv)
     header = []
     gather_results = {}
     with sourmash_args.FileInputCSV(gather_csv) as r:
@@ -835,46 +898,92 @@ def load_gather_results(
             raise ValueError(
                 f"Cannot read gather results from '{gather_csv}'. Is file empty?"
             )
-
-        this_querytaxres = None
-        for n, row in enumerate(r):
-            # try reading each gather row into a TaxResult
-            try:
-                filt_row = filter_row(
-                    row, GatherRow
-                )  # filter row first to allow extra (unused) columns in csv
-                gatherRow = GatherRow(**filt_row)
-            except TypeError as exc:
-                raise ValueError(
-                    f"'{gather_csv}' is missing columns needed for taxonomic summarization. Please run gather with sourmash >= 4.4."
-                ) from exc
-            # check if we've seen this query already in a different gather CSV
-            if gatherRow.query_name in seen_queries:
+        rows = list(r.rows())
+
+    if rows:
+        columns = _gather_columns(gather_csv, header, rows)
+        del rows
+        n_rows = len(columns["name"])
+
+        # group rows by query, checking that each query's info is consistent
+        query_rows = {}
+        query_keys = {}
+        query_cols = [columns[f.name] for f in fields(QueryInfo)]
+        for i, key in enumerate(zip(*query_cols)):
+            query_name = key[0]
+            these_rows = query_rows.get(query_name)
+            if these_rows is None:
                 # do not allow loading of same query from a second CSV.
-                raise ValueError(
-                    f"Gather query {gatherRow.query_name} was found in more than one CSV. Cannot load from '{gather_csv}'."
-                )
-            taxres = TaxResult(
-                raw=gatherRow,
+                if query_name in seen_queries:
+                    raise ValueError(
+                        f"Gather query {query_name} was found in more than one CSV. Cannot load from '{gather_csv}'."
+                    )
+                query_rows[query_name] = [i]
+                query_keys[query_name] = key
+            else:
+                first_key = query_keys[query_name]
+                if key != first_key and QueryInfo(*key) != QueryInfo(*first_key):
+                    raise ValueError(
+                        "Error: Cannot add TaxResult: query information does not match."
+                    )
+                these_rows.append(i)
+
+        f_unique_weighted = np.fromiter(
+            map(float, columns["f_unique_weighted"]), dtype=np.float64, count=n_rows
+        )
+        f_unique_to_query = np.fromiter(
+            map(float, columns["f_unique_to_query"]), dtype=np.float64, count=n_rows
+        )
+        unique_intersect_bp = np.fromiter(
+            map(int, columns["unique_intersect_bp"]), dtype=np.int64, count=n_rows
+        )
+
+        # look up the lineages for all distinct matches in one go.
+        idents = [
+            get_ident(
+                name,
                 keep_full_identifiers=keep_full_identifiers,
                 keep_identifier_versions=keep_identifier_versions,
+            )
+            for name in columns["name"]
+        ]
+        distinct_idents = list(dict.fromkeys(idents))
+        found = get_lineages(tax_assignments, distinct_idents)
+
+        ident_ids = {}
+        for ident in distinct_idents:
+            if skip_idents and ident in skip_idents:
+                ident_ids[ident] = LineageInterner.SKIPPED
+                continue
+            lin = found.get(ident)
+            if lin:
+                ident_ids[ident] = lineages.add_lineage_tuples(lin)
+            elif fail_on_missing_taxonomy:
+                raise ValueError(
+                    f"Error: ident '{ident}' is not in the taxonomy database. Failing, as requested via --fail-on-missing-taxonomy"
+                )
+            else:
+                ident_ids[ident] = LineageInterner.MISSED
+        lineage_ids = np.fromiter(
+            (ident_ids[ident] for ident in idents), dtype=np.int64, count=n_rows
+        )
+
+        for query_name, these_rows in query_rows.items():
+            q_res = QueryTaxResult(
+                QueryInfo(*query_keys[query_name]),
                 lins=lins,
                 ictv=ictv,
+                lineages=lineages,
             )
-            taxres.get_match_lineage(
-                tax_assignments=tax_assignments,
-                skip_idents=skip_idents,
-                fail_on_missing_taxonomy=fail_on_missing_taxonomy,
+            these_rows = np.array(these_rows, dtype=np.int64)
+            q_res.add_rows(
+                [idents[i] for i in these_rows],
+                lineage_ids[these_rows],
+                f_unique_weighted[these_rows],
+                f_unique_to_query[these_rows],
+                unique_intersect_bp[these_rows],
             )
-            # add to matching QueryTaxResult or create new one
-            if not this_querytaxres or not this_querytaxres.is_compatible(taxres):
-                # get existing or initialize new
-                this_querytaxres = gather_results.get(
-                    gatherRow.query_name,
-                    QueryTaxResult(taxres.query_info, lins=lins, ictv=ictv),
-                )
-            this_querytaxres.add_taxresult(taxres)
-            gather_results[gatherRow.query_name] = this_querytaxres
+            gather_results[query_name] = q_res
 
     if not gather_results:
         raise ValueError(f"No gather results loaded from {gather_csv}.")
@@ -905,6 +1014,8 @@ def check_and_load_gather_csvs(
     gather_results = {}
     header = []
     n_ignored = 0
+    # intern lineages once across all CSVs
+    lineages = LineageInterner(lins=lins, ictv=ictv)
     for n, gather_csv in enumerate(gather_csvs):
         these_results = {}
         try:
@@ -918,6 +1029,7 @@ def check_and_load_gather_csvs(
                 fail_on_missing_taxonomy=fail_on_missing_taxonomy,
                 lins=lins,
                 ictv=ictv,
+                lineages=lineages,
             )
         except ValueError as exc:
             if force:
@@ -970,7 +1082,7 @@ def report_missing_and_skipped_identities(gather_results):
         # totals are total rows in gather that were missed - do we want to report these at all?
         total_n_missed += querytaxres.n_missed
         total_n_skipped += querytaxres.n_skipped
-        total_taxresults += len(querytaxres.raw_taxresults)
+        total_taxresults += querytaxres.n_taxresults
 
     if ident_missed:
         notify(
@@ -1226,6 +1338,11 @@ class LineageDB(abc.Mapping):
         "Are there any lineages at all in this database?"
         return bool(self.assignments)
 
+    def get_many(self, idents):
+        "Retrieve lineages for many identifiers at once; skip missing idents."
+        assignments = self.assignments
+        return {ident: assignments[ident] for ident in idents if ident in assignments}
+
     @classmethod
     def load(
         cls,
@@ -1553,6 +1670,29 @@ class LineageDB_Sqlite(abc.Mapping):
 
         raise KeyError(ident)
 
+    def get_many(self, idents):
+        "Retrieve lineages for many identifiers at once; skip missing idents."
+        c = self.conn.cursor()
+        idents = list(set(idents))
+
+        # keep well under sqlite's limit on the number of host parameters.
+        results = {}
+        chunk_size = 500
+        for start in range(0, len(idents), chunk_size):
+            chunk = idents[start : start + chunk_size]
+            placeholders = ",".join("?" * len(chunk))
+            c.execute(
+                f"SELECT ident, superkingdom, phylum, class, order_, family, genus, species, strain FROM {self.table_name} WHERE ident IN ({placeholders})",
+                chunk,
+            )
+            for ident, *names in c:
+                tup = self._make_tup(names)
+                while tup and not tup[-1].name:
+                    tup = tup[:-1]
+                results[ident] = tup
+
+        return results
+
     def __bool__(self):
         "Do we have any info?"
         return bool(len(self))
@@ -1585,6 +1725,252 @@ class LineageDB_Sqlite(abc.Mapping):
             yield ident, self._make_tup(names)
 
 
+class LineageDB_Binary(abc.Mapping):
+    """
+    A read-only LineageDB in a compact, memory-mapped binary format.
+
+    Only the header is parsed on load; identifiers and lineages are read
+    from the mapped file on demand. Layout (integers are little-endian):
+
+        magic               8 bytes, b'SMTAXDB1'
+        header length       uint32
+        header              JSON: version, ranks, counts, section offsets
+        data sections, 8-byte aligned, offsets relative to data start:
+          name_offsets      uint64[n_names + 1], into name_data
+          name_data         utf-8 names; name 0 is the empty name
+          lineages          uint32[n_lineages, n_ranks], name ids
+          ident_offsets     uint64[n_idents + 1], into ident_data
+          ident_data        utf-8 identifiers, sorted bytewise
+          ident_lineages    uint32[n_idents], lineage ids
+
+    Names are interned, and lineages are deduplicated and shared between
+    identifiers; identifiers are found by binary search.
+    """
+
+    magic = b"SMTAXDB1"
+    version = "1.0"
+
+    def __init__(self, location):
+        import mmap
+        import json
+
+        with open(location, "rb") as fp:
+            self.mm = mmap.mmap(fp.fileno(), 0, access=mmap.ACCESS_READ)
+
+        mm = self.mm
+        (header_len,) = struct.unpack_from("<I", mm, len(self.magic))
+        header_start = len(self.magic) + 4
+        header = json.loads(mm[header_start : header_start + header_len])
+        if header["version"] != self.version:
+            raise ValueError(
+                f"unsupported binary taxonomy database version {header['version']}"
+            )
+
+        self.ranks = tuple(header["ranks"])
+        self.available_ranks = set(header["available_ranks"])
+        n_ranks = len(self.ranks)
+        n_names = header["n_names"]
+        n_lineages = header["n_lineages"]
+        self.n_idents = header["n_idents"]
+
+        data_start = _align8(header_start + header_len)
+        sections = {k: data_start + v for k, v in header["sections"].items()}
+
+        def view(name, dtype, count):
+            return np.frombuffer(mm, dtype=dtype, count=count, offset=sections[name])
+
+        self._name_offsets = view("name_offsets", "<u8", n_names + 1)
+        self._name_data = sections["name_data"]
+        self._lineages = view("lineages", "<u4", n_lineages * n_ranks).reshape(
+            n_lineages, n_ranks
+        )
+        self._ident_offsets = view("ident_offsets", "<u8", self.n_idents + 1)
+        self._ident_data = sections["ident_data"]
+        self._ident_lineages = view("ident_lineages", "<u4", self.n_idents)
+
+        # lineage tuples are built once per lineage id, on demand.
+        self._lineage_cache = {}
+
+    @classmethod
+    def load(cls, location):
+        "load taxonomy information from an existing binary lineage database"
+        try:
+            with open(location, "rb") as fp:
+                magic = fp.read(len(cls.magic))
+        except OSError:
+            raise ValueError("not a binary taxonomy database")
+
+        if magic != cls.magic:
+            raise ValueError("not a binary taxonomy database")
+
+        return cls(location)
+
+    @classmethod
+    def create(cls, filename, items):
+        "save (ident, lineage_tup) pairs as a binary lineage database"
+        import json
+
+        # ranks come from the lineages themselves, so that any lineage class
+        # (NCBI/GTDB, ICTV, LIN) round-trips.
+        ranks = []
+        names = {"": 0}
+        lineages = {}
+        idents = []
+        available_ranks = set()
+        for ident, tax in items:
+            name_ids = []
+            for i, pair in enumerate(tax):
+                if i == len(ranks):
+                    ranks.append(pair.rank)
+                elif ranks[i] != pair.rank:
+                    raise ValueError(
+                        f"inconsistent ranks in lineage for identifier {ident}"
+                    )
+
+                name_id = 0
+                if pair.name:
+                    name_id = names.setdefault(pair.name, len(names))
+                    available_ranks.add(pair.rank)
+                name_ids.append(name_id)
+
+            while name_ids and not name_ids[-1]:
+                name_ids.pop()
+
+            lin_id = lineages.setdefault(tuple(name_ids), len(lineages))
+            idents.append((ident.encode("utf-8"), lin_id))
+
+        idents.sort()
+
+        def pack_strings(strs):
+            offsets = np.zeros(len(strs) + 1, dtype="<u8")
+            offsets[1:] = np.cumsum([len(s) for s in strs])
+            return offsets.tobytes(), b"".join(strs)
+
+        name_offsets, name_data = pack_strings([n.encode("utf-8") for n in names])
+        ident_offsets, ident_data = pack_strings([i for i, _ in idents])
+        lineage_table = np.zeros((len(lineages), len(ranks)), dtype="<u4")
+        for lin_id, name_ids in enumerate(lineages):
+            lineage_table[lin_id, : len(name_ids)] = name_ids
+        ident_lineages = np.array([lin_id for _, lin_id in idents], dtype="<u4")
+
+        data = [
+            ("name_offsets", name_offsets),
+            ("name_data", name_data),
+            ("lineages", lineage_table.tobytes()),
+            ("ident_offsets", ident_offsets),
+            ("ident_data", ident_data),
+            ("ident_lineages", ident_lineages.tobytes()),
+        ]
+
+        sections = {}
+        pos = 0
+        for name, buf in data:
+            sections[name] = pos
+            pos = _align8(pos + len(buf))
+
+        header = dict(
+            version=cls.version,
+            ranks=list(ranks),
+            available_ranks=sorted(available_ranks),
+            n_names=len(names),
+            n_lineages=len(lineages),
+            n_idents=len(idents),
+            sections=sections,
+        )
+        header = json.dumps(header).encode("utf-8")
+
+        with open(filename, "wb") as fp:
+            fp.write(cls.magic)
+            fp.write(struct.pack("<I", len(header)))
+            fp.write(header)
+            _pad8(fp)
+            for name, buf in data:
+                fp.write(buf)
+                _pad8(fp)
+
+    def _ident(self, i):
+        "utf-8 bytes of the i'th (sorted) identifier"
+        start = self._ident_data + int(self._ident_offsets[i])
+        end = self._ident_data + int(self._ident_offsets[i + 1])
+        return self.mm[start:end]
+
+    def _find(self, ident, lo=0):
+        "binary search for encoded 'ident'; return (found, position)"
+        hi = self.n_idents
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if self._ident(mid) < ident:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo < self.n_idents and self._ident(lo) == ident, lo
+
+    def _name(self, name_id):
+        start = self._name_data + int(self._name_offsets[name_id])
+        end = self._name_data + int(self._name_offsets[name_id + 1])
+        return self.mm[start:end].decode("utf-8")
+
+    def _lineage(self, lin_id):
+        "build (and cache) the lineage tuple for this lineage id"
+        tup = self._lineage_cache.get(lin_id)
+        if tup is None:
+            tup = [
+                LineagePair(rank, self._name(name_id))
+                for rank, name_id in zip(self.ranks, self._lineages[lin_id])
+            ]
+            while tup and not tup[-1].name:
+                tup.pop()
+            tup = tuple(tup)
+            self._lineage_cache[lin_id] = tup
+        return tup
+
+    def __getitem__(self, ident):
+        "Retrieve lineage for identifer"
+        found, pos = self._find(ident.encode("utf-8"))
+        if not found:
+            raise KeyError(ident)
+        return self._lineage(int(self._ident_lineages[pos]))
+
+    def get_many(self, idents):
+        "Retrieve lineages for many identifiers at once; skip missing idents."
+        # walk the sorted queries and index together, narrowing the search.
+        results = {}
+        pos = 0
+        for encoded, ident in sorted((i.encode("utf-8"), i) for i in set(idents)):
+            found, pos = self._find(encoded, pos)
+            if found:
+                results[ident] = self._lineage(int(self._ident_lineages[pos]))
+        return results
+
+    def __bool__(self):
+        "Do we have any info?"
+        return bool(self.n_idents)
+
+    def __len__(self):
+        "Return number of identifiers"
+        return self.n_idents
+
+    def __iter__(self):
+        "Return all identifiers"
+        for i in range(self.n_idents):
+            yield self._ident(i).decode("utf-8")
+
+    def items(self):
+        "return all (identifier, lineage_tup) pairs in the database"
+        for i in range(self.n_idents):
+            ident = self._ident(i).decode("utf-8")
+            yield ident, self._lineage(int(self._ident_lineages[i]))
+
+
+def _align8(pos):
+    return (pos + 7) & ~7
+
+
+def _pad8(fp):
+    "pad file to an 8-byte boundary"
+    fp.write(b"\0" * (_align8(fp.tell()) - fp.tell()))
+
+
 class MultiLineageDB(abc.Mapping):
     "A wrapper for (dynamically) combining multiple lineage databases."
 
@@ -1645,6 +2031,18 @@ class MultiLineageDB(abc.Mapping):
         # not found? KeyError!
         raise KeyError(ident)
 
+    def get_many(self, idents):
+        "Retrieve lineages for many identifiers at once; skip missing idents."
+        results = {}
+        remaining = set(idents)
+        for db in self.lineage_dbs:
+            if not remaining:
+                break
+            found = get_lineages(db, remaining)
+            results.update(found)
+            remaining.difference_update(found)
+        return results
+
     def __len__(self):
         "Return number of distinct identifiers. Currently iterates over all."
         # CTB: maybe we can make this unnecessary?
@@ -1656,7 +2054,7 @@ class MultiLineageDB(abc.Mapping):
         return any(bool(db) for db in self.lineage_dbs)
 
     def save(self, filename_or_fp, file_format):
-        assert file_format in ("sql", "csv")
+        assert file_format in ("sql", "csv", "bin")
 
         is_filename = False
         try:
@@ -1670,6 +2068,12 @@ class MultiLineageDB(abc.Mapping):
                     "file format '{file_format}' requires a filename, not a file handle"
                 )
             self._save_sqlite(filename_or_fp)
+        elif file_format == "bin":
+            if not is_filename:
+                raise ValueError(
+                    f"file format '{file_format}' requires a filename, not a file handle"
+                )
+            LineageDB_Binary.create(filename_or_fp, self.items())
         elif file_format == "csv":
             # we need a file handle; open file.
             fp = filename_or_fp
@@ -1774,13 +2178,21 @@ class MultiLineageDB(abc.Mapping):
             # try faster formats first
             loaded = False
 
-            # sqlite db?
+            # binary lineage db?
             try:
-                this_tax_assign = LineageDB_Sqlite.load(location)
+                this_tax_assign = LineageDB_Binary.load(location)
                 loaded = True
             except ValueError:
                 pass
 
+            # sqlite db?
+            if not loaded:
+                try:
+                    this_tax_assign = LineageDB_Sqlite.load(location)
+                    loaded = True
+                except ValueError:
+                    pass
+
             # CSV file?
             if not loaded:
                 try:
@@ -2225,31 +2637,113 @@ class ClassificationResult(SummarizedGatherResult):
         return krona_classified, krona_unclassified
 
 
+class LineageInterner:
+    """
+    Intern lineages to integer ids, so that gather rows can refer to their
+    match lineage by id and be summarized with array ops.
+
+    One interner can be shared by all queries loaded from a set of gather
+    CSVs: each distinct lineage is then built once, and popped to each rank
+    once, however many rows and queries refer to it.
+    """
+
+    # lineage ids for rows without a lineage
+    MISSED = -1
+    SKIPPED = -2
+
+    def __init__(self, *, lins=False, ictv=False):
+        if lins:
+            self.lineage_class = LINLineageInfo
+        elif ictv:
+            self.lineage_class = ICTVRankLineageInfo
+        else:
+            self.lineage_class = RankLineageInfo
+        self.lineages = []
+        self._ids = {}
+        self._tuple_ids = {}
+        self._at_rank = {}
+
+    def __len__(self):
+        return len(self.lineages)
+
+    def __getitem__(self, lin_id):
+        return self.lineages[lin_id]
+
+    def add(self, lineage):
+        "Intern a LineageInfo, returning its id."
+        lin_id = self._ids.get(lineage)
+        if lin_id is None:
+            lin_id = len(self.lineages)
+            self._ids[lineage] = lin_id
+            self.lineages.append(lineage)
+        return lin_id
+
+    def add_lineage_tuples(self, lineage):
+        "Intern a lineage given as LineagePair tuples, returning its id."
+        lineage = tuple(lineage)
+        lin_id = self._tuple_ids.get(lineage)
+        if lin_id is None:
+            lin_id = self.add(self.lineage_class(lineage=lineage))
+            self._tuple_ids[lineage] = lin_id
+        return lin_id
+
+    def ids_at_rank(self, rank):
+        """
+        Return an array mapping each lineage id to the id of that lineage
+        popped to 'rank', or -1 where 'rank' is not filled.
+        """
+        at_rank, ids = self._at_rank.get(rank, ([], None))
+        if ids is None or len(at_rank) < len(self.lineages):
+            # popped lineages are interned too, so keep going until they
+            # have been mapped as well.
+            while len(at_rank) < len(self.lineages):
+                lineage = self.lineages[len(at_rank)]
+                if rank in lineage.filled_ranks:
+                    at_rank.append(self.add(lineage.pop_to_rank(rank)))
+                else:
+                    at_rank.append(-1)
+            ids = np.array(at_rank, dtype=np.int64)
+            self._at_rank[rank] = (at_rank, ids)
+        return ids
+
+
 @dataclass
 class QueryTaxResult:
     """
-    Class for storing all TaxResults (gather results rows) for a query.
+    Class for storing all gather results rows for a query.
     Checks query compatibility prior to adding a TaxResult.
-    Stores raw TaxResults and provides methods for summarizing up ranks
+    Stores the rows as columns, with match lineages interned in a
+    LineageInterner, and provides methods for summarizing up ranks
     and reporting these summarized results as metagenome summaries or
     genome classifications.
 
+    Rows are not kept as TaxResult objects: the 'raw_taxresults' list of
+    earlier versions is gone, and 'n_taxresults' gives the number of rows.
+
     Contains methods for formatting results for different outputs.
     """
 
     query_info: QueryInfo  # initialize with QueryInfo dataclass
     lins: bool = False
     ictv: bool = False
+    lineages: LineageInterner = None  # shared between queries, if provided
 
     def __post_init__(self):
         self.query_name = self.query_info.query_name  # for convenience
+        if self.lineages is None:
+            self.lineages = LineageInterner(lins=self.lins, ictv=self.ictv)
         self._init_taxresult_vars()
         self._init_summarization_vars()
         self._init_classification_results()
 
     def _init_taxresult_vars(self):
         self.ranks = []
-        self.raw_taxresults = []
+        # one entry per gather row
+        self.match_idents = []
+        self.lineage_ids = np.empty(0, dtype=np.int64)
+        self.f_unique_weighted = np.empty(0, dtype=np.float64)
+        self.f_unique_to_query = np.empty(0, dtype=np.float64)
+        self.unique_intersect_bp = np.empty(0, dtype=np.int64)
         self.skipped_idents = set()
         self.missed_idents = set()
         self.n_missed = 0
@@ -2291,6 +2785,11 @@ class QueryTaxResult:
         else:
             return self.ranks[::-1]
 
+    @property
+    def n_taxresults(self):
+        "Number of gather rows added for this query."
+        return len(self.match_idents)
+
     def add_taxresult(self, taxresult):
         # check that all query parameters match
         if self.is_compatible(taxresult=taxresult):
@@ -2301,17 +2800,63 @@ class QueryTaxResult:
             if not self.ranks:
                 self.ranks = taxresult.lineageInfo.ranks
             if taxresult.skipped_ident:
-                self.n_skipped += 1
-                self.skipped_idents.add(taxresult.match_ident)
+                lin_id = LineageInterner.SKIPPED
             elif taxresult.missed_ident:
-                self.n_missed += 1
-                self.missed_idents.add(taxresult.match_ident)
-            self.raw_taxresults.append(taxresult)
+                lin_id = LineageInterner.MISSED
+            else:
+                lin_id = self.lineages.add(taxresult.lineageInfo)
+            self.add_rows(
+                [taxresult.match_ident],
+                [lin_id],
+                [taxresult.f_unique_weighted],
+                [taxresult.f_unique_to_query],
+                [taxresult.unique_intersect_bp],
+            )
         else:
             raise ValueError(
                 "Error: Cannot add TaxResult: query information does not match."
             )
 
+    def add_rows(
+        self,
+        match_idents,
+        lineage_ids,
+        f_unique_weighted,
+        f_unique_to_query,
+        unique_intersect_bp,
+    ):
+        """
+        Add gather rows for this query, given as columns. 'lineage_ids' are
+        ids in self.lineages, or LineageInterner.MISSED/SKIPPED.
+        """
+        lineage_ids = np.asarray(lineage_ids, dtype=np.int64)
+        if not self.ranks and len(lineage_ids):
+            first_id = lineage_ids[0]
+            if first_id >= 0:
+                self.ranks = self.lineages[first_id].ranks
+            else:
+                self.ranks = self.lineages.lineage_class().ranks
+
+        for i in np.flatnonzero(lineage_ids < 0):
+            if lineage_ids[i] == LineageInterner.SKIPPED:
+                self.n_skipped += 1
+                self.skipped_idents.add(match_idents[i])
+            else:
+                self.n_missed += 1
+                self.missed_idents.add(match_idents[i])
+
+        self.match_idents.extend(match_idents)
+        self.lineage_ids = np.concatenate([self.lineage_ids, lineage_ids])
+        self.f_unique_weighted = np.concatenate(
+            [self.f_unique_weighted, np.asarray(f_unique_weighted, dtype=np.float64)]
+        )
+        self.f_unique_to_query = np.concatenate(
+            [self.f_unique_to_query, np.asarray(f_unique_to_query, dtype=np.float64)]
+        )
+        self.unique_intersect_bp = np.concatenate(
+            [self.unique_intersect_bp, np.asarray(unique_intersect_bp, dtype=np.int64)]
+        )
+
     def summarize_up_ranks(self, single_rank=None, force_resummarize=False):
         if self.summarized_ranks:  # has already been summarized
             if force_resummarize:
@@ -2331,33 +2876,58 @@ class QueryTaxResult:
         notify(
             f"Starting summarization up rank(s): {', '.join(self.summarized_ranks)} "
         )
-        for taxres in self.raw_taxresults:
-            lininfo = taxres.lineageInfo
+        lineage_ids = self.lineage_ids
+        # won't always have lineage to summarize (skipped idents, missed idents)
+        has_lineage = lineage_ids >= 0
+        # notify + track perfect matches
+        for i in np.flatnonzero(has_lineage & (self.f_unique_to_query >= 1.0)):
+            match_ident = self.match_idents[i]
             if (
-                lininfo and lininfo.filled_lineage
-            ):  # won't always have lineage to summarize (skipped idents, missed idents)
-                # notify + track perfect matches
-                if taxres.f_unique_to_query >= 1.0:
-                    if taxres.match_ident not in self.perfect_match:
-                        notify(
-                            f"WARNING: 100% match! Is query '{self.query_name}' identical to its database match, '{taxres.match_ident}'?"
-                        )
-                        self.perfect_match.add(taxres.match_ident)
-                # add this taxresult to summary
-                for rank in self.summarized_ranks:
-                    if (
-                        rank in lininfo.filled_ranks
-                    ):  # only store if this rank is filled.
-                        lin_at_rank = lininfo.pop_to_rank(rank)
-                        self.sum_uniq_weighted[rank][
-                            lin_at_rank
-                        ] += taxres.f_unique_weighted
-                        self.sum_uniq_to_query[rank][
-                            lin_at_rank
-                        ] += taxres.f_unique_to_query
-                        self.sum_uniq_bp[rank][
-                            lin_at_rank
-                        ] += taxres.unique_intersect_bp
+                self.lineages[lineage_ids[i]].filled_lineage
+                and match_ident not in self.perfect_match
+            ):
+                notify(
+                    f"WARNING: 100% match! Is query '{self.query_name}' identical to its database match, '{match_ident}'?"
+                )
+                self.perfect_match.add(match_ident)
+
+        rows = np.flatnonzero(has_lineage)
+        for rank in self.summarized_ranks:
+            # lineage at rank for each row; -1 if this rank is not filled.
+            rank_ids = self.lineages.ids_at_rank(rank)[lineage_ids[rows]]
+            keep = rank_ids >= 0
+            if not keep.any():
+                continue
+            rank_ids = rank_ids[keep]
+            rank_rows = rows[keep]
+
+            # number the lineages at rank in order of first appearance, so
+            # the summary dicts keep the order of the rows.
+            uniq, first, inverse = np.unique(
+                rank_ids, return_index=True, return_inverse=True
+            )
+            order = np.argsort(first)
+            position = np.empty_like(order)
+            position[order] = np.arange(len(order))
+            groups = position[inverse.ravel()]
+            n_groups = len(uniq)
+
+            # bincount accumulates in row order, so these sums are
+            # identical to adding up the rows one at a time.
+            sum_weighted = np.bincount(
+                groups, weights=self.f_unique_weighted[rank_rows], minlength=n_groups
+            )
+            sum_to_query = np.bincount(
+                groups, weights=self.f_unique_to_query[rank_rows], minlength=n_groups
+            )
+            sum_bp = np.zeros(n_groups, dtype=np.int64)
+            np.add.at(sum_bp, groups, self.unique_intersect_bp[rank_rows])
+
+            for idx, lin_id in enumerate(uniq[order]):
+                lin_at_rank = self.lineages[lin_id]
+                self.sum_uniq_weighted[rank][lin_at_rank] = float(sum_weighted[idx])
+                self.sum_uniq_to_query[rank][lin_at_rank] = float(sum_to_query[idx])
+                self.sum_uniq_bp[rank][lin_at_rank] = int(sum_bp[idx])
         # reset ranks levels to the ones that were actually summarized + that we can access for summarized result
         self.summarized_ranks = [
             x for x in self.summarized_ranks if x in self.sum_uniq_bp.keys()
@@ -6,6 +6,7 @@ import shutil
 import os
 import glob
 import gzip
+import zipfile
 
 import pytest
 import screed
@@ -1394,6 +1395,27 @@ def test_sig_cat_6_pattern_exclude_no_manifest(runtmp):
     assert "require a manifest" in str(e)
 
 
+def test_sig_cat_7_zip_copies_members(runtmp):
+    # zip to zip 'cat' copies gzipped members verbatim, without decoding
+    db = utils.get_test_data("track_abund/track_abund.zip")
+    outzip = runtmp.output("out.zip")
+    runtmp.sourmash("sig", "cat", db, "-o", outzip)
+
+    in_idx = sourmash.load_file_as_index(db)
+    out_idx = sourmash.load_file_as_index(outzip)
+    in_rows = {row["md5"]: row for row in in_idx.manifest.rows}
+    out_rows = {row["md5"]: row for row in out_idx.manifest.rows}
+    assert set(in_rows) == set(out_rows)
+
+    with zipfile.ZipFile(db) as zin, zipfile.ZipFile(outzip) as zout:
+        for md5, row in in_rows.items():
+            orig = zin.read(row["internal_location"])
+            copied = zout.read(out_rows[md5]["internal_location"])
+            assert orig == copied
+
+    assert set(ss.md5sum() for ss in out_idx.signatures()) == set(in_rows)
+
+
 def test_sig_split_1(runtmp):
     c = runtmp
     # split 47 into 1 sig :)
@@ -3058,6 +3080,31 @@ def test_sig_flatten_1_select_md5(runtmp):
     assert test_flattened.minhash == siglist[0].minhash
 
 
+def test_sig_flatten_zip_to_zip(runtmp):
+    # zip to zip flattening goes through the Rust core; check it matches.
+    sig47 = utils.get_test_data("track_abund/47.fa.sig")
+    sig63 = utils.get_test_data("track_abund/63.fa.sig")
+    inzip = runtmp.output("in.zip")
+    outzip = runtmp.output("out.zip")
+    runtmp.sourmash("sig", "cat", sig47, sig63, "-o", inzip)
+    runtmp.sourmash("sig", "flatten", inzip, "-o", outzip, "--name", "Shewanella")
+
+    expected = {}
+    for ss in sourmash.load_file_as_signatures(inzip):
+        if "Shewanella" in ss.name:
+            expected[ss.md5sum()] = ss.minhash.flatten()
+    assert expected
+
+    idx = sourmash.load_file_as_index(outzip)
+    assert len(idx) == len(expected)
+    for row in idx.manifest.rows:
+        assert not row["with_abundance"]
+
+    for ss in idx.signatures():
+        assert not ss.minhash.track_abundance
+        assert ss.minhash == expected[ss.md5sum()]
+
+
 def test_sig_flatten_2_ksize(runtmp):
     c = runtmp
     # flatten only one signature selected using ksize
@@ -3103,6 +3150,29 @@ def test_sig_downsample_1_scaled_downsample_multisig(c):
         assert sig.minhash.scaled == 10000
 
 
+def test_sig_downsample_zip_to_zip(runtmp):
+    # zip to zip downsampling goes through the Rust core; check it matches.
+    allzip = utils.get_test_data("prot/all.zip")
+    outzip = runtmp.output("out.zip")
+    runtmp.sourmash("sig", "downsample", "--scaled", "200", allzip, "-o", outzip)
+
+    expected = {}
+    for ss in sourmash.load_file_as_signatures(allzip):
+        mh = ss.minhash.downsample(scaled=200)
+        expected[mh.md5sum()] = (ss.name, mh)
+
+    idx = sourmash.load_file_as_index(outzip)
+    assert len(idx) == len(expected)
+    for row in idx.manifest.rows:
+        assert row["scaled"] == 200
+        assert row["md5"] in expected
+
+    for ss in idx.signatures():
+        name, mh = expected[ss.md5sum()]
+        assert ss.name == name
+        assert ss.minhash == mh
+
+
 @utils.in_tempdir
 def test_sig_downsample_1_scaled_to_num(c):
     # downsample a scaled signature
@@ -9,6 +9,7 @@ from sourmash.compare import (
     compare_all_pairs,
     compare_parallel,
     compare_serial,
+    compare_threaded,
     compare_serial_containment,
     compare_serial_max_containment,
     compare_serial_avg_containment,
@@ -91,6 +92,24 @@ def test_compare_all_pairs(siglist, ignore_abundance):
     np.testing.assert_array_equal(similarities_parallel, similarities_serial)
 
 
+def test_compare_threaded(siglist, ignore_abundance):
+    similarities_threaded = compare_threaded(
+        siglist, ignore_abundance, downsample=False, n_threads=3
+    )
+    similarities_serial = compare_serial(siglist, ignore_abundance, downsample=False)
+    np.testing.assert_array_equal(similarities_threaded, similarities_serial)
+
+
+def test_compare_all_pairs_threads(scaled_siglist, ignore_abundance):
+    similarities_threaded = compare_all_pairs(
+        scaled_siglist, ignore_abundance, return_ani=True, n_threads=2
+    )
+    similarities_serial = compare_serial(
+        scaled_siglist, ignore_abundance, downsample=False, return_ani=True
+    )
+    np.testing.assert_array_equal(similarities_threaded, similarities_serial)
+
+
 def test_compare_serial_jaccardANI(scaled_siglist, ignore_abundance):
     jANI = compare_serial(
         scaled_siglist, ignore_abundance, downsample=False, return_ani=True
@@ -0,0 +1,81 @@
+from tempfile import NamedTemporaryFile
+
+import pytest
+
+from sourmash import MinHash
+from sourmash.countgraph import Countgraph
+
+
+def test_countgraph_count_and_get():
+    cg = Countgraph(3, 23, 6)
+    assert cg.hashsizes() == [19, 17, 13, 11, 7, 5]
+
+    assert cg.count("ACG")
+    assert not cg.count("ACG")
+    cg.count("TTA")
+
+    assert cg.get("ACG") == 2
+    assert cg.get("TTA") == 1
+    assert cg.get("CGA") == 0
+
+    # counters saturate at 255
+    cg.count(12345, abundance=1000)
+    assert cg.get(12345) == 255
+
+
+def test_countgraph_save_load():
+    cg = Countgraph(3, 23, 6)
+    cg.count("ACG")
+    cg.count("TTA")
+    cg.count("TTA")
+
+    with NamedTemporaryFile() as f:
+        cg.save(f.name)
+        new_cg = Countgraph.load(f.name)
+
+    assert new_cg.ksize() == 3
+    assert new_cg.hashsizes() == cg.hashsizes()
+    assert new_cg.get("ACG") == 1
+    assert new_cg.get("TTA") == 2
+
+    new_cg = Countgraph.from_buffer(cg.to_bytes())
+    assert new_cg.get("TTA") == 2
+
+
+def test_countgraph_matches_weighted():
+    mh = MinHash(0, 21, scaled=1, track_abundance=True)
+    mh.set_abundances({1: 5, 2: 1, 3: 2})
+
+    cg = Countgraph(21, 1e4, 4)
+    cg.update(mh)
+    assert cg.get(1) == 5
+
+    query = MinHash(0, 21, scaled=1, track_abundance=True)
+    query.set_abundances({1: 2, 2: 3, 4: 1})
+    assert cg.matches(query) == 2
+    assert cg.matches_weighted(query) == 2 + 1
+
+    # merged countgraphs keep the largest counts: an upper bound for both
+    other = Countgraph(21, 1e4, 4)
+    other.count(2, abundance=4)
+    other.update(cg)
+    assert other.matches_weighted(query) == 2 + 3
+
+    flat = query.flatten()
+    assert cg.matches_weighted(flat) == cg.matches(flat) == 2
+
+
+def test_countgraph_khmer_compare():
+    khmer = pytest.importorskip("khmer")
+
+    khmer_cg = khmer.Countgraph(3, 23, 6)
+    sm_cg = Countgraph(3, 23, 6)
+    for kmer in ["ACG", "TTA", "CGA", "ACG"]:
+        khmer_cg.count(kmer)
+        sm_cg.count(kmer)
+
+    assert sm_cg.hashsizes() == khmer_cg.hashsizes()
+
+    khmer_sm_cg = sm_cg.to_khmer_countgraph()
+    for kmer in ["ACG", "TTA", "CGA", "AAA"]:
+        assert khmer_sm_cg.get(kmer) == khmer_cg.get(kmer) == sm_cg.get(kmer)
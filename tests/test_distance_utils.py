@@ -5,6 +5,7 @@ import pytest
 import numpy as np
 from sourmash.distance_utils import (
     containment_to_distance,
+    containment_to_distance_many,
     get_exp_probability_nothing_common,
     handle_seqlen_nkmers,
     jaccard_to_distance,
@@ -431,6 +432,44 @@ def test_containment_to_distance_tinytestdata_var0():
     assert res.p_exceeds_threshold == False
 
 
+def test_containment_to_distance_many():
+    # batched estimates match one-at-a-time estimates
+    containments = [0, 1, 0.5, 0.1, 0.5, 0.9]
+    ksizes = [21, 21, 21, 31, 21, 31]
+    scaled = [10, 10, 1, 100, 100, 1]
+    nkmers = [100, 100, 10000, 10000, 10000, 4]
+
+    results = containment_to_distance_many(
+        containments, ksizes, scaled, n_unique_kmers=nkmers, estimate_ci=True
+    )
+    assert len(results) == len(containments)
+
+    for res, args in zip(results, zip(containments, ksizes, scaled, nkmers)):
+        contain, ksize, sc, n = args
+        expected = containment_to_distance(
+            contain, ksize, sc, n_unique_kmers=n, estimate_ci=True
+        )
+        assert res.dist == pytest.approx(expected.dist)
+        assert res.p_nothing_in_common == pytest.approx(expected.p_nothing_in_common)
+        assert res.p_exceeds_threshold == expected.p_exceeds_threshold
+        if expected.dist_low is None:
+            # tiny test data: no CI
+            assert res.dist_low is None and res.dist_high is None
+        else:
+            assert res.dist_low == pytest.approx(expected.dist_low, abs=1e-6)
+            assert res.dist_high == pytest.approx(expected.dist_high, abs=1e-6)
+
+
+def test_containment_to_distance_many_scalar_params():
+    results = containment_to_distance_many(
+        np.array([0.1, 0.5]), 21, 100, n_unique_kmers=10000
+    )
+    assert [res.dist_low for res in results] == [None, None]
+    assert results[1].ani == pytest.approx(0.9675317785238916)
+
+    assert containment_to_distance_many([], 21, 100, n_unique_kmers=[]) == []
+
+
 def test_var_n_mutated():
     # check 0
     r = 0
@@ -4,6 +4,8 @@ from tempfile import NamedTemporaryFile
 from screed.fasta import fasta_iter
 import pytest
 
+from sourmash import MinHash
+from sourmash.exceptions import SourmashError
 from sourmash.hll import HLL
 
 import sourmash_tst_utils as utils
@@ -129,3 +131,35 @@ def test_hll_save_load():
         new_hll = HLL.load(f.name)
 
     assert len(hll) == len(new_hll)
+
+
+def test_hll_seed_and_moltype():
+    sequence = "MVKVYAPASSANMSVGFDVLGAAVTPVDGALLGDVVTVEAAETFSLNNLGRFADKLPSEPRENIVYQCWER"
+
+    hll = HLL(ERR_RATE, 10, is_protein=True, seed=7)
+    assert hll.ksize == 10
+    assert hll.seed == 7
+    assert hll.moltype == "protein"
+    hll.add_protein(sequence)
+
+    mh = MinHash(0, 10, is_protein=True, seed=7, scaled=1)
+    mh.add_protein(sequence)
+
+    from_mh = HLL(ERR_RATE, 10, is_protein=True, seed=7)
+    from_mh.update(mh)
+    assert len(hll) == len(from_mh)
+    assert abs(1 - float(len(hll)) / len(mh)) < ERR_RATE
+
+    with pytest.raises(SourmashError):
+        HLL(ERR_RATE, 10, is_protein=True).update(mh)
+    with pytest.raises(SourmashError):
+        HLL(ERR_RATE, 10, seed=7).update(hll)
+
+    with NamedTemporaryFile() as f:
+        hll.save(f.name)
+        new_hll = HLL.load(f.name)
+
+    assert new_hll.seed == 7
+    assert new_hll.moltype == "protein"
+    assert new_hll.ksize == 10
+    assert len(new_hll) == len(hll)
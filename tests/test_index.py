@@ -831,6 +831,57 @@ def test_zipfile_API_signatures(use_manifest):
         assert len(zipidx) == 7
 
 
+def test_zipfile_API_signatures_native():
+    # with a manifest, signatures are loaded by the Rust core in row order
+    zipfile_db = utils.get_test_data("prot/all.zip")
+
+    zipidx = ZipFileLinearIndex.load(zipfile_db)
+    assert zipidx.supports_transform
+
+    md5s = [ss.md5sum() for ss in zipidx.signatures()]
+    assert md5s == [row["md5"] for row in zipidx.manifest.rows]
+
+    # same signatures as the pure Python path
+    pyidx = ZipFileLinearIndex.load(
+        zipfile_db, traverse_yield_all=True, use_manifest=False
+    )
+    pyidx = pyidx.select(moltype="DNA")
+    dna_md5s = [ss.md5sum() for ss in zipidx.select(moltype="DNA").signatures()]
+    assert sorted(dna_md5s) == sorted(ss.md5sum() for ss in pyidx.signatures())
+
+    # stopping early is fine
+    siglist = zipidx.signatures()
+    assert next(siglist)
+    siglist.close()
+
+
+def test_zipfile_API_signatures_native_missing_md5():
+    # manifest rows whose md5 is not in their zip member are skipped, as
+    # with the pure Python loop.
+    from io import StringIO
+    from sourmash.manifest import ColumnarCollectionManifest
+
+    zipfile_db = utils.get_test_data("prot/all.zip")
+    zipidx = ZipFileLinearIndex.load(zipfile_db)
+
+    rows = [dict(row) for row in zipidx.manifest.rows]
+    missing_md5 = rows[0]["md5"]
+    rows[0]["md5"] = "0" * 32
+
+    fp = StringIO()
+    CollectionManifest(rows).write_to_csv(fp, write_header=True)
+    manifest = CollectionManifest.load_from_csv(StringIO(fp.getvalue()))
+    assert isinstance(manifest, ColumnarCollectionManifest)
+
+    idx = ZipFileLinearIndex(zipidx.storage, manifest=manifest)
+    assert idx.supports_transform
+
+    md5s = [ss.md5sum() for ss in idx.signatures()]
+    expected = [row["md5"] for row in zipidx.manifest.rows]
+    expected.remove(missing_md5)
+    assert md5s == expected
+
+
 def test_zipfile_bool():
     # make sure that zipfile __bool__ doesn't traverse all the signatures
     # by relying on __len__!
@@ -6,6 +6,7 @@ from io import StringIO
 
 import sourmash
 from sourmash import index, sourmash_args
+from sourmash.manifest import ColumnarCollectionManifest
 
 import sourmash_tst_utils as utils
 
@@ -185,6 +186,80 @@ def test_save_load_manifest():
     assert short_mf != manifest
 
 
+def test_load_manifest_columnar_select():
+    # CSV manifests are loaded column-wise; check selection matches the
+    # row-based manifest.
+    all_zip = utils.get_test_data("prot/all.zip")
+
+    loader = sourmash.load_file_as_index(all_zip)
+    rows = [
+        index.CollectionManifest.make_manifest_row(sig, loc)
+        for sig, loc in loader._signatures_with_internal()
+    ]
+    manifest = index.CollectionManifest(rows)
+
+    fp = StringIO()
+    manifest.write_csv_header(fp)
+    manifest.write_to_csv(fp)
+
+    manifest2 = index.CollectionManifest.load_from_csv(StringIO(fp.getvalue()))
+    assert isinstance(manifest2, ColumnarCollectionManifest)
+    assert len(manifest2) == len(manifest)
+    assert manifest2 == manifest
+
+    for kwargs in (
+        dict(ksize=19),
+        dict(ksize=19, moltype="protein"),
+        dict(moltype="DNA"),
+        dict(moltype="skipm1n3"),
+        dict(scaled=100),
+        dict(abund=True),
+        dict(num=500),
+    ):
+        sub = manifest.select_to_manifest(**kwargs)
+        sub2 = manifest2.select_to_manifest(**kwargs)
+        assert len(sub) == len(sub2), kwargs
+        assert sub == sub2, kwargs
+
+    # chained selection
+    sub = manifest2.select_to_manifest(ksize=19)
+    sub = sub.select_to_manifest(moltype="protein")
+    assert len(sub) == 2
+    for ss in loader.signatures():
+        if ss.minhash.ksize == 19 and ss.minhash.moltype == "protein":
+            assert ss in sub
+        else:
+            assert ss not in sub
+
+    with pytest.raises(ValueError):
+        manifest2.select_to_manifest(containment=True)
+
+
+def test_load_manifest_extra_columns():
+    # manifests with columns outside the standard set are loaded row-wise,
+    # so the extra columns are kept.
+    protzip = utils.get_test_data("prot/protein.zip")
+    loader = sourmash.load_file_as_index(protzip)
+
+    fp = StringIO()
+    loader.manifest.write_to_csv(fp, write_header=True)
+    lines = fp.getvalue().splitlines()
+    assert lines[0].startswith("# SOURMASH-MANIFEST-VERSION")
+    lines[1] += ",extra"
+    lines[2:] = [line + f",value{i}" for i, line in enumerate(lines[2:])]
+
+    manifest = index.CollectionManifest.load_from_csv(StringIO("\n".join(lines)))
+    assert not isinstance(manifest, ColumnarCollectionManifest)
+    assert len(manifest) == len(loader.manifest)
+    assert manifest == loader.manifest
+
+    extras = [row["extra"] for row in manifest.rows]
+    assert extras == [f"value{i}" for i in range(len(lines) - 2)]
+    for row in manifest.rows:
+        assert isinstance(row["ksize"], int)
+        assert isinstance(row["with_abundance"], bool)
+
+
 def test_manifest_to_picklist_bug(runtmp):
     # this tests a fun combination of things that led to a bug.
     # tl;dr we only want to iterate once across a generator...
@@ -35,6 +35,7 @@
 
 import itertools
 import pickle
+import random
 import math
 import numpy as np
 
@@ -50,8 +51,10 @@ from sourmash.minhash import (
     _get_scaled_for_max_hash,
     _get_max_hash_for_scaled,
     translate_codon,
+    similarity_tile,
 )
 from sourmash import signature
+from sourmash.exceptions import SourmashError
 
 import sourmash_tst_utils as utils
 
@@ -2540,6 +2543,177 @@ def test_frozen_and_mutable_3(track_abundance):
     assert 12 not in mh1.hashes
 
 
+def test_hashes_array(track_abundance):
+    # hashes_array/abunds_array match hashes, as NumPy arrays
+    mh = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
+    for i, h in enumerate([30, 10, 2**64 - 1, 20]):
+        for _ in range(i + 1):
+            mh.add_hash(h)
+
+    arr = mh.hashes_array
+    assert arr.dtype == np.uint64
+    assert arr.tolist() == sorted(mh.hashes)
+    if track_abundance:
+        assert mh.abunds_array.tolist() == [mh.hashes[h] for h in arr.tolist()]
+    else:
+        assert mh.abunds_array is None
+
+    # arrays from mutable MinHashes are copies
+    arr[0] = 0
+    mh.add_hash(5)
+    assert mh.hashes_array.tolist() == [5, 10, 20, 30, 2**64 - 1]
+
+
+def test_hashes_array_frozen(track_abundance):
+    # FrozenMinHash arrays are read-only views that keep the sketch alive
+    mh = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
+    mh.add_many([30, 10, 20])
+    mh = mh.to_frozen()
+
+    arr = mh.hashes_array
+    abunds = mh.abunds_array
+    del mh
+
+    assert arr.tolist() == [10, 20, 30]
+    with pytest.raises(ValueError):
+        arr[0] = 0
+    if track_abundance:
+        assert abunds.tolist() == [1, 1, 1]
+    else:
+        assert abunds is None
+
+
+def test_add_many_numpy(track_abundance):
+    # NumPy arrays go straight to the Rust core, sorted or not
+    hashes = [30, 10, 2**64 - 1, 20, 10]
+    mh1 = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
+    mh2 = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
+    mh3 = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
+
+    mh1.add_many(hashes)
+    mh2.add_many(np.array(hashes, dtype=np.uint64))
+    mh3.add_many(np.sort(np.array(hashes, dtype=np.uint64)))
+    assert mh1.hashes == mh2.hashes
+    assert mh1.hashes == mh3.hashes
+
+    mh1.remove_many([10, 30])
+    mh2.remove_many(np.array([30, 10], dtype=np.uint64))
+    assert mh1.hashes == mh2.hashes
+    assert list(mh2.hashes) == [20, 2**64 - 1]
+
+    with pytest.raises(TypeError):
+        mh2.add_many(np.array([1.5]))
+
+
+def test_add_many_numpy_num():
+    # bulk adds into num sketches keep the smallest hashes
+    mh = MinHash(5, 21)
+    mh.add_many(np.arange(100, 0, -1, dtype=np.uint64))
+    assert list(mh.hashes) == [1, 2, 3, 4, 5]
+
+    mh.add_many(np.array([0, 50], dtype=np.uint64))
+    assert list(mh.hashes) == [0, 1, 2, 3, 4]
+
+
+def test_set_abundances_numpy():
+    # set_abundances takes a (hashes, abunds) pair of arrays
+    mh1 = MinHash(0, 21, scaled=1, track_abundance=True)
+    mh2 = MinHash(0, 21, scaled=1, track_abundance=True)
+    values = {30: 3, 10: 1, 20: 2}
+
+    mh1.set_abundances(values)
+    mh2.set_abundances(
+        (np.array(list(values.keys())), np.array(list(values.values())))
+    )
+    assert mh1.hashes == mh2.hashes
+
+    # without clearing, abundances add up; zero removes the hash
+    mh2.set_abundances((np.array([10, 30]), np.array([4, 0])), clear=False)
+    assert dict(mh2.hashes) == {10: 5, 20: 2}
+
+    with pytest.raises(ValueError):
+        mh2.set_abundances((np.array([10]), np.array([-1])))
+
+
+def test_batch_comparisons(track_abundance):
+    # one-vs-many and tile comparisons match pairwise comparisons
+    mhs = []
+    for i in range(1, 6):
+        mh = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
+        mh.add_many(range(0, 200, i))
+        mhs.append(mh)
+    query = mhs[1]
+
+    counts = query.count_common_many(mhs)
+    assert counts.dtype == np.uint64
+    assert list(counts) == [query.count_common(mh) for mh in mhs]
+
+    sims = query.similarity_many(mhs, ignore_abundance=True)
+    assert list(sims) == [query.similarity(mh, ignore_abundance=True) for mh in mhs]
+
+    tile = similarity_tile(mhs[:2], mhs)
+    assert tile.shape == (2, 5)
+    for i, row in enumerate(mhs[:2]):
+        assert list(tile[i]) == [row.similarity(mh) for mh in mhs]
+
+    assert len(query.similarity_many([])) == 0
+    assert similarity_tile([], mhs).shape == (0, 5)
+
+
+def test_batch_comparisons_fail():
+    mh1 = MinHash(0, 21, scaled=1)
+    mh2 = MinHash(0, 31, scaled=1)
+
+    with pytest.raises(TypeError):
+        mh1.count_common_many([mh1, "foo"])
+
+    with pytest.raises(SourmashError) as exc:
+        mh1.similarity_many([mh1, mh2])
+    assert "different ksizes cannot be compared" in str(exc)
+
+
+def test_comparison_stats():
+    # fused stats match the separate comparisons
+    mh1 = MinHash(0, 21, scaled=1, track_abundance=True)
+    mh2 = MinHash(0, 21, scaled=1, track_abundance=True)
+    mh1.set_abundances({1: 1, 2: 2, 3: 3, 4: 6})
+    mh2.set_abundances({2: 5, 3: 1, 4: 1, 5: 2, 6: 1})
+
+    stats = mh1.comparison_stats(mh2)
+    common, union_size = mh1.intersection_and_union_size(mh2)
+    assert stats.common == common == 3
+    assert stats.union_size == union_size == 6
+    assert (stats.self_size, stats.other_size) == (4, 5)
+    assert stats.self_total_abund == 12
+    assert stats.other_total_abund == 10
+    assert stats.self_common_abund == 11
+    assert stats.other_common_abund == 7
+    assert stats.mean_abund == np.mean([2, 3, 6])
+    assert stats.median_abund == 3
+    assert round(stats.std_abund, 6) == round(np.std([2, 3, 6]), 6)
+    assert (stats.ksize, stats.scaled) == (21, 1)
+
+    # abundances are counted as 1 without abundance tracking
+    stats = mh1.flatten().comparison_stats(mh2)
+    assert stats.self_common_abund == 3
+    assert stats.mean_abund == stats.median_abund == 1
+
+
+def test_comparison_stats_downsample():
+    mh1 = MinHash(0, 21, scaled=1)
+    mh2 = MinHash(0, 21, scaled=100)
+    mh1.add_many(range(0, 2**64 - 1, 2**52))
+    mh2.add_many(range(0, 2**64 - 1, 2**53))
+
+    with pytest.raises(SourmashError):
+        mh1.comparison_stats(mh2)
+
+    stats = mh1.comparison_stats(mh2, downsample=True)
+    assert stats.scaled == 100
+    assert stats.common == mh1.count_common(mh2, downsample=True)
+    assert stats.self_size == len(mh1.downsample(scaled=100))
+
+
 def test_dna_kmers():
     # test seq_to_hashes for dna -> dna
     mh = MinHash(0, ksize=31, scaled=1)  # DNA
@@ -2900,6 +3074,28 @@ def test_sum_abundances(track_abundance):
         assert mh2.sum_abundances is None
 
 
+def test_inflated_sum_abundances():
+    "test inflated_sum_abundances"
+    mh1 = MinHash(0, 21, scaled=1)
+    mh2 = MinHash(0, 21, scaled=1, track_abundance=True)
+
+    mh1.add_many((1, 2, 5))
+    mh2.set_abundances({1: 3, 2: 4, 3: 10})
+
+    # hash 5 is not in mh2, and is ignored
+    assert mh1.inflated_sum_abundances(mh2) == 7
+    assert mh2.inflated_sum_abundances(mh2) == 17
+
+
+def test_inflated_sum_abundances_error():
+    "inflated_sum_abundances needs abundances in the other MinHash"
+    mh1 = MinHash(0, 21, scaled=1)
+    mh1.add_many((1, 2, 5))
+
+    with pytest.raises(ValueError):
+        mh1.inflated_sum_abundances(mh1)
+
+
 def test_mean_abundance(track_abundance):
     "test mean_abundance"
     mh1 = MinHash(0, 21, scaled=1, track_abundance=track_abundance)
@@ -2972,6 +3168,117 @@ def test_unique_dataset_hashes(track_abundance):
     assert "can only approximate unique_dataset_hashes for scaled MinHashes" in str(exc)
 
 
+def test_unique_dataset_hashes_hll(track_abundance):
+    "with track_hll, dataset size comes from the companion HLL"
+    mh = MinHash(0, 21, scaled=1000, track_abundance=track_abundance)
+    mh.track_hll = True
+    assert mh.track_hll
+
+    hashes = [(i * 0x9E3779B97F4A7C15) % 2**64 for i in range(20000)]
+    mh.add_many(hashes)
+
+    # every hash is counted, not only the ~20 kept at scaled=1000
+    hll = mh.hll
+    assert hll.relative_error < 0.01
+    assert abs(mh.unique_dataset_hashes - 20000) / 20000 < 0.05
+    assert mh.size_is_accurate()
+    assert not mh.size_is_accurate(relative_error=0.001)
+
+    # kept by copies, pickling, downsampling and flattening
+    assert mh.copy().unique_dataset_hashes == mh.unique_dataset_hashes
+    assert mh.downsample(scaled=2000).unique_dataset_hashes == hll.cardinality()
+    assert mh.flatten().unique_dataset_hashes == hll.cardinality()
+    unpickled = pickle.loads(pickle.dumps(mh))
+    assert unpickled.track_hll
+    assert unpickled.unique_dataset_hashes == hll.cardinality()
+    assert unpickled == mh
+
+    # copy_and_clear is used to build sketches of subsets of the hashes
+    assert not mh.copy_and_clear().track_hll
+
+    mh.track_hll = False
+    assert mh.hll is None
+    assert mh.unique_dataset_hashes == len(mh) * 1000
+
+    # only an empty sketch can start collecting an HLL
+    with pytest.raises(RuntimeError):
+        mh.track_hll = True
+
+
+def test_frozen_track_hll():
+    "a FrozenMinHash can't start or stop collecting an HLL"
+    mh = MinHash(0, 21, scaled=1000)
+    mh.track_hll = True
+    mh.add_many([(i * 0x9E3779B97F4A7C15) % 2**64 for i in range(2000)])
+
+    frozen = mh.to_frozen()
+    with pytest.raises(TypeError, match="FrozenMinHash does not support"):
+        frozen.track_hll = False
+    assert frozen.track_hll
+    with pytest.raises(TypeError, match="FrozenMinHash does not support"):
+        frozen.track_hll = True
+
+
+def test_hll_dropped_on_removal():
+    "the companion HLL can't follow removals or intersections, so it's dropped"
+    hashes = [(i * 0x9E3779B97F4A7C15) % 2**64 for i in range(1, 20001)]
+    mh = MinHash(0, 21, scaled=100)
+    mh.track_hll = True
+    mh.add_many(hashes)
+    assert mh.unique_dataset_hashes != len(mh) * 100
+
+    other = mh.copy_and_clear()
+    other.add_many(hashes[:10000])
+    assert not (mh & other).track_hll
+
+    remaining = mh.copy()
+    remaining.remove_many([])
+    assert remaining.track_hll
+
+    remaining.remove_many(other)
+    assert not remaining.track_hll
+    assert remaining.unique_dataset_hashes == len(remaining) * 100
+
+    remaining = mh.copy()
+    remaining.remove_many(np.array(hashes[:10000], dtype=np.uint64))
+    assert not remaining.track_hll
+
+    abund_mh = MinHash(0, 21, scaled=100, track_abundance=True)
+    abund_mh.track_hll = True
+    abund_mh.add_many(hashes)
+    abund_mh.set_abundances({min(abund_mh.hashes): 0}, clear=False)
+    assert not abund_mh.track_hll
+
+
+def test_size_is_accurate_hll_empty():
+    "without data, the HLL error isn't used; the sketch-based check is"
+    mh = MinHash(0, 21, scaled=1000)
+    expected = mh.size_is_accurate(relative_error=0.001)
+
+    mh.track_hll = True
+    assert mh.size_is_accurate(relative_error=0.001) == expected
+
+
+def test_sketch_with_hll():
+    "signatures sketched with the 'hll' param save and load the HLL"
+    from sourmash.command_compute import ComputeParameters
+
+    params = ComputeParameters(ksizes=[21], scaled=1000, hll=True)
+    sig = signature.SourmashSignature.from_params(params)
+    rng = random.Random(42)
+    seq = "".join(rng.choice("ACGT") for _ in range(5000))
+    sig.add_sequence(seq)
+
+    mh = sig.minhash
+    assert mh.track_hll
+    n_kmers = len({seq[i : i + 21] for i in range(len(seq) - 20)})
+    assert abs(mh.unique_dataset_hashes - n_kmers) / n_kmers < 0.05
+
+    loaded = signature.load_one_signature(signature.save_signatures([sig]))
+    assert loaded.minhash.track_hll
+    assert loaded.minhash.unique_dataset_hashes == mh.unique_dataset_hashes
+
+
 def test_containment_ANI():
     f1 = utils.get_test_data("2.fa.sig")
     f2 = utils.get_test_data("2+63.fa.sig")
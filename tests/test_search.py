@@ -466,7 +466,7 @@ def test_GatherResult():
     intersect_bp = len(intersect_mh) * scaled
     max_containment = ss4763.max_containment(ss47)
     ss47.contained_by(ss4763)
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
     queryc_ani = ss47.containment_ani(ss4763)
     matchc_ani = ss4763.containment_ani(ss47)
 
@@ -482,7 +482,7 @@ def test_GatherResult():
         gather_result_rank=gather_result_rank,
         total_weighted_hashes=sum_abunds,
         orig_query_len=len(ss47.minhash),
-        orig_query_abunds=orig_query_abunds,
+        orig_query_abund_mh=orig_query_abund_mh,
     )
 
     assert res.query_name == ss47.name
@@ -544,7 +544,7 @@ def test_GatherResult_ci():
     remaining_mh = ss4763.minhash.to_mutable()
     remaining_mh.remove_many(intersect_mh)
 
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
     queryc_ani = ss47.containment_ani(ss4763, estimate_ci=True)
     matchc_ani = ss4763.containment_ani(ss47, estimate_ci=True)
 
@@ -560,7 +560,7 @@ def test_GatherResult_ci():
         gather_result_rank=gather_result_rank,
         total_weighted_hashes=sum_abunds,
         orig_query_len=len(ss47.minhash),
-        orig_query_abunds=orig_query_abunds,
+        orig_query_abund_mh=orig_query_abund_mh,
         estimate_ani_ci=True,
     )
 
@@ -573,10 +573,17 @@ def test_GatherResult_ci():
     print(queryc_ani.ani)
     print(matchc_ani.ani)
     assert res.match_containment_ani == matchc_ani.ani
-    assert res.match_containment_ani_low == matchc_ani.ani_low
-    assert res.match_containment_ani_high == matchc_ani.ani_high
     assert res.max_containment_ani == max(queryc_ani.ani, matchc_ani.ani)
     assert res.average_containment_ani == np.mean([queryc_ani.ani, matchc_ani.ani])
+
+    # gather finds confidence interval roots in the Rust core; check them
+    # against the bounds from the original scipy implementation.
+    assert res.query_containment_ani_low == 1.0
+    assert res.query_containment_ani_high == 1.0
+    assert res.match_containment_ani_low == pytest.approx(0.9859926143594806, abs=1e-9)
+    assert res.match_containment_ani_high == pytest.approx(
+        0.9870227790193753, abs=1e-9
+    )
     assert res.potential_false_negative == False
 
     # get write dict version of GatherResult
@@ -590,7 +597,7 @@ def test_GatherResult_incompatible_sigs():
     ss4763_file = utils.get_test_data("47+63.fa.sig")
     ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
     ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
 
     with pytest.raises(TypeError) as exc:
         GatherResult(
@@ -601,7 +608,7 @@ def test_GatherResult_incompatible_sigs():
             gather_result_rank=1,
             total_weighted_hashes=1,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert (
@@ -615,7 +622,7 @@ def test_GatherResult_incomplete_input_cmpscaled():
     ss4763_file = utils.get_test_data("47+63.fa.sig")
     ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
     ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
 
     with pytest.raises(ValueError) as exc:
         GatherResult(
@@ -626,7 +633,7 @@ def test_GatherResult_incomplete_input_cmpscaled():
             gather_result_rank=1,
             total_weighted_hashes=1,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert (
@@ -635,12 +642,45 @@ def test_GatherResult_incomplete_input_cmpscaled():
     )
 
 
+def test_gather_remaining_bp_with_hll():
+    "remaining_bp follows the remaining query hashes in every round"
+    hashes = [(i * 0x9E3779B97F4A7C15) % 2**64 for i in range(1, 30001)]
+    query_mh = MinHash(0, 31, scaled=100)
+    query_mh.track_hll = True
+    query_mh.add_many(hashes)
+    # the HLL estimate of the full query differs from len * scaled
+    assert query_mh.unique_dataset_hashes != len(query_mh) * 100
+    query = SourmashSignature(query_mh, name="query")
+
+    match1_mh = MinHash(0, 31, scaled=100)
+    match1_mh.add_many(hashes[:15000])
+    match2_mh = MinHash(0, 31, scaled=100)
+    match2_mh.add_many(hashes[15000:25000])
+    db = LinearIndex(
+        [
+            SourmashSignature(match1_mh, name="match1"),
+            SourmashSignature(match2_mh, name="match2"),
+        ]
+    )
+
+    counter = db.counter_gather(query, 0)
+    results = list(search.GatherDatabases(query, [counter]))
+    assert [r.match.name for r in results] == ["match1", "match2"]
+
+    remaining = set(query_mh.hashes)
+    for result in results:
+        remaining -= set(result.match.minhash.hashes)
+        assert result.remaining_bp == len(remaining) * 100
+        # the query size comes from the companion HLL
+        assert result.query_bp == query_mh.unique_dataset_hashes
+
+
 def test_GatherResult_incomplete_input_gathermh():
     ss47_file = utils.get_test_data("47.fa.sig")
     ss4763_file = utils.get_test_data("47+63.fa.sig")
     ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
     ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
 
     with pytest.raises(ValueError) as exc:
         GatherResult(
@@ -651,7 +691,7 @@ def test_GatherResult_incomplete_input_gathermh():
             gather_result_rank=1,
             total_weighted_hashes=1,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert (
@@ -665,7 +705,7 @@ def test_GatherResult_incomplete_input_gather_result_rank():
     ss4763_file = utils.get_test_data("47+63.fa.sig")
     ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
     ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
 
     with pytest.raises(ValueError) as exc:
         GatherResult(
@@ -676,7 +716,7 @@ def test_GatherResult_incomplete_input_gather_result_rank():
             gather_result_rank=None,
             total_weighted_hashes=1,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert "Error: must provide 'gather_result_rank' to GatherResult" in str(exc)
@@ -687,7 +727,7 @@ def test_GatherResult_incomplete_input_total_weighted_hashes():
     ss4763_file = utils.get_test_data("47+63.fa.sig")
     ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
     ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
-    orig_query_abunds = ss47.minhash.hashes
+    orig_query_abund_mh = ss47.minhash
 
     with pytest.raises(ValueError) as exc:
         GatherResult(
@@ -698,7 +738,7 @@ def test_GatherResult_incomplete_input_total_weighted_hashes():
             gather_result_rank=1,
             total_weighted_hashes=None,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert (
@@ -715,7 +755,7 @@ def test_GatherResult_incomplete_input_total_weighted_hashes():
             gather_result_rank=1,
             total_weighted_hashes=0,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert (
@@ -724,12 +764,12 @@ def test_GatherResult_incomplete_input_total_weighted_hashes():
     )
 
 
-def test_GatherResult_incomplete_input_orig_query_abunds():
+def test_GatherResult_incomplete_input_orig_query_abund_mh():
     ss47_file = utils.get_test_data("47.fa.sig")
     ss4763_file = utils.get_test_data("47+63.fa.sig")
     ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
     ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
-    orig_query_abunds = None
+    orig_query_abund_mh = None
 
     with pytest.raises(ValueError) as exc:
         GatherResult(
@@ -740,16 +780,15 @@ def test_GatherResult_incomplete_input_orig_query_abunds():
             gather_result_rank=1,
             total_weighted_hashes=1,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abund_mh=orig_query_abund_mh,
         )
     print(str(exc))
     assert (
-        "Error: must provide original query abundances ('orig_query_abunds') to GatherResult"
+        "Error: must provide original query sketch ('orig_query_abund_mh') to GatherResult"
         in str(exc)
     )
 
-    orig_query_abunds = {}
-
+    # the deprecated orig_query_abunds needs abundances, too
     with pytest.raises(ValueError) as exc:
         GatherResult(
             ss47,
@@ -759,10 +798,67 @@ def test_GatherResult_incomplete_input_orig_query_abunds():
             gather_result_rank=1,
             total_weighted_hashes=1,
             orig_query_len=len(ss47.minhash),
-            orig_query_abunds=orig_query_abunds,
+            orig_query_abunds={},
         )
     print(str(exc))
     assert (
-        "Error: must provide original query abundances ('orig_query_abunds') to GatherResult"
+        "Error: must provide original query sketch ('orig_query_abund_mh') to GatherResult"
         in str(exc)
     )
+
+
+def test_GatherResult_orig_query_abunds_deprecated():
+    # 'orig_query_abunds' still works, with a DeprecationWarning
+    ss47_file = utils.get_test_data("track_abund/47.fa.sig")
+    ss4763_file = utils.get_test_data("47+63.fa.sig")
+    ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
+    ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
+
+    intersect_mh = ss47.minhash.flatten().intersection(ss4763.minhash)
+    remaining_mh = ss4763.minhash.to_mutable()
+    remaining_mh.remove_many(intersect_mh)
+
+    kwargs = dict(
+        cmp_scaled=ss47.minhash.scaled,
+        gather_querymh=remaining_mh,
+        gather_result_rank=1,
+        total_weighted_hashes=1000,
+        orig_query_len=len(ss47.minhash),
+    )
+    res = GatherResult(ss47, ss4763, orig_query_abund_mh=ss47.minhash, **kwargs)
+    with pytest.warns(DeprecationWarning):
+        old_res = GatherResult(
+            ss47, ss4763, orig_query_abunds=ss47.minhash.hashes, **kwargs
+        )
+
+    assert old_res.query_abundance
+    assert old_res.average_abund == res.average_abund
+    assert old_res.median_abund == res.median_abund
+    assert old_res.std_abund == res.std_abund
+    assert old_res.f_unique_weighted == res.f_unique_weighted
+
+
+def test_GatherResult_flat_orig_query():
+    # a flat original query reports no abundance statistics
+    ss47_file = utils.get_test_data("47.fa.sig")
+    ss4763_file = utils.get_test_data("47+63.fa.sig")
+    ss47 = load_one_signature(ss47_file, ksize=31, select_moltype="dna")
+    ss4763 = load_one_signature(ss4763_file, ksize=31, select_moltype="dna")
+    assert not ss47.minhash.track_abundance
+
+    res = GatherResult(
+        ss47,
+        ss4763,
+        cmp_scaled=ss47.minhash.scaled,
+        gather_querymh=ss47.minhash,
+        gather_result_rank=1,
+        total_weighted_hashes=len(ss47.minhash),
+        orig_query_len=len(ss47.minhash),
+        orig_query_abund_mh=ss47.minhash,
+    )
+    assert not res.query_abundance
+    assert res.average_abund is None
+    assert res.median_abund is None
+    assert res.std_abund is None
+    assert res.f_unique_weighted == res.f_unique_to_query
+
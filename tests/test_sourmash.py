@@ -4375,6 +4375,40 @@ def test_gather_file_output(runtmp, linear_gather, prefetch_gather):
         assert "910,1.0,1.0" in output
 
 
+def test_gather_streaming_progress(runtmp, monkeypatch):
+    # report progress every round; CSV rows are streamed to the output file
+    from sourmash import commands
+
+    monkeypatch.setattr(commands, "GATHER_PROGRESS_INTERVAL", 0)
+
+    testdata_combined = utils.get_test_data("gather/combined.sig")
+    testdata_glob = utils.get_test_data("gather/GCF*.sig")
+    testdata_sigs = glob.glob(testdata_glob)
+
+    runtmp.sourmash(
+        "gather",
+        testdata_combined,
+        *testdata_sigs,
+        "-k",
+        "21",
+        "--threshold-bp=0",
+        "-o",
+        "out.csv",
+    )
+
+    print(runtmp.last_result.out)
+    print(runtmp.last_result.err)
+
+    assert "found 12 matches total" in runtmp.last_result.out
+    assert "...1 rounds so far" in runtmp.last_result.err
+    assert "...12 rounds so far" in runtmp.last_result.err
+    assert "of query left" in runtmp.last_result.err
+
+    with open(runtmp.output("out.csv"), newline="") as fp:
+        rows = list(csv.DictReader(fp))
+    assert len(rows) == 12
+
+
 def test_gather_f_match_orig(runtmp, linear_gather, prefetch_gather):
     import copy
 
@@ -4744,6 +4778,51 @@ def test_multigather_metagenome(runtmp):
     )
 
 
+def test_multigather_metagenome_parallel(runtmp):
+    # run several queries on multiple processes; output should match serial
+    testdata_glob = utils.get_test_data("gather/GCF*.sig")
+    testdata_sigs = sorted(glob.glob(testdata_glob))
+
+    query_sig = utils.get_test_data("gather/combined.sig")
+    queries = [query_sig] + testdata_sigs[:3]
+
+    runtmp.sourmash("index", "gcf_all", *testdata_sigs, "-k", "21")
+
+    def run(*extra):
+        runtmp.sourmash(
+            "multigather",
+            "--query",
+            *queries,
+            "--db",
+            "gcf_all.sbt.zip",
+            "-k",
+            "21",
+            "--threshold-bp=0",
+            *extra,
+        )
+        print(runtmp.last_result.out)
+        print(runtmp.last_result.err)
+
+        outputs = {}
+        for q in queries:
+            base = os.path.basename(q)
+            with open(runtmp.output(base + ".csv")) as fp:
+                outputs[base] = fp.read()
+            assert os.path.exists(runtmp.output(base + ".matches.sig"))
+            assert os.path.exists(runtmp.output(base + ".unassigned.sig"))
+        return runtmp.last_result.out, outputs
+
+    serial_out, serial_csvs = run()
+    parallel_out, parallel_csvs = run("-p", "3")
+
+    assert "found 12 matches total" in parallel_out
+    assert "conducted gather searches on 4 signatures" in runtmp.last_result.err
+    assert serial_out == parallel_out
+    assert serial_csvs == parallel_csvs
+    # no leftover temporary files
+    assert not [f for f in os.listdir(runtmp.location) if f.startswith(".tmp.")]
+
+
 def test_multigather_check_scaled_bounds_negative(runtmp):
     c = runtmp
     testdata_glob = utils.get_test_data("gather/GCF*.sig")
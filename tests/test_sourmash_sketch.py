@@ -469,6 +469,7 @@ def test_multiple_moltypes():
         ("dna,num=500", "dna,k=31,num=500"),
         ("scaled=1100,dna", "dna,k=31,scaled=1100"),
         ("dna,abund", "dna,k=31,scaled=1000,abund"),
+        ("dna,hll", "dna,k=31,scaled=1000,hll"),
     ],
 )
 def test_compute_parameters_to_param_str(input_param_str, expected_output):
@@ -1885,6 +1886,30 @@ def test_fromfile_dna_and_protein(runtmp):
     assert "** 2 total requested; output 2, skipped 0" in runtmp.last_result.err
 
 
+def test_fromfile_dna_and_protein_threads(runtmp):
+    # sketching input files on several threads gives the same signatures
+    test_inp = utils.get_test_data("sketch_fromfile")
+    shutil.copytree(test_inp, runtmp.output("sketch_fromfile"))
+
+    args = ["sketch", "fromfile", "sketch_fromfile/salmonella.csv"]
+    args += ["-p", "dna", "-p", "protein"]
+    runtmp.sourmash(*args, "-o", "serial.zip")
+    runtmp.sourmash(*args, "-o", "threads.zip", "-t", "2")
+
+    print(runtmp.last_result.out)
+    print(runtmp.last_result.err)
+
+    assert "** 2 total requested; output 2, skipped 0" in runtmp.last_result.err
+
+    serial = sourmash.load_file_as_index(runtmp.output("serial.zip"))
+    threads = sourmash.load_file_as_index(runtmp.output("threads.zip"))
+    serial_md5s = [ss.md5sum() for ss in serial.signatures()]
+    threads_md5s = [ss.md5sum() for ss in threads.signatures()]
+
+    assert len(threads_md5s) == 2
+    assert serial_md5s == threads_md5s
+
+
 def test_fromfile_dna_and_protein_and_hp_and_dayhoff(runtmp):
     # does it run and produce DNA _and_ protein signatures?
     test_inp = utils.get_test_data("sketch_fromfile")
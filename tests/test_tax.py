@@ -5058,6 +5058,33 @@ def test_tax_prepare_2_csv_to_sql_empty_ranks(runtmp, keep_identifiers, keep_ver
     assert set(db1) == set(db2)
 
 
+def test_tax_prepare_2_db_to_bin(runtmp):
+    # SQL -> binary lineage db; same assignments?
+    tax = utils.get_test_data("tax/test.taxonomy.db")
+    taxout = runtmp.output("out.lindb")
+
+    runtmp.run_sourmash("tax", "prepare", "-t", tax, "-o", taxout, "-F", "bin")
+    assert os.path.exists(taxout)
+
+    db1 = tax_utils.MultiLineageDB.load([tax])
+    db2 = tax_utils.MultiLineageDB.load([taxout])
+    assert isinstance(db2.lineage_dbs[0], tax_utils.LineageDB_Binary)
+
+    assert set(db1) == set(db2)
+    for ident, lineage in db1.items():
+        assert db2[ident] == lineage
+
+    # can be used for tax commands, too
+    g_csv = utils.get_test_data("tax/test1.gather.csv")
+    runtmp.run_sourmash(
+        "tax", "metagenome", "-g", g_csv, "--taxonomy-csv", taxout
+    )
+    assert (
+        "test1,phylum,0.116,d__Bacteria;p__Bacteroidota,md5,test1.sig,0.073,582000"
+        in runtmp.last_result.out
+    )
+
+
 def test_tax_prepare_3_db_to_csv(runtmp):
     # SQL -> CSV; same assignments
     taxcsv = utils.get_test_data("tax/test.taxonomy.csv")
@@ -37,6 +37,7 @@ from sourmash.tax.tax_utils import (
     LineageTree,
     LineageDB,
     LineageDB_Sqlite,
+    LineageDB_Binary,
     MultiLineageDB,
     filter_row,
     NCBI_RANKS,
@@ -988,12 +989,38 @@ def test_check_and_load_gather_csvs_with_empty_force(runtmp):
     gather_results = check_and_load_gather_csvs(csvs, tax_assign, force=True)
     assert len(gather_results) == 1
     q_res = gather_results[0]
-    assert len(q_res.raw_taxresults) == 4
+    assert q_res.n_taxresults == 4
     assert q_res.n_missed == 1
     assert "gA" in q_res.missed_idents
     assert q_res.n_skipped == 0
 
 
+def test_check_and_load_gather_csvs_shared_lineages(runtmp):
+    # lineages are interned once across all gather CSVs
+    g_csv = utils.get_test_data("tax/test1.gather.csv")
+    g_res2 = runtmp.output("test2.gather.csv")
+    g_results = [
+        x.replace("test1", "test2") + "\n"
+        for x in Path(g_csv).read_text().splitlines()
+    ]
+    with open(g_res2, "w") as fp:
+        fp.writelines(g_results)
+
+    taxonomy_csv = utils.get_test_data("tax/test.taxonomy.csv")
+    tax_assign = MultiLineageDB.load([taxonomy_csv])
+    q1, q2 = check_and_load_gather_csvs([g_csv, g_res2], tax_assign)
+    assert q1.query_name == "test1"
+    assert q2.query_name == "test2"
+    assert q1.lineages is q2.lineages
+    assert len(q1.lineages) == 4
+    assert list(q1.lineage_ids) == list(q2.lineage_ids)
+
+    q1.build_summarized_result()
+    q2.build_summarized_result()
+    assert q1.sum_uniq_weighted == q2.sum_uniq_weighted
+    assert q1.sum_uniq_bp == q2.sum_uniq_bp
+
+
 def test_check_and_load_gather_lineage_csvs_empty(runtmp):
     # try loading an empty annotated gather file
     g_res = runtmp.output("empty.gather-tax.csv")
@@ -1096,7 +1123,7 @@ def test_load_gather_results():
     assert len(gather_results) == 1
     for query_name, res in gather_results.items():
         assert query_name == "test1"
-        assert len(res.raw_taxresults) == 4
+        assert res.n_taxresults == 4
 
 
 def test_load_gather_results_gzipped(runtmp):
@@ -1116,7 +1143,7 @@ def test_load_gather_results_gzipped(runtmp):
     assert len(gather_results) == 1
     for query_name, res in gather_results.items():
         assert query_name == "test1"
-        assert len(res.raw_taxresults) == 4
+        assert res.n_taxresults == 4
 
 
 def test_load_gather_results_bad_header(runtmp):
@@ -1147,6 +1174,28 @@ def test_load_gather_results_bad_header(runtmp):
     )
 
 
+def test_load_gather_results_short_row(runtmp):
+    # a row with too few fields is reported as missing columns
+    taxonomy_csv = utils.get_test_data("tax/test.taxonomy.csv")
+    tax_assign = MultiLineageDB.load(
+        [taxonomy_csv], keep_full_identifiers=False, keep_identifier_versions=False
+    )
+    g_csv = utils.get_test_data("tax/test1.gather.csv")
+
+    bad_g_csv = runtmp.output("g.csv")
+    lines = Path(g_csv).read_text().splitlines()
+    lines[-1] = ",".join(lines[-1].split(",")[:3])
+    with open(bad_g_csv, "w") as fp:
+        fp.write("\n".join(lines) + "\n")
+
+    with pytest.raises(ValueError) as exc:
+        load_gather_results(bad_g_csv, tax_assignments=tax_assign)
+    assert (
+        f"'{bad_g_csv}' is missing columns needed for taxonomic summarization"
+        in str(exc.value)
+    )
+
+
 def test_load_gather_results_empty(runtmp):
     taxonomy_csv = utils.get_test_data("tax/test.taxonomy.csv")
     tax_assign = MultiLineageDB.load(
@@ -1787,6 +1836,94 @@ def test_lineage_db_sql_load(runtmp):
         LineageDB_Sqlite.load(runtmp.output("no-such-file"))
 
 
+def test_lineage_db_binary_load(runtmp):
+    # test LineageDB_Binary.create + load; same lineages as sqlite
+    taxonomy_db = utils.get_test_data("tax/test.taxonomy.db")
+    taxonomy_csv = utils.get_test_data("tax/test.taxonomy.csv")
+    bin_db = runtmp.output("test.lindb")
+
+    sql = LineageDB_Sqlite.load(taxonomy_db)
+    LineageDB_Binary.create(bin_db, sql.items())
+
+    db = LineageDB_Binary.load(bin_db)
+    assert bool(db)
+    assert len(db) == 6
+    assert db.available_ranks == sql.available_ranks
+    assert "strain" not in db.available_ranks
+    assert list(db) == sorted(sql)
+    for ident, lineage in sql.items():
+        assert db[ident] == lineage
+    with pytest.raises(KeyError):
+        db["foo"]
+
+    # batch lookup skips missing identifiers
+    idents = ["GCF_001881345", "foo", "GCF_003471795", "GCF_001881345"]
+    lineages = db.get_many(idents)
+    assert lineages == sql.get_many(idents)
+    assert set(lineages) == {"GCF_001881345", "GCF_003471795"}
+
+    # load any kind of CSV, or sqlite
+    with pytest.raises(ValueError):
+        LineageDB_Binary.load(taxonomy_csv)
+    with pytest.raises(ValueError):
+        LineageDB_Binary.load(taxonomy_db)
+
+    # load a directory
+    with pytest.raises(ValueError):
+        LineageDB_Binary.load(runtmp.output(""))
+
+    # file does not exist
+    with pytest.raises(ValueError):
+        LineageDB_Binary.load(runtmp.output("no-such-file"))
+
+
+def test_lineage_db_binary_empty(runtmp):
+    bin_db = runtmp.output("empty.lindb")
+    LineageDB_Binary.create(bin_db, [])
+
+    db = LineageDB_Binary.load(bin_db)
+    assert not db
+    assert len(db) == 0
+    assert list(db.items()) == []
+    assert db.get_many(["foo"]) == {}
+
+
+def test_lineage_db_binary_LIN(runtmp):
+    # ranks come from the lineages, so LIN taxonomies round-trip too
+    taxonomy_csv = utils.get_test_data("tax/test.LIN-taxonomy.csv")
+    bin_db = runtmp.output("lin.lindb")
+
+    tax_assign = MultiLineageDB.load([taxonomy_csv], lins=True)
+    LineageDB_Binary.create(bin_db, tax_assign.items())
+
+    db = LineageDB_Binary.load(bin_db)
+    assert len(db) == 6
+    assert db.available_ranks == {str(x) for x in range(0, 20)}
+    for ident, lineage in tax_assign.items():
+        assert db[ident] == lineage
+
+
+def test_lineage_db_binary_bad_version(runtmp):
+    # an unsupported version is a ValueError, which 'force' skips past
+    taxonomy_db = utils.get_test_data("tax/test.taxonomy.db")
+    bin_db = runtmp.output("test.lindb")
+    LineageDB_Binary.create(bin_db, LineageDB_Sqlite.load(taxonomy_db).items())
+
+    with open(bin_db, "r+b") as fp:
+        data = fp.read()
+        fp.seek(0)
+        fp.write(data.replace(b'"version": "1.0"', b'"version": "9.0"'))
+
+    with pytest.raises(ValueError, match="unsupported binary taxonomy database"):
+        LineageDB_Binary.load(bin_db)
+
+    with pytest.raises(ValueError):
+        MultiLineageDB.load([bin_db])
+
+    tax_assign = MultiLineageDB.load([bin_db], force=True)
+    assert len(tax_assign) == 0
+
+
 def test_LineagePair():
     lin = LineagePair(rank="rank1", name="name1")
     print(lin)
@@ -2592,7 +2729,7 @@ def test_QueryTaxResult():
     # check that a few thngs were set properly and/or are not yet set.
     assert q_res.query_name == "q1"
     assert q_res.query_info.query_bp == 100
-    assert len(q_res.raw_taxresults) == 1
+    assert q_res.n_taxresults == 1
     assert q_res.skipped_idents == set()
     assert q_res.missed_idents == set()
     assert q_res.summarized_lineage_results == {}
@@ -2653,7 +2790,7 @@ def test_QueryTaxResult_add_skipped_ident():
     q_res = QueryTaxResult(taxres.query_info)
     q_res.add_taxresult(taxres)
     assert len(q_res.skipped_idents) == 1
-    assert len(q_res.raw_taxresults) == 1
+    assert q_res.n_taxresults == 1
     assert q_res.missed_idents == set()
     assert q_res.summarized_lineage_results == {}
 
@@ -2668,7 +2805,7 @@ def test_QueryTaxResult_add_missed_ident():
     # add taxonomic info to taxres
     q_res.add_taxresult(taxres)
     assert len(q_res.missed_idents) == 1
-    assert len(q_res.raw_taxresults) == 1
+    assert q_res.n_taxresults == 1
     assert q_res.skipped_idents == set()
     assert q_res.summarized_lineage_results == {}
 
@@ -2694,7 +2831,7 @@ def test_QueryTaxResult_track_missed_and_skipped():
         print("skipped?: ", tr.skipped_ident)
         print("missed?: ", tr.missed_ident)
         q_res.add_taxresult(tr)
-    assert len(q_res.raw_taxresults) == 6
+    assert q_res.n_taxresults == 6
     print(q_res.n_skipped)
     print(q_res.n_missed)
     assert q_res.n_missed == 2
@@ -2722,7 +2859,7 @@ def test_QueryTaxResult_track_missed_and_skipped_using_fn():
     # should have 6 results for default query 'q1'
     print(gres.keys())
     q_res = next(iter(gres.values()))
-    assert len(q_res.raw_taxresults) == 6
+    assert q_res.n_taxresults == 6
     print(q_res.n_skipped)
     print(q_res.n_missed)
     assert q_res.n_missed == 2
@@ -2742,7 +2879,7 @@ def test_QueryTaxResult_summarize_up_ranks_1():
     q_res = next(iter(gres.values()))
     # now summarize up the ranks
     q_res.summarize_up_ranks()
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     # print(q_res.sum_uniq_weighted.values())
     # print(q_res.sum_uniq_weighted['superkingdom'])
     assert list(q_res.sum_uniq_weighted.keys()) == ["class", "phylum", "superkingdom"]
@@ -2791,7 +2928,7 @@ def test_QueryTaxResult_summarize_up_ranks_2():
     )
     # now summarize up the ranks
     q_res.summarize_up_ranks()
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     print(q_res.sum_uniq_weighted.values())
     print(q_res.sum_uniq_weighted["superkingdom"])
     assert q_res.sum_uniq_weighted["superkingdom"] == {
@@ -2822,6 +2959,39 @@ def test_QueryTaxResult_summarize_up_ranks_2():
     }
 
 
+def test_QueryTaxResult_summarize_up_ranks_shared_lineages():
+    "summarize up ranks: many rows sharing lineages sum in row order"
+    taxD = make_mini_taxonomy([("gA", "a;b;c"), ("gB", "a;b;d"), ("gC", "a;b;c")])
+    rows = [("gB", 0.1), ("gA", 0.2), ("gC", 0.3), ("gA", 0.15)]
+    gather_results = [
+        {
+            "name": name,
+            "f_unique_weighted": f,
+            "f_unique_to_query": f / 2,
+            "unique_intersect_bp": int(f * 100),
+        }
+        for name, f in rows
+    ]
+    q_res = make_QueryTaxResults(
+        gather_info=gather_results, taxD=taxD, single_query=True
+    )
+    q_res.summarize_up_ranks()
+
+    # first-seen lineage comes first; sums match row-by-row addition exactly.
+    assert list(q_res.sum_uniq_weighted["class"].items()) == [
+        (RankLineageInfo(lineage_str="a;b;d"), 0.1),
+        (RankLineageInfo(lineage_str="a;b;c"), 0.0 + 0.2 + 0.3 + 0.15),
+    ]
+    assert q_res.sum_uniq_weighted["superkingdom"] == {
+        RankLineageInfo(lineage_str="a"): 0.0 + 0.1 + 0.2 + 0.3 + 0.15
+    }
+    assert q_res.sum_uniq_bp["class"] == {
+        RankLineageInfo(lineage_str="a;b;d"): 10,
+        RankLineageInfo(lineage_str="a;b;c"): 65,
+    }
+    assert all(isinstance(v, int) for v in q_res.sum_uniq_bp["phylum"].values())
+
+
 def test_QueryTaxResult_summarize_up_ranks_missing_lineage():
     "basic functionality: summarize up ranks"
     taxD = make_mini_taxonomy([("gA", "a;b;c")])
@@ -2831,7 +3001,7 @@ def test_QueryTaxResult_summarize_up_ranks_missing_lineage():
     q_res = next(iter(gres.values()))
     # now summarize up the ranks
     q_res.summarize_up_ranks()
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     # print(q_res.sum_uniq_weighted.values())
     print(q_res.sum_uniq_weighted["superkingdom"])
     assert q_res.sum_uniq_weighted["superkingdom"] == {
@@ -2868,7 +3038,7 @@ def test_QueryTaxResult_summarize_up_ranks_skipped_lineage():
     q_res = next(iter(gres.values()))
     # now summarize up the ranks
     q_res.summarize_up_ranks()
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     assert list(q_res.sum_uniq_weighted.keys()) == ["class", "phylum", "superkingdom"]
     # print(q_res.sum_uniq_weighted.values())
     print(q_res.sum_uniq_weighted["superkingdom"])
@@ -2904,7 +3074,7 @@ def test_QueryTaxResult_summarize_up_ranks_perfect_match():
     )
     # now summarize up the ranks
     q_res.summarize_up_ranks()
-    assert len(q_res.raw_taxresults) == 1
+    assert q_res.n_taxresults == 1
     print(q_res.sum_uniq_weighted.values())
     print(q_res.sum_uniq_to_query["superkingdom"])
     assert list(q_res.sum_uniq_to_query["superkingdom"].values()) == [1.0]
@@ -2947,7 +3117,7 @@ def test_QueryTaxResult_summarize_up_ranks_already_summarized_force():
     assert list(q_res.sum_uniq_weighted.keys()) == ["class", "phylum", "superkingdom"]
 
     # check that all results are still good
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     assert q_res.sum_uniq_weighted["superkingdom"] == {
         RankLineageInfo(lineage_str="a"): approx(0.3)
     }
@@ -2989,7 +3159,7 @@ def test_QueryTaxResult_summarize_up_ranks_single_rank():
     )
     # now summarize up the ranks
     q_res.summarize_up_ranks(single_rank="phylum")
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     assert list(q_res.sum_uniq_weighted.keys()) == ["phylum"]
     print(q_res.sum_uniq_weighted.keys())
     print(q_res.sum_uniq_weighted.values())
@@ -3377,7 +3547,7 @@ def test_QueryTaxResult_build_summarized_result_over100percent():
         gather_info=gather_results, taxD=taxD, single_query=True
     )
     # now summarize up the ranks
-    assert len(q_res.raw_taxresults) == 2
+    assert q_res.n_taxresults == 2
     with pytest.raises(ValueError) as exc:
         q_res.build_summarized_result()
     print(str(exc))